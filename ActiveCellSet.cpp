@@ -0,0 +1,86 @@
+#include "ActiveCellSet.h"
+#include "Cell.h"
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+using namespace std;
+/** \class ActiveCellSet
+	\brief Array of Cells without duplicates.
+
+	Replaces the vector used for aliveCellArray. Besides the Cells it keeps one 'enqueued' bit for every Cell of the board, so checking if a Cell is already stored costs one bit test instead of searching the whole array.
+	Clearing resets only bits of stored Cells and keeps allocated memory, so the same set can be reused every generation.
+*/
+/** \brief Class default constructor.
+
+	Creates empty set, board has to be set with resize.
+*/
+ActiveCellSet::ActiveCellSet() {
+	this->width = 0;
+	this->height = 0;
+	this->scale = 1;
+}
+
+/** \brief Sets size of the board and removes all Cells.
+
+\param width - number of columns of the board
+\param height - number of rows of the board
+\param scale - size of Cell side
+*/
+void ActiveCellSet::resize(int width, int height, int scale) {
+	this->width = width;
+	this->height = height;
+	this->scale = scale;
+	cells.clear();
+	enqueued.assign(((size_t)width * height + 63) / 64, 0);
+}
+
+/** \brief Adds Cell if it's not stored yet.
+
+Equality is based only on position, like in Cell::operator==.
+\param cell - Cell to add
+\return true if Cell was added, false if it was already stored
+*/
+bool ActiveCellSet::insert(const Cell& cell) {
+	size_t index = (size_t)(cell.getPosY() / scale) * width + cell.getPosX() / scale;
+	uint64_t bit = (uint64_t)1 << (index % 64);
+	if (enqueued[index / 64] & bit) {
+		return false;
+	}
+	enqueued[index / 64] |= bit;
+	cells.push_back(cell);
+	return true;
+}
+
+/** \brief Checks if Cell is stored.
+
+\param cell - Cell to check
+\return true if Cell with the same position is stored
+*/
+bool ActiveCellSet::contains(const Cell& cell) {
+	size_t index = (size_t)(cell.getPosY() / scale) * width + cell.getPosX() / scale;
+	return (enqueued[index / 64] >> (index % 64)) & 1;
+}
+
+/** \brief Removes all Cells.
+
+Resets bits of stored Cells only, so it costs as much as the number of stored Cells and not the board size.
+*/
+void ActiveCellSet::clear() {
+	for (unsigned int i = 0; i < cells.size(); i++) {
+		size_t index = (size_t)(cells[i].getPosY() / scale) * width + cells[i].getPosX() / scale;
+		enqueued[index / 64] = 0;
+	}
+	cells.clear();
+}
+
+/** \brief Swaps contents of two sets.
+
+\param other - set to swap with
+*/
+void ActiveCellSet::swap(ActiveCellSet& other) {
+	cells.swap(other.cells);
+	enqueued.swap(other.enqueued);
+	std::swap(width, other.width);
+	std::swap(height, other.height);
+	std::swap(scale, other.scale);
+}
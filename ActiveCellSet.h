@@ -0,0 +1,32 @@
+#pragma once
+#include "Cell.h"
+#include <stdint.h>
+#include <vector>
+using namespace std;
+
+class ActiveCellSet {
+private:
+	vector<Cell> cells;
+	vector<uint64_t> enqueued; /**< One bit per board cell, set if the cell is stored in cells. */
+	int width, height, scale;
+
+public:
+	ActiveCellSet();
+	void resize(int, int, int);
+	bool insert(const Cell&);
+	bool contains(const Cell&);
+	void clear();
+	void swap(ActiveCellSet&);
+	/** \brief Returns number of stored Cells.
+	*/
+	unsigned int size() {
+		return cells.size();
+	}
+	/** \brief Returns stored Cell.
+
+	\param index - index of the Cell, from 0 to size() - 1
+	*/
+	Cell& operator[](unsigned int index) {
+		return cells[index];
+	}
+};
@@ -1,14 +1,17 @@
 #pragma once
 #include <iostream>
 #include <vector>
-#include <SDL.h>
+#include "LifeRule.h"
 using namespace std;
 
+class ActiveCellSet;
+
 class Cell {
 private:
 	bool isAlive; /**< bool Value isAlive stores information about life state of a Cell object. */
 	int posX, posY;
 	int neighborCounter;
+	unsigned neighborhood; /**< Alive Cells of the 3x3 neighborhood, see LifeRule::nextStateOf. */
 
 public:
 	Cell();
@@ -21,30 +24,21 @@ public:
 
 	\return posX - vertical position relative to the screen
 	*/
-	int getPosX() {
+	int getPosX() const {
 		return posX;
 	}
 	/** \brief Returns posX of a Cell.
 
 	\return posY - horizontal position relative to the screen
 	*/
-	int getPosY() {
+	int getPosY() const {
 		return posY;
 	}
-	void addToArray(vector< vector<Cell> >*, vector<Cell>*, int);
-	void addNeighborsToArray(vector< vector<Cell> >*, vector<Cell>*, int);
-	void createAliveCell(SDL_Window**, SDL_Renderer**, vector< vector<Cell> >*, vector<Cell>*, int);
-	void killCell(SDL_Window**, SDL_Renderer**, int);
-	void countAliveNeighbors(vector< vector<Cell> >*, vector<Cell>*, vector<Cell>*, int, int);
-	void checkLifeStatus1(vector< vector<Cell> >*, vector<Cell>*, vector<Cell>*, int);
-	void checkLifeStatus2(vector< vector<Cell> >*, vector<Cell>*, vector<Cell>*, int);
-	void checkLifeStatus3(vector< vector<Cell> >*, vector<Cell>*, vector<Cell>*, int);
-	void checkLifeStatus4(vector< vector<Cell> >*, vector<Cell>*, vector<Cell>*, int);
-	void checkLifeStatus5(vector< vector<Cell> >*, vector<Cell>*, vector<Cell>*, int);
-	void checkLifeStatus6(vector< vector<Cell> >*, vector<Cell>*, vector<Cell>*, int);
-	void checkLifeStatus7(vector< vector<Cell> >*, vector<Cell>*, vector<Cell>*, int);
-	void checkLifeStatus8(vector< vector<Cell> >*, vector<Cell>*, vector<Cell>*, int);
-	void createRectangle(SDL_Window**, SDL_Renderer**, int);
+	void addToArray(ActiveCellSet*);
+	void addNeighborsToArray(vector< vector<Cell> >*, ActiveCellSet*, int);
+	void createAliveCell(ActiveCellSet*);
+	void countAliveNeighbors(vector< vector<Cell> >*, ActiveCellSet*, int, const LifeRule&);
+	void checkLifeStatus(ActiveCellSet*, const LifeRule&);
 	/** \brief Prints Cell informations to the console.
 
 	Method used for debugging
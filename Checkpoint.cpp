@@ -0,0 +1,326 @@
+#include "Checkpoint.h"
+#include "DenseEngine.h"
+#include "LifeEngine.h"
+#include "LifeKernel.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+using namespace std;
+/** \file Checkpoint.cpp
+	\brief Binary checkpoints of a board.
+
+	File is a CheckpointHeader followed by the bit-packed rows of the board(the row layout of DenseEngine without its halo). The header keeps the rule, generation, size and topology, the payload is protected by a checksum. Non-totalistic rules don't fit the masks of the header, their 512-bit table of next states follows the header and is counted in headerSize, so older checkpoints are read the same way. The checksum covers the table before the payload, a checkpoint without a table has the checksum of its payload alone.
+	Checkpoints are loaded through a memory mapping, the mapped rows are checked and copied straight into the engine without reading the file into a buffer. They are written to a temporary file which replaces the old checkpoint only when it's complete, so a crash while writing keeps the previous one.
+*/
+
+static const char CHECKPOINT_MAGIC[8] = { 'C', 'O', 'N', 'W', 'A', 'Y', 'C', 'P' };
+static const uint32_t CHECKPOINT_VERSION = 1;
+static_assert(sizeof(CheckpointHeader) == 64, "checkpoint header has to be 64 bytes");
+
+/** \brief Returns 64-bit FNV-1a hash of words.
+
+\param words - words to hash
+\param count - number of words
+\param hash - hash of the words before them, to continue a checksum
+*/
+static uint64_t checksumWords(const uint64_t* words, size_t count, uint64_t hash = 0xCBF29CE484222325ULL) {
+	for (size_t i = 0; i < count; i++) {
+		hash = (hash ^ words[i]) * 0x100000001B3ULL;
+	}
+	return hash;
+}
+
+/** \brief Read only memory mapping of a whole file. */
+struct MappedFile {
+	const unsigned char* data;
+	size_t size;
+#ifdef _WIN32
+	HANDLE file, mapping;
+#endif
+
+	MappedFile(const string& path) : data(NULL), size(0) {
+#ifdef _WIN32
+		mapping = NULL;
+		file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE) return;
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) return;
+		mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping == NULL) return;
+		data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (data != NULL) size = (size_t)fileSize.QuadPart;
+#else
+		int file = open(path.c_str(), O_RDONLY);
+		if (file < 0) return;
+		struct stat status;
+		if (fstat(file, &status) == 0 && status.st_size > 0) {
+			void* mapped = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+			if (mapped != MAP_FAILED) {
+				data = (const unsigned char*)mapped;
+				size = (size_t)status.st_size;
+#ifdef MADV_SEQUENTIAL
+				madvise(mapped, size, MADV_SEQUENTIAL);
+#endif
+			}
+		}
+		close(file);
+#endif
+	}
+
+	~MappedFile() {
+#ifdef _WIN32
+		if (data != NULL) UnmapViewOfFile(data);
+		if (mapping != NULL) CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+		if (data != NULL) munmap((void*)data, size);
+#endif
+	}
+};
+
+/** \brief Checks header of a mapped checkpoint.
+
+\return true if magic, version and sizes are right
+*/
+static bool isValidHeader(const MappedFile& file) {
+	if (file.data == NULL || file.size < sizeof(CheckpointHeader)) {
+		return false;
+	}
+	const CheckpointHeader* header = (const CheckpointHeader*)file.data;
+	return memcmp(header->magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) == 0 && header->version == CHECKPOINT_VERSION
+		&& header->headerSize >= sizeof(CheckpointHeader) && header->width >= 0 && header->height >= 0
+		&& header->wordsPerRow == (uint32_t)((header->width + 63) / 64)
+		&& header->payloadSize == (uint64_t)header->height * header->wordsPerRow * sizeof(uint64_t)
+		&& file.size >= header->headerSize + header->payloadSize;
+}
+
+/** \brief Checks if a file is a checkpoint.
+
+Only the header is checked, not the checksum.
+\param path - path to the file
+*/
+bool isCheckpoint(const string& path) {
+	MappedFile file(path);
+	return isValidHeader(file);
+}
+
+/** \brief Copies board of an engine into a snapshot.
+
+Rows of DenseEngine are copied word by word, other engines are converted cell by cell.
+\param engine - engine with the board
+\param snapshot - header and rows of the board
+*/
+void captureCheckpoint(LifeEngine* engine, CheckpointSnapshot* snapshot) {
+	CheckpointHeader& header = snapshot->header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+	header.version = CHECKPOINT_VERSION;
+	header.headerSize = sizeof(CheckpointHeader);
+	header.birth = engine->getRule().getBirth();
+	header.survival = engine->getRule().getSurvival();
+	snapshot->ruleTable.clear();
+	if (!engine->getRule().getIsTotalistic()) {
+		const uint64_t* neighborhoods = engine->getRule().getNeighborhoods();
+		snapshot->ruleTable.assign(neighborhoods, neighborhoods + 8);
+		header.headerSize += sizeof(uint64_t) * 8;
+	}
+	header.width = engine->getWidth();
+	header.height = engine->getHeight();
+	header.generation = engine->getGeneration();
+	header.topology = engine->getTopology();
+	header.wordsPerRow = (uint32_t)((header.width + 63) / 64);
+	size_t wordCount = (size_t)header.height * header.wordsPerRow;
+	header.payloadSize = wordCount * sizeof(uint64_t);
+	snapshot->words.assign(wordCount, 0);
+	DenseEngine* dense = dynamic_cast<DenseEngine*>(engine);
+	if (dense != NULL) {
+		for (int y = 0; y < header.height; y++) {
+			const uint64_t* row = dense->getRow(y);
+			copy(row, row + header.wordsPerRow, &snapshot->words[(size_t)y * header.wordsPerRow]);
+		}
+	}
+	else {
+		engine->forEachAlive([&](int x, int y) {
+			snapshot->words[(size_t)y * header.wordsPerRow + x / 64] |= (uint64_t)1 << (x % 64);
+		});
+	}
+	header.checksum = checksumWords(snapshot->words.data(), wordCount, checksumWords(snapshot->ruleTable.data(), snapshot->ruleTable.size()));
+}
+
+/** \brief Writes a snapshot to a checkpoint file.
+
+Snapshot is written to path + ".tmp" which is renamed to path after it's complete.
+\param path - path to the checkpoint
+\param snapshot - header and rows of the board
+\return true if the checkpoint was written
+*/
+bool writeCheckpoint(const string& path, const CheckpointSnapshot& snapshot) {
+	string temporaryPath = path + ".tmp";
+	FILE* file = fopen(temporaryPath.c_str(), "wb");
+	if (file == NULL) {
+		return false;
+	}
+	bool isWritten = fwrite(&snapshot.header, sizeof(CheckpointHeader), 1, file) == 1;
+	if (!snapshot.ruleTable.empty()) {
+		isWritten = isWritten && fwrite(snapshot.ruleTable.data(), sizeof(uint64_t), snapshot.ruleTable.size(), file) == snapshot.ruleTable.size();
+	}
+	if (!snapshot.words.empty()) {
+		isWritten = isWritten && fwrite(snapshot.words.data(), sizeof(uint64_t), snapshot.words.size(), file) == snapshot.words.size();
+	}
+	isWritten = fclose(file) == 0 && isWritten;
+#ifdef _WIN32
+	if (isWritten) isWritten = MoveFileExA(temporaryPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	if (isWritten) isWritten = rename(temporaryPath.c_str(), path.c_str()) == 0;
+#endif
+	if (!isWritten) remove(temporaryPath.c_str());
+	return isWritten;
+}
+
+/** \brief Writes board of an engine to a checkpoint file on the calling thread.
+
+\param path - path to the checkpoint
+\param engine - engine with the board
+\return true if the checkpoint was written
+*/
+bool saveCheckpoint(const string& path, LifeEngine* engine) {
+	CheckpointSnapshot snapshot;
+	captureCheckpoint(engine, &snapshot);
+	return writeCheckpoint(path, snapshot);
+}
+
+/** \brief Restores board of an engine from a checkpoint file.
+
+Engine is resized and gets the rule, topology, generation and cells of the checkpoint. File is mapped into memory, rows are checked and copied from the mapping.
+\param path - path to the checkpoint
+\param engine - engine that gets the board
+\return false if the file can't be opened, is not a checkpoint, its checksum is wrong or the engine doesn't support its topology or rule, the board is not loaded then
+*/
+bool loadCheckpoint(const string& path, LifeEngine* engine) {
+	MappedFile file(path);
+	if (!isValidHeader(file)) {
+		return false;
+	}
+	const CheckpointHeader* header = (const CheckpointHeader*)file.data;
+	const uint64_t* words = (const uint64_t*)(file.data + header->headerSize);
+	size_t wordCount = (size_t)header->height * header->wordsPerRow;
+	const uint64_t* ruleTable = (const uint64_t*)(file.data + sizeof(CheckpointHeader));
+	bool hasRuleTable = header->headerSize >= sizeof(CheckpointHeader) + sizeof(uint64_t) * 8;
+	if (checksumWords(words, wordCount, checksumWords(ruleTable, hasRuleTable ? 8 : 0)) != header->checksum) {
+		return false;
+	}
+	if (!engine->setTopology((Topology)header->topology)) {
+		return false;
+	}
+	if (!engine->setRule(hasRuleTable ? LifeRule(ruleTable) : LifeRule(header->birth, header->survival))) {
+		return false;
+	}
+	engine->resize(header->width, header->height);
+	DenseEngine* dense = dynamic_cast<DenseEngine*>(engine);
+	for (int y = 0; y < header->height; y++) {
+		const uint64_t* row = &words[(size_t)y * header->wordsPerRow];
+		if (dense != NULL) {
+			dense->setRow(y, row);
+			continue;
+		}
+		for (uint32_t i = 0; i < header->wordsPerRow; i++) {
+			for (uint64_t word = row[i]; word; word &= word - 1) {
+				engine->setCell(i * 64 + lowestBit(word), y, true);
+			}
+		}
+	}
+	engine->setGeneration(header->generation);
+	return true;
+}
+
+/** \class CheckpointWriter
+	\brief Writes checkpoints on a background thread.
+
+	request copies the board(one copy of the packed rows) and returns, the file is written by the worker thread while the game goes on. If a new request comes while a checkpoint is being written, only the latest board waits for the worker.
+*/
+/** \brief Class constructor, starts the worker thread.
+
+\param path - path to the checkpoint
+*/
+CheckpointWriter::CheckpointWriter(const string& path) {
+	this->path = path;
+	this->hasPending = false;
+	this->isWriting = false;
+	this->isStopping = false;
+	this->written = 0;
+	this->worker = thread(&CheckpointWriter::workerLoop, this);
+}
+
+/** \brief Class destructor.
+
+Writes the waiting checkpoint and stops the worker thread.
+*/
+CheckpointWriter::~CheckpointWriter() {
+	{
+		lock_guard<mutex> guard(lock);
+		isStopping = true;
+	}
+	wake.notify_all();
+	worker.join();
+}
+
+/** \brief Main function of the worker thread.
+
+Waits for a snapshot and writes it, the snapshot is moved out of pending so a new request can be made during the write.
+*/
+void CheckpointWriter::workerLoop() {
+	CheckpointSnapshot snapshot;
+	unique_lock<mutex> guard(lock);
+	while (true) {
+		wake.wait(guard, [&] { return isStopping || hasPending; });
+		if (!hasPending) return;
+		snapshot.header = pending.header;
+		snapshot.ruleTable.swap(pending.ruleTable);
+		snapshot.words.swap(pending.words);
+		hasPending = false;
+		isWriting = true;
+		guard.unlock();
+		bool isWritten = writeCheckpoint(path, snapshot);
+		guard.lock();
+		if (isWritten) written++;
+		isWriting = false;
+		idle.notify_all();
+	}
+}
+
+/** \brief Copies board of an engine and lets the worker write it.
+
+\param engine - engine with the board
+*/
+void CheckpointWriter::request(LifeEngine* engine) {
+	CheckpointSnapshot snapshot;
+	captureCheckpoint(engine, &snapshot);
+	{
+		lock_guard<mutex> guard(lock);
+		pending.header = snapshot.header;
+		pending.ruleTable.swap(snapshot.ruleTable);
+		pending.words.swap(snapshot.words);
+		hasPending = true;
+	}
+	wake.notify_all();
+}
+
+/** \brief Waits until all requested checkpoints are written.
+*/
+void CheckpointWriter::flush() {
+	unique_lock<mutex> guard(lock);
+	idle.wait(guard, [&] { return !hasPending && !isWriting; });
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "LifeEngine.h"
+#include <stdint.h>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+/** \brief Header at the start of a checkpoint file, all numbers are little-endian. */
+struct CheckpointHeader {
+	char magic[8]; /**< "CONWAYCP". */
+	uint32_t version;
+	uint32_t headerSize; /**< Size of this header and of the rule table that follows it for non-totalistic rules, payload starts after them. */
+	uint32_t birth, survival; /**< Rule masks, see LifeRule::getBirth. */
+	int32_t width, height;
+	int64_t generation;
+	uint32_t topology;
+	uint32_t wordsPerRow;
+	uint64_t payloadSize; /**< Bytes of the payload, height * wordsPerRow words. */
+	uint64_t checksum; /**< FNV-1a of the rule table words, if there are any, and of the payload words. */
+};
+
+/** \brief Board copied from an engine, ready to be written. */
+struct CheckpointSnapshot {
+	CheckpointHeader header;
+	vector<uint64_t> ruleTable; /**< Next states of all neighborhoods of a non-totalistic rule(LifeRule::getNeighborhoods), empty for totalistic rules. */
+	vector<uint64_t> words; /**< Rows of the board, bit i of word j is the cell in column 64 * j + i. */
+};
+
+bool isCheckpoint(const string&);
+void captureCheckpoint(LifeEngine*, CheckpointSnapshot*);
+bool writeCheckpoint(const string&, const CheckpointSnapshot&);
+bool saveCheckpoint(const string&, LifeEngine*);
+bool loadCheckpoint(const string&, LifeEngine*);
+
+class CheckpointWriter {
+private:
+	string path;
+	CheckpointSnapshot pending; /**< Latest snapshot waiting to be written. */
+	bool hasPending;
+	bool isWriting;
+	bool isStopping;
+	long long written;
+	mutex lock;
+	condition_variable wake;
+	condition_variable idle;
+	thread worker;
+
+	void workerLoop();
+
+public:
+	CheckpointWriter(const string&);
+	~CheckpointWriter();
+	void request(LifeEngine*);
+	void flush();
+	/** \brief Returns number of checkpoints written successfully.
+	*/
+	long long getWrittenCount() {
+		lock_guard<mutex> guard(lock);
+		return written;
+	}
+};
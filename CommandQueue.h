@@ -0,0 +1,61 @@
+#pragma once
+#include <stddef.h>
+#include <atomic>
+#include <vector>
+using namespace std;
+
+/** \brief Lock-free bounded queue, one thread pushes commands and another one pops them.
+
+Commands are kept in a ring whose size is a power of two. The writer only moves tail and the reader only moves head, so neither thread ever waits for the other, a full queue refuses the command instead. Memory of the ring is allocated once by the constructor.
+*/
+template <class T>
+class CommandQueue {
+private:
+	vector<T> slots;
+	size_t mask; /**< Size of the ring minus one. */
+	atomic<size_t> head; /**< Number of commands popped, moved by the reader. */
+	atomic<size_t> tail; /**< Number of commands pushed, moved by the writer. */
+
+public:
+	/** \brief Class constructor.
+
+	\param capacity - most commands waiting in the queue, rounded up to a power of two
+	*/
+	explicit CommandQueue(size_t capacity) : head(0), tail(0) {
+		size_t size = 1;
+		while (size < capacity) size *= 2;
+		slots.resize(size);
+		mask = size - 1;
+	}
+	/** \brief Adds a command at the end of the queue, only the writer thread may call it.
+
+	\return false if the queue is full and the command was not added
+	*/
+	bool push(const T& command) {
+		size_t position = tail.load(memory_order_relaxed);
+		if (position - head.load(memory_order_acquire) > mask) {
+			return false;
+		}
+		slots[position & mask] = command;
+		tail.store(position + 1, memory_order_release);
+		return true;
+	}
+	/** \brief Takes the oldest command, only the reader thread may call it.
+
+	\return false if the queue is empty
+	*/
+	bool pop(T* command) {
+		size_t position = head.load(memory_order_relaxed);
+		if (position == tail.load(memory_order_acquire)) {
+			return false;
+		}
+		*command = slots[position & mask];
+		head.store(position + 1, memory_order_release);
+		return true;
+	}
+	/** \brief Returns true if no command is waiting, either thread may call it.
+	*/
+	bool isEmpty() {
+		return head.load(memory_order_acquire) == tail.load(memory_order_acquire);
+	}
+};
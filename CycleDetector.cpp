@@ -0,0 +1,63 @@
+#include "CycleDetector.h"
+#include <stdint.h>
+#include <vector>
+using namespace std;
+/** \class CycleDetector
+	\brief Finds the generation from which the board repeats.
+
+	Board hashes of consecutive generations(see DenseEngine::getHash) are kept in a ring. Every new hash is compared with the hashes of the last maxPeriod generations, the first match gives the period, 1 for still lifes and dead boards, and the first generation of the cycle. A match is confirmed by the check hash of the board(DenseEngine::getCheckHash), whose keys are independent of the hash, so different boards are reported as a cycle only if both 64-bit hashes collide. A check costs maxPeriod comparisons and doesn't look at the board at all.
+	Spaceships change position, so a board with a glider repeats only on a torus where the glider comes back, on other edges it's found after the glider dies or turns into a still life.
+*/
+/** \brief Class constructor.
+
+\param maxPeriod - longest period that is found, e.g. 60 for all common oscillators
+*/
+CycleDetector::CycleDetector(int maxPeriod) {
+	this->hashes.assign(maxPeriod < 1 ? 2 : maxPeriod + 1, 0);
+	this->checkHashes.assign(this->hashes.size(), 0);
+	this->reset();
+}
+
+/** \brief Forgets all hashes and the found cycle, used when the board is edited or seeded again.
+*/
+void CycleDetector::reset() {
+	count = 0;
+	next = 0;
+	lastGeneration = -1;
+	period = 0;
+	cycleStart = 0;
+	cycleHash = 0;
+}
+
+/** \brief Adds hash of the next generation and looks for a cycle.
+
+If a generation is skipped the ring starts again, because periods can only be measured between consecutive generations. After a cycle is found, further hashes are ignored until reset.
+\param hash - board hash, 0 for a dead board
+\param checkHash - check hash of the board
+\param generation - generation of the board
+\return true if the board repeats
+*/
+bool CycleDetector::observe(uint64_t hash, uint64_t checkHash, long long generation) {
+	if (period > 0) {
+		return true;
+	}
+	if (generation != lastGeneration + 1) {
+		count = 0;
+	}
+	lastGeneration = generation;
+	int size = (int)hashes.size();
+	for (int p = 1; p <= count; p++) {
+		int position = (next - p + size) % size;
+		if (hashes[position] == hash && checkHashes[position] == checkHash) {
+			period = p;
+			cycleStart = generation - p;
+			cycleHash = hash;
+			return true;
+		}
+	}
+	hashes[next] = hash;
+	checkHashes[next] = checkHash;
+	next = (next + 1) % size;
+	if (count < size - 1) count++;
+	return false;
+}
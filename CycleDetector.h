@@ -0,0 +1,46 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+using namespace std;
+
+class CycleDetector {
+private:
+	vector<uint64_t> hashes; /**< Ring of board hashes of the latest generations. */
+	vector<uint64_t> checkHashes; /**< Check hashes of the same generations. */
+	int count; /**< Number of hashes in the ring. */
+	int next; /**< Position of the next hash in the ring. */
+	long long lastGeneration;
+	long long period;
+	long long cycleStart;
+	uint64_t cycleHash;
+
+public:
+	CycleDetector(int);
+	void reset();
+	bool observe(uint64_t, uint64_t, long long);
+	/** \brief Returns true if the board repeats.
+	*/
+	bool hasCycle() {
+		return period > 0;
+	}
+	/** \brief Returns period of the cycle, 1 for a still life or a dead board, 0 if no cycle was found.
+	*/
+	long long getPeriod() {
+		return period;
+	}
+	/** \brief Returns first generation of the cycle.
+	*/
+	long long getCycleStart() {
+		return cycleStart;
+	}
+	/** \brief Returns true if the cycle is a dead board.
+	*/
+	bool isDead() {
+		return period == 1 && cycleHash == 0;
+	}
+	/** \brief Returns the longest period that can be found.
+	*/
+	int getMaxPeriod() {
+		return (int)hashes.size() - 1;
+	}
+};
@@ -0,0 +1,690 @@
+#include "DenseEngine.h"
+#include "GenerationStats.h"
+#include "SoupGenerator.h"
+#include "LifeKernel.h"
+#include "StepKernels.h"
+#include "ThreadPool.h"
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <vector>
+using namespace std;
+/** \class DenseEngine
+	\brief Engine that stores the board as bits and computes 64 cells at once.
+
+	Every row of the board is packed into 64-bit words, so a cell takes one bit instead of a 16 byte Cell object. Next state of a whole word is computed with bitwise adders (see LifeKernel.h), without branches and without looking at single cells.
+	Rows are split into bands which are computed in parallel by a ThreadPool, every band writes only its own rows, so the result does not depend on the number of threads.
+	Bands are computed by a step kernel(see StepKernels.h), by default the widest vector kernel supported by the CPU. All kernels give the same result.
+	Rows are stored with one halo word on both sides and the board has a halo row above and below, so every word can read its neighbors without bounds checks. Before a generation the halo is filled once according to the topology(empty for a dead border, copies of the opposite or the same edge for torus, Klein bottle and mirror), so the kernel has no special case for edge cells. With TOPOLOGY_FRAME, the default, the outermost ring of the board is its dead frame like in SparseEngine.
+*/
+/** \brief Returns key of a position of the board that the keys of its words are made from.
+
+Positions only have to differ, the keys of the words are mixed afterwards, so one multiply is enough.
+\param index - position of the word, row * wordsPerRow + column of the word
+*/
+static inline uint64_t positionKey(size_t index) {
+	return (uint64_t)index * 0x9E3779B97F4A7C15ULL;
+}
+
+/** \brief Returns Zobrist key of a word of the board with the given cells.
+
+Key is computed by the SplitMix64 finalizer(SoupGenerator::mix) from the cells and the key of the position instead of being read from a table, so it works for any board size without memory. The finalizer spreads every bit of the word over the whole key, a single multiply would carry changes of high bits only to a few high key bits. Dead word has key 0, so hash of a dead board is 0.
+\param position - key of the position of the word(positionKey)
+\param word - cells of the word
+*/
+static inline uint64_t wordHash(uint64_t position, uint64_t word) {
+	return SoupGenerator::mix(word ^ position) & (0 - (uint64_t)(word != 0));
+}
+
+/** \brief Returns key of a word for the check hash.
+
+Key is computed by the MurmurHash3 finalizer, a different mixer than the one of wordHash, so keys of both hashes are independent.
+\param position - key of the position of the word(positionKey)
+\param word - cells of the word
+*/
+static inline uint64_t wordCheckHash(uint64_t position, uint64_t word) {
+	uint64_t key = word ^ position;
+	key = (key ^ (key >> 33)) * 0xFF51AFD7ED558CCDULL;
+	key = (key ^ (key >> 33)) * 0xC4CEB9FE1A85EC53ULL;
+	return (key ^ (key >> 33)) & (0 - (uint64_t)(word != 0));
+}
+
+/** \brief Class default constructor.
+
+	Creates empty engine, board has to be set with resize.
+*/
+DenseEngine::DenseEngine() {
+	this->wordsPerRow = 0;
+	this->stride = 2;
+	this->lastWordMask = 0;
+	this->threadCount = 1;
+	this->kernel = bestKernel();
+	this->setPhaseTiming(false);
+	this->isHashing = false;
+	this->isHashValid = false;
+	this->hash = 0;
+	this->checkHash = 0;
+	this->cycleDetector = NULL;
+	this->isTopExternal = false;
+	this->isBottomExternal = false;
+}
+
+/** \brief Class constructor with board parameters.
+
+\param width - number of columns of the board
+\param height - number of rows of the board
+\param rule - rule of the game
+*/
+DenseEngine::DenseEngine(int width, int height, const LifeRule& rule) {
+	this->threadCount = 1;
+	this->kernel = bestKernel();
+	this->setPhaseTiming(false);
+	this->isHashing = false;
+	this->isHashValid = false;
+	this->hash = 0;
+	this->checkHash = 0;
+	this->cycleDetector = NULL;
+	this->isTopExternal = false;
+	this->isBottomExternal = false;
+	this->rule = rule;
+	this->resize(width, height);
+}
+
+/** \brief Creates a new dead board.
+
+\param width - number of columns of the board
+\param height - number of rows of the board
+*/
+void DenseEngine::resize(int width, int height) {
+	this->width = width;
+	this->height = height;
+	wordsPerRow = (width + 63) / 64;
+	stride = wordsPerRow + 2;
+	lastWordMask = (width % 64 == 0) ? ~(uint64_t)0 : ((uint64_t)1 << (width % 64)) - 1;
+	board.assign((size_t)(height + 2) * stride, 0);
+	boardBuffer.assign((size_t)(height + 2) * stride, 0);
+	generation = 0;
+	isHashValid = false;
+}
+
+/** \brief Kills every cell on the board.
+*/
+void DenseEngine::clear() {
+	fill(board.begin(), board.end(), 0);
+	generation = 0;
+	isHashValid = false;
+}
+
+/** \brief Sets state of a single cell.
+
+Cells outside the board or on its dead frame(TOPOLOGY_FRAME) are ignored.
+\param x - column of the cell
+\param y - row of the cell
+\param alive - true if cell is going to be alive, false if it's dead
+*/
+void DenseEngine::setCell(int x, int y, bool alive) {
+	int frame = topology == TOPOLOGY_FRAME ? 1 : 0;
+	int topFrame = isTopExternal ? 0 : frame;
+	int bottomFrame = isBottomExternal ? 0 : frame;
+	if (x < frame || y < topFrame || x > width - 1 - frame || y > height - 1 - bottomFrame) {
+		return;
+	}
+	uint64_t& word = board[(y + 1) * stride + 1 + x / 64];
+	uint64_t bit = (uint64_t)1 << (x % 64);
+	uint64_t oldWord = word;
+	if (alive) word |= bit;
+	else word &= ~bit;
+	if (isHashValid && word != oldWord) {
+		uint64_t position = positionKey((size_t)y * wordsPerRow + x / 64);
+		hash ^= wordHash(position, oldWord) ^ wordHash(position, word);
+		checkHash ^= wordCheckHash(position, oldWord) ^ wordCheckHash(position, word);
+	}
+}
+
+/** \brief Sets all cells of one row.
+
+Bits past the board width and cells on the dead frame(TOPOLOGY_FRAME) are cleared.
+\param y - row of the board
+\param words - getWordsPerRow() words, bit i of word j is the cell in column 64 * j + i
+*/
+void DenseEngine::setRow(int y, const uint64_t* words) {
+	if (y < 0 || y >= height || wordsPerRow == 0) {
+		return;
+	}
+	uint64_t* row = &board[(y + 1) * stride + 1];
+	copy(words, words + wordsPerRow, row);
+	row[wordsPerRow - 1] &= lastWordMask;
+	if (topology == TOPOLOGY_FRAME) {
+		if ((y == 0 && !isTopExternal) || (y == height - 1 && !isBottomExternal)) fill(row, row + wordsPerRow, 0);
+		row[0] &= ~(uint64_t)1;
+		row[(width - 1) / 64] &= ~((uint64_t)1 << ((width - 1) % 64));
+	}
+	isHashValid = false;
+}
+
+/** \brief Sets alive cells of a random soup in a rectangle of the board, other cells are not changed.
+
+Words of the soup don't depend on each other, so bands of rows are filled on all threads of the engine. The rectangle is clipped to the board and the dead frame is kept.
+\param generator - soup
+\param x0 - first column of the rectangle
+\param y0 - first row of the rectangle
+\param x1 - column after the rectangle
+\param y1 - row after the rectangle
+*/
+void DenseEngine::fillSoup(const SoupGenerator& generator, int x0, int y0, int x1, int y1) {
+	x0 = max(x0, 0);
+	y0 = max(y0, 0);
+	x1 = min(x1, width);
+	y1 = min(y1, height);
+	if (x0 >= x1 || y0 >= y1) {
+		return;
+	}
+	int firstWord = x0 / 64, lastWord = (x1 - 1) / 64;
+	uint64_t firstMask = ~(uint64_t)0 << (x0 % 64);
+	uint64_t lastMask = ~(uint64_t)0 >> (63 - (x1 - 1) % 64);
+	int rows = y1 - y0;
+	int bandCount = pool ? min(rows, threadCount * 4) : 1;
+	function<void(int)> fillBand = [&](int band) {
+		for (int y = y0 + rows * band / bandCount; y < y0 + rows * (band + 1) / bandCount; y++) {
+			uint64_t* row = &board[(y + 1) * stride + 1];
+			for (int i = firstWord; i <= lastWord; i++) {
+				uint64_t mask = (i == firstWord ? firstMask : ~(uint64_t)0) & (i == lastWord ? lastMask : ~(uint64_t)0);
+				row[i] |= generator.word(i, y) & mask;
+			}
+		}
+	};
+	if (pool) pool->parallelFor(bandCount, fillBand);
+	else fillBand(0);
+	if (topology == TOPOLOGY_FRAME) clearFrame(&board[0]);
+	isHashValid = false;
+}
+
+/** \brief Returns state of a single cell.
+
+\param x - column of the cell
+\param y - row of the cell
+\return true if cell is alive, false if it's dead or outside the board
+*/
+bool DenseEngine::getCell(int x, int y) {
+	if (x < 0 || y < 0 || x >= width || y >= height) {
+		return false;
+	}
+	return (board[(y + 1) * stride + 1 + x / 64] >> (x % 64)) & 1;
+}
+
+/** \brief Kills cells on the dead frame of the board.
+
+Also clears bits of the last word of every row that are past the board width. The first and the last row are not on the frame if their side has an external halo.
+\param words - buffer with the board
+*/
+void DenseEngine::clearFrame(uint64_t* words) {
+	if (width < 1 || height < 1) {
+		return;
+	}
+	uint64_t* first = &words[stride + 1];
+	uint64_t* last = &words[height * stride + 1];
+	if (!isTopExternal) fill(first, first + wordsPerRow, 0);
+	if (!isBottomExternal) fill(last, last + wordsPerRow, 0);
+	for (int y = 1; y <= height; y++) {
+		uint64_t* row = &words[y * stride + 1];
+		row[0] &= ~(uint64_t)1;
+		row[wordsPerRow - 1] &= lastWordMask;
+		row[(width - 1) / 64] &= ~((uint64_t)1 << ((width - 1) % 64));
+	}
+}
+
+/** \brief Clears halo rows and words of the board and bits past the board width.
+
+\param words - buffer with the board
+*/
+void DenseEngine::clearHalo(uint64_t* words) {
+	fill(words, words + stride, 0);
+	fill(&words[(height + 1) * stride], &words[(height + 2) * stride], 0);
+	for (int y = 1; y <= height; y++) {
+		uint64_t* row = &words[y * stride];
+		row[0] = 0;
+		row[wordsPerRow] &= lastWordMask;
+		row[wordsPerRow + 1] = 0;
+	}
+}
+
+/** \brief Writes a board row with columns in reverse order.
+
+\param source - first word of the row
+\param target - first word of the reversed row
+*/
+void DenseEngine::reverseRow(const uint64_t* source, uint64_t* target) {
+	fill(target, target + wordsPerRow, 0);
+	for (int i = 0; i < wordsPerRow; i++) {
+		uint64_t word = source[i];
+		while (word) {
+			int x = width - 1 - (i * 64 + lowestBit(word));
+			target[x / 64] |= (uint64_t)1 << (x % 64);
+			word &= word - 1;
+		}
+	}
+}
+
+/** \brief Fills the halo around the board according to the topology.
+
+Halo rows are filled first, then the halo columns of every row including the halo rows, so corners come from the diagonal neighbor. Halo of a dead border stays empty. Halo rows of external sides are left to setHaloRow.
+\param words - buffer with the board
+*/
+void DenseEngine::refreshHalo(uint64_t* words) {
+	if (topology == TOPOLOGY_FRAME || topology == TOPOLOGY_DEAD || width < 1 || height < 1) {
+		return;
+	}
+	uint64_t* top = &words[1];
+	uint64_t* bottom = &words[(height + 1) * stride + 1];
+	const uint64_t* firstRow = &words[stride + 1];
+	const uint64_t* lastRow = &words[height * stride + 1];
+	if (topology == TOPOLOGY_TORUS) {
+		if (!isTopExternal) copy(lastRow, lastRow + wordsPerRow, top);
+		if (!isBottomExternal) copy(firstRow, firstRow + wordsPerRow, bottom);
+	}
+	else if (topology == TOPOLOGY_KLEIN) {
+		if (!isTopExternal) reverseRow(lastRow, top);
+		if (!isBottomExternal) reverseRow(firstRow, bottom);
+	}
+	else {
+		if (!isTopExternal) copy(firstRow, firstRow + wordsPerRow, top);
+		if (!isBottomExternal) copy(lastRow, lastRow + wordsPerRow, bottom);
+	}
+	for (int y = isTopExternal ? 1 : 0; y <= (isBottomExternal ? height : height + 1); y++) {
+		refreshHaloColumns(&words[y * stride + 1]);
+	}
+}
+
+/** \brief Fills the halo words on both sides of one row according to the topology.
+
+\param row - first board word of the row
+*/
+void DenseEngine::refreshHaloColumns(uint64_t* row) {
+	if (topology == TOPOLOGY_FRAME || topology == TOPOLOGY_DEAD) {
+		return;
+	}
+	//cell west of column 0 is bit 63 of the halo word, cell east of the last column is the first bit past the width
+	int westColumn = topology == TOPOLOGY_MIRROR ? 0 : width - 1;
+	int eastColumn = topology == TOPOLOGY_MIRROR ? width - 1 : 0;
+	uint64_t west = (row[westColumn / 64] >> (westColumn % 64)) & 1;
+	uint64_t east = (row[eastColumn / 64] >> (eastColumn % 64)) & 1;
+	row[-1] = west << 63;
+	row[width / 64] |= east << (width % 64);
+}
+
+/** \brief Makes the board a band of rows of a bigger board, whose halo rows are given by setHaloRow instead of the topology.
+
+Used when the board is split between processes(DomainDecomposition.h), the rows above and below a band belong to its neighbors. An external side is not a board edge, so it has no dead frame row, the halo columns still follow the topology. The new board keeps its cells.
+\param isTopExternal - true if the halo row above the first row comes from setHaloRow
+\param isBottomExternal - true if the halo row below the last row comes from setHaloRow
+*/
+void DenseEngine::setExternalHalo(bool isTopExternal, bool isBottomExternal) {
+	this->isTopExternal = isTopExternal;
+	this->isBottomExternal = isBottomExternal;
+	isHashValid = false;
+}
+
+/** \brief Sets the halo row above or below the board for the next generation, used with setExternalHalo.
+
+Halo rows are cleared by every generation, so they have to be set again before the next one.
+\param isTop - true for the row above the first row, false for the row below the last row
+\param words - getWordsPerRow() words of the row, bit i of word j is the cell in column 64 * j + i
+\param isReversed - true to store the row with columns in reverse order, like across the glued edge of a Klein bottle
+*/
+void DenseEngine::setHaloRow(bool isTop, const uint64_t* words, bool isReversed) {
+	if (width < 1) {
+		return;
+	}
+	uint64_t* row = &board[(isTop ? 0 : height + 1) * stride + 1];
+	if (isReversed) reverseRow(words, row);
+	else copy(words, words + wordsPerRow, row);
+	row[wordsPerRow - 1] &= lastWordMask;
+	refreshHaloColumns(row);
+}
+
+/** \brief Sets topology of the board edges.
+
+Switching to TOPOLOGY_FRAME kills cells on the frame.
+\param topology - topology of the board edges
+\return true, all topologies are supported
+*/
+bool DenseEngine::setTopology(Topology topology) {
+	this->topology = topology;
+	if (topology == TOPOLOGY_FRAME) clearFrame(&board[0]);
+	isHashValid = false;
+	return true;
+}
+
+/** \brief Sets number of threads used by step.
+
+Threads are created once and kept until the number changes.
+\param threadCount - number of threads, 1 computes generations on the calling thread only
+*/
+void DenseEngine::setThreadCount(int threadCount) {
+	if (threadCount < 1) threadCount = 1;
+	if (threadCount == this->threadCount) return;
+	this->threadCount = threadCount;
+	pool.reset(threadCount > 1 ? new ThreadPool(threadCount) : NULL);
+}
+
+/** \brief Sets instruction set of the step kernel.
+
+\param kernel - instruction set, it has to be supported by the CPU
+\return true if kernel was set, false if the CPU does not support it
+*/
+bool DenseEngine::setKernel(KernelIsa kernel) {
+	if (!isKernelSupported(kernel)) {
+		return false;
+	}
+	this->kernel = kernel;
+	return true;
+}
+
+/** \brief Enables or disables timing of the step phases.
+
+Times are reset to zero. Timing reads the clock three times per generation, so it is off by default.
+\param isTimingPhases - true to collect times returned by getPhaseTimes
+*/
+void DenseEngine::setPhaseTiming(bool isTimingPhases) {
+	this->isTimingPhases = isTimingPhases;
+	this->phaseTimes.edgeSeconds = 0;
+	this->phaseTimes.kernelSeconds = 0;
+	this->phaseTimes.generations = 0;
+}
+
+/** \brief Returns change of the board hash between two boards.
+
+Chunks of 8 words(a cache line) without changes are skipped, so a quiet board costs one comparison per word and keys are computed only around cells that flipped. Bits past the board width are ignored, refreshHalo puts cells of the opposite edge there.
+\param oldWords - previous board with halo
+\param newWords - next board with halo
+\param firstRow - first row with halo, 1 for the first board row
+\param lastRow - row with halo after the last one
+\param checkChange - gets change of the check hash
+\return XOR of keys of the old and new words
+*/
+uint64_t DenseEngine::hashRows(const uint64_t* oldWords, const uint64_t* newWords, int firstRow, int lastRow, uint64_t* checkChange) {
+	const int chunk = 8;
+	int wholeWords = width % 64 == 0 ? wordsPerRow : wordsPerRow - 1;
+	uint64_t change = 0, check = 0;
+	for (int y = firstRow; y < lastRow; y++) {
+		const uint64_t* oldRow = &oldWords[y * stride + 1];
+		const uint64_t* newRow = &newWords[y * stride + 1];
+		size_t index = (size_t)(y - 1) * wordsPerRow;
+		for (int i = 0; i < wholeWords; i += chunk) {
+			int end = min(i + chunk, wholeWords);
+			uint64_t difference = 0;
+			for (int j = i; j < end; j++) difference |= oldRow[j] ^ newRow[j];
+			if (!difference) continue;
+			//keys of equal words cancel out, so words of a changed chunk are hashed without a branch
+			for (int j = i; j < end; j++) {
+				uint64_t position = positionKey(index + j);
+				change ^= wordHash(position, oldRow[j]) ^ wordHash(position, newRow[j]);
+				check ^= wordCheckHash(position, oldRow[j]) ^ wordCheckHash(position, newRow[j]);
+			}
+		}
+		if (wholeWords < wordsPerRow) {
+			uint64_t position = positionKey(index + wholeWords);
+			uint64_t oldWord = oldRow[wholeWords] & lastWordMask, newWord = newRow[wholeWords] & lastWordMask;
+			change ^= wordHash(position, oldWord) ^ wordHash(position, newWord);
+			check ^= wordCheckHash(position, oldWord) ^ wordCheckHash(position, newWord);
+		}
+	}
+	*checkChange = check;
+	return change;
+}
+
+/** \brief Collects population, births, deaths and bounding box of a band of rows.
+
+Used only if compiled with CONWAY_STATS.
+\param oldWords - previous board with halo
+\param newWords - next board with halo
+\param firstRow - first row with halo, 1 for the first board row
+\param lastRow - row with halo after the last one
+\param stats - statistics of the band
+*/
+void DenseEngine::collectStats(const uint64_t* oldWords, const uint64_t* newWords, int firstRow, int lastRow, GenerationStats* stats) {
+	resetStats(stats, generation);
+	long long population = 0, births = 0, deaths = 0;
+	for (int y = firstRow; y < lastRow; y++) {
+		const uint64_t* oldRow = &oldWords[y * stride + 1];
+		const uint64_t* newRow = &newWords[y * stride + 1];
+		uint64_t rowWords = 0;
+		for (int i = 0; i < wordsPerRow - 1; i++) {
+			uint64_t change = oldRow[i] ^ newRow[i];
+			births += popCount(change & newRow[i]);
+			deaths += popCount(change & oldRow[i]);
+			population += popCount(newRow[i]);
+			rowWords |= newRow[i];
+		}
+		uint64_t lastWord = newRow[wordsPerRow - 1];
+		uint64_t change = (oldRow[wordsPerRow - 1] & lastWordMask) ^ lastWord;
+		births += popCount(change & lastWord);
+		deaths += popCount(change & ~lastWord);
+		population += popCount(lastWord);
+		if (!(rowWords | lastWord)) continue;
+		int first = 0, last = wordsPerRow - 1;
+		while (!newRow[first]) first++;
+		while (!newRow[last]) last--;
+		stats->minX = min(stats->minX, first * 64 + lowestBit(newRow[first]));
+		stats->maxX = max(stats->maxX, last * 64 + highestBit(newRow[last]));
+		stats->minY = min(stats->minY, y - 1);
+		stats->maxY = y - 1;
+	}
+	stats->population = population;
+	stats->births = births;
+	stats->deaths = deaths;
+}
+
+/** \brief Enables or disables incremental hashing of the board.
+
+When enabled, step updates the hash from the words that changed in every generation. Hashing costs one comparison of the old and new board per generation, so it's off by default.
+\param isHashing - true to keep the hash up to date during step
+*/
+void DenseEngine::setHashing(bool isHashing) {
+	this->isHashing = isHashing;
+}
+
+/** \brief Returns Zobrist hash of the board.
+
+Hash is XOR of the keys of all words that have alive cells, equal boards have equal hashes and a dead board has hash 0. If the board was changed by anything else than step or setCell, the hash and the check hash are computed again from all words.
+*/
+uint64_t DenseEngine::getHash() {
+	if (!isHashValid) {
+		hash = 0;
+		checkHash = 0;
+		for (int y = 0; y < height; y++) {
+			const uint64_t* row = &board[(y + 1) * stride + 1];
+			for (int i = 0; i < wordsPerRow; i++) {
+				uint64_t position = positionKey((size_t)y * wordsPerRow + i);
+				hash ^= wordHash(position, row[i]);
+				checkHash ^= wordCheckHash(position, row[i]);
+			}
+		}
+		isHashValid = true;
+	}
+	return hash;
+}
+
+/** \brief Returns second hash of the board with keys independent of getHash.
+
+Boards with equal hashes are taken as equal only if their check hashes are equal too(see CycleDetector), so a collision needs two independent 64-bit keys to collide.
+*/
+uint64_t DenseEngine::getCheckHash() {
+	getHash();
+	return checkHash;
+}
+
+/** \brief Sets detector that gets the board hash after every generation.
+
+Hashing is enabled by a detector and stays enabled when the detector is removed. Detector has to be reset by the caller when the board is seeded or edited.
+\param cycleDetector - detector of repeating boards, NULL to remove it
+*/
+void DenseEngine::setCycleDetector(CycleDetector* cycleDetector) {
+	this->cycleDetector = cycleDetector;
+	if (cycleDetector != NULL) setHashing(true);
+}
+
+/** \brief Computes next generations.
+
+Board is split into bands of rows, a few per thread so that threads can steal work from each other. parallelFor waits for all bands, so a generation is complete before the next one starts.
+Game variants have kernels specialized at compile time, any other rule uses MaskRule, non-totalistic rules add IsotropicRule for their partial counts.
+\param generations - number of generations to compute
+*/
+void DenseEngine::step(int generations) {
+	MaskRule maskRule(rule.getBirth(), rule.getSurvival());
+	IsotropicRule isotropicRule(rule.getNeighborhoods(), rule.getPartialBirth(), rule.getPartialSurvival());
+	StepRowsKernel stepRows = getStepKernel(kernel);
+	StepRowsArgs args;
+	args.stride = stride;
+	args.wordsPerRow = wordsPerRow;
+	args.preset = rule.presetIndex();
+	args.maskRule = &maskRule;
+	args.isotropicRule = rule.getIsTotalistic() ? NULL : &isotropicRule;
+	int bandCount = threadCount == 1 ? 1 : threadCount * 4;
+	if (bandCount > height) bandCount = height > 0 ? height : 1;
+	function<void(int)> stepBand = [&](int band) {
+		StepRowsArgs bandArgs = args;
+		bandArgs.firstRow = 1 + height * band / bandCount;
+		bandArgs.lastRow = 1 + height * (band + 1) / bandCount;
+		stepRows(bandArgs);
+	};
+	vector<uint64_t> hashChanges(bandCount), checkChanges(bandCount);
+	function<void(int)> hashBand = [&](int band) {
+		hashChanges[band] = hashRows(&boardBuffer[0], &board[0], 1 + height * band / bandCount, 1 + height * (band + 1) / bandCount, &checkChanges[band]);
+	};
+	if (isHashing && !isHashValid) {
+		getHash();
+	}
+	bool isTiming = isTimingPhases;
+#ifdef CONWAY_STATS
+	vector<GenerationStats> bandStats(bandCount);
+	function<void(int)> statsBand = [&](int band) {
+		collectStats(&boardBuffer[0], &board[0], 1 + height * band / bandCount, 1 + height * (band + 1) / bandCount, &bandStats[band]);
+	};
+	isTiming = isTiming || statsWriter != NULL;
+#endif
+	chrono::steady_clock::time_point haloTime, kernelTime, edgeTime, swapTime;
+	for (int g = 0; g < generations; g++) {
+		if (isTiming) haloTime = chrono::steady_clock::now();
+		refreshHalo(&board[0]);
+		args.board = &board[0];
+		args.boardBuffer = &boardBuffer[0];
+		if (isTiming) kernelTime = chrono::steady_clock::now();
+		if (pool) pool->parallelFor(bandCount, stepBand);
+		else stepBand(0);
+		if (isTiming) edgeTime = chrono::steady_clock::now();
+		clearHalo(&boardBuffer[0]);
+		if (topology == TOPOLOGY_FRAME) clearFrame(&boardBuffer[0]);
+		board.swap(boardBuffer);
+		generation++;
+		if (isTiming) swapTime = chrono::steady_clock::now();
+		if (isHashing) {
+			if (pool) pool->parallelFor(bandCount, hashBand);
+			else hashBand(0);
+			for (int band = 0; band < bandCount; band++) {
+				hash ^= hashChanges[band];
+				checkHash ^= checkChanges[band];
+			}
+			if (cycleDetector != NULL) cycleDetector->observe(hash, checkHash, generation);
+		}
+		else {
+			isHashValid = false;
+		}
+		if (isTimingPhases) {
+			phaseTimes.edgeSeconds += chrono::duration<double>(kernelTime - haloTime + (swapTime - edgeTime)).count();
+			phaseTimes.kernelSeconds += chrono::duration<double>(edgeTime - kernelTime).count();
+			phaseTimes.generations++;
+		}
+#ifdef CONWAY_STATS
+		if (statsWriter != NULL) {
+			GenerationStats stats;
+			resetStats(&stats, generation);
+			if (pool) pool->parallelFor(bandCount, statsBand);
+			else statsBand(0);
+			for (int band = 0; band < bandCount; band++) mergeStats(&stats, bandStats[band]);
+			stats.activeCells = (long long)width * height;
+			stats.phaseSeconds[PHASE_NEIGHBORS] = chrono::duration<double>(edgeTime - kernelTime).count();
+			stats.phaseSeconds[PHASE_SWAP] = chrono::duration<double>(kernelTime - haloTime + (swapTime - edgeTime)).count();
+			statsWriter->write(stats);
+		}
+#endif
+	}
+}
+
+/** \brief Computes one generation of a band with external halo rows, while the halo rows are received.
+
+Rows that don't touch the halo rows are computed first, then receiveHalo has to set the external halo rows with setHaloRow, e.g. by waiting for the rows of the neighbors, and the first and the last row are computed last. Neighbors send their rows before the generation, so the exchange overlaps with most of the work. The result is the same as of step. Hash, statistics and phase times are not collected.
+\param receiveHalo - called once, on the calling thread, after the inner rows
+*/
+void DenseEngine::stepWithHalo(const function<void()>& receiveHalo) {
+	MaskRule maskRule(rule.getBirth(), rule.getSurvival());
+	IsotropicRule isotropicRule(rule.getNeighborhoods(), rule.getPartialBirth(), rule.getPartialSurvival());
+	StepRowsKernel stepRows = getStepKernel(kernel);
+	StepRowsArgs args;
+	args.stride = stride;
+	args.wordsPerRow = wordsPerRow;
+	args.preset = rule.presetIndex();
+	args.maskRule = &maskRule;
+	args.isotropicRule = rule.getIsTotalistic() ? NULL : &isotropicRule;
+	args.board = &board[0];
+	args.boardBuffer = &boardBuffer[0];
+	refreshHalo(&board[0]);
+	//rows with halo index 2 to height - 1 read only rows of the board
+	int innerRows = max(height - 2, 0);
+	int bandCount = threadCount == 1 ? 1 : threadCount * 4;
+	if (bandCount > innerRows) bandCount = innerRows > 0 ? innerRows : 1;
+	function<void(int)> stepBand = [&](int band) {
+		StepRowsArgs bandArgs = args;
+		bandArgs.firstRow = 2 + innerRows * band / bandCount;
+		bandArgs.lastRow = 2 + innerRows * (band + 1) / bandCount;
+		stepRows(bandArgs);
+	};
+	if (pool && innerRows > 1) pool->parallelFor(bandCount, stepBand);
+	else stepBand(0);
+	receiveHalo();
+	if (height > 0) {
+		StepRowsArgs edgeArgs = args;
+		edgeArgs.firstRow = 1;
+		edgeArgs.lastRow = 2;
+		stepRows(edgeArgs);
+		edgeArgs.firstRow = height;
+		edgeArgs.lastRow = height + 1;
+		if (height > 1) stepRows(edgeArgs);
+	}
+	clearHalo(&boardBuffer[0]);
+	if (topology == TOPOLOGY_FRAME) clearFrame(&boardBuffer[0]);
+	board.swap(boardBuffer);
+	generation++;
+	isHashValid = false;
+}
+
+/** \brief Returns number of alive cells.
+
+\return number of alive cells on the board
+*/
+long long DenseEngine::population() {
+	long long count = 0;
+	for (unsigned int i = 0; i < board.size(); i++) {
+		count += popCount(board[i]);
+	}
+	return count;
+}
+
+/** \brief Calls a function for every alive cell.
+
+Cells are visited row by row, empty words are skipped.
+\param callback - function called with x and y of every alive cell
+*/
+void DenseEngine::forEachAlive(const function<void(int, int)>& callback) {
+	for (int y = 0; y < height; y++) {
+		const uint64_t* row = getRow(y);
+		for (int i = 0; i < wordsPerRow; i++) {
+			uint64_t word = row[i];
+			while (word) {
+				callback(i * 64 + lowestBit(word), y);
+				word &= word - 1;
+			}
+		}
+	}
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include "CycleDetector.h"
+#include "LifeEngine.h"
+#include "StepKernels.h"
+#include "ThreadPool.h"
+#include <stdint.h>
+#include <functional>
+#include <memory>
+#include <vector>
+using namespace std;
+
+struct GenerationStats;
+class SoupGenerator;
+
+/** \brief Time spent in the phases of DenseEngine::step, collected only when enabled by setPhaseTiming. */
+struct StepPhaseTimes {
+	double edgeSeconds; /**< Refreshing halo from the topology, clearing halo and frame of the new board. */
+	double kernelSeconds; /**< Step kernel over all bands, including waiting for the threads. */
+	long long generations; /**< Generations the times were collected for. */
+};
+
+class DenseEngine : public LifeEngine {
+private:
+	int wordsPerRow;
+	int stride; /**< Words in one row of the buffers, wordsPerRow and one empty word on both sides. */
+	vector<uint64_t> board;
+	vector<uint64_t> boardBuffer;
+	uint64_t lastWordMask; /**< Bits of the last word of a row that are on the board. */
+
+	int threadCount;
+	unique_ptr<ThreadPool> pool;
+	KernelIsa kernel;
+	bool isTimingPhases;
+	StepPhaseTimes phaseTimes;
+	bool isHashing;
+	bool isHashValid;
+	uint64_t hash; /**< Zobrist hash of the board, valid if isHashValid. */
+	uint64_t checkHash; /**< Hash of the board with independent keys, valid if isHashValid. */
+	CycleDetector* cycleDetector;
+	bool isTopExternal, isBottomExternal; /**< Halo rows set by setHaloRow instead of the topology. */
+
+	void clearFrame(uint64_t*);
+	void clearHalo(uint64_t*);
+	void reverseRow(const uint64_t*, uint64_t*);
+	void refreshHalo(uint64_t*);
+	void refreshHaloColumns(uint64_t*);
+	uint64_t hashRows(const uint64_t*, const uint64_t*, int, int, uint64_t*);
+	void collectStats(const uint64_t*, const uint64_t*, int, int, GenerationStats*);
+
+public:
+	DenseEngine();
+	DenseEngine(int, int, const LifeRule&);
+	void resize(int, int);
+	void clear();
+	void setCell(int, int, bool);
+	bool getCell(int, int);
+	void step(int);
+	void stepWithHalo(const function<void()>&);
+	long long population();
+	void forEachAlive(const function<void(int, int)>&);
+	bool setTopology(Topology);
+	void setThreadCount(int);
+	/** \brief Returns number of threads used by step.
+	*/
+	int getThreadCount() {
+		return threadCount;
+	}
+	bool setKernel(KernelIsa);
+	/** \brief Returns instruction set of the step kernel.
+	*/
+	KernelIsa getKernel() {
+		return kernel;
+	}
+	/** \brief Returns words of one board row.
+
+	Bit i of word j is the cell in column 64 * j + i.
+	\param y - row of the board
+	\return pointer to the first word of the row
+	*/
+	const uint64_t* getRow(int y) {
+		return &board[(y + 1) * stride + 1];
+	}
+	void setRow(int, const uint64_t*);
+	void setExternalHalo(bool, bool);
+	void setHaloRow(bool, const uint64_t*, bool);
+	void fillSoup(const SoupGenerator&, int, int, int, int);
+	void setPhaseTiming(bool);
+	/** \brief Returns time spent in the phases of step since phase timing was enabled.
+	*/
+	const StepPhaseTimes& getPhaseTimes() {
+		return phaseTimes;
+	}
+	void setHashing(bool);
+	uint64_t getHash();
+	uint64_t getCheckHash();
+	void setCycleDetector(CycleDetector*);
+	/** \brief Returns detector that gets the board hash after every generation, NULL if there is none.
+	*/
+	CycleDetector* getCycleDetector() {
+		return cycleDetector;
+	}
+	/** \brief Returns number of words in one board row.
+	*/
+	int getWordsPerRow() {
+		return wordsPerRow;
+	}
+};
@@ -0,0 +1,178 @@
+#include "DensityPyramid.h"
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+using namespace std;
+/** \class DensityPyramid
+	\brief Share of alive cells in square blocks of the board, for every power of two block size.
+
+	Level k has one value for every block of 2^k x 2^k cells, the highest level has a single block. A zoomed out view reads one value per screen pixel from the level of its zoom, so its cost follows the number of pixels and not the number of cells.
+	The pyramid keeps a copy of the board it was computed from. update compares the board with the copy 64 cells at once and recomputes only 64x64 tiles with a changed word, levels 1 to 6 of a tile come from its 64 words and the levels above from the blocks below them that changed.
+	Levels 1 to 5 are stored as densities of one byte, levels from 6 up as counts of alive cells, so the large levels don't add rounding errors.
+*/
+
+/** \brief Class default constructor.
+
+	Creates pyramid of an empty board of size 0.
+*/
+DensityPyramid::DensityPyramid() {
+	this->resize(0, 0);
+}
+
+/** \brief Changes size of the board, the pyramid is computed for a board with no alive cells.
+
+\param width - number of board columns
+\param height - number of board rows
+*/
+void DensityPyramid::resize(int width, int height) {
+	this->width = width;
+	this->height = height;
+	this->wordsPerRow = (width + 63) / 64;
+	this->tileColumns = wordsPerRow;
+	this->tileRows = (height + TILE_SIZE - 1) / TILE_SIZE;
+	shown.assign((size_t)wordsPerRow * height, 0);
+	changedTiles.assign((size_t)tileColumns * tileRows, 0);
+	levelWidths.assign(TILE_LEVEL + 1, 0);
+	levelHeights.assign(TILE_LEVEL + 1, 0);
+	for (int level = 1; level <= TILE_LEVEL; level++) {
+		levelWidths[level] = tileColumns * (TILE_SIZE >> level);
+		levelHeights[level] = tileRows * (TILE_SIZE >> level);
+	}
+	levelCount = TILE_LEVEL;
+	while (levelWidths[levelCount] > 1 || levelHeights[levelCount] > 1) {
+		levelWidths.push_back((levelWidths[levelCount] + 1) / 2);
+		levelHeights.push_back((levelHeights[levelCount] + 1) / 2);
+		levelCount++;
+	}
+	densities.assign(TILE_LEVEL, vector<uint8_t>());
+	counts.assign(levelCount + 1, vector<uint32_t>());
+	for (int level = 1; level <= levelCount; level++) {
+		size_t blocks = (size_t)levelWidths[level] * levelHeights[level];
+		if (level < TILE_LEVEL) densities[level].assign(blocks, 0);
+		else counts[level].assign(blocks, 0);
+	}
+	changedBlocks.assign(levelCount > TILE_LEVEL ? (size_t)levelWidths[TILE_LEVEL + 1] * levelHeights[TILE_LEVEL + 1] : 0, 0);
+}
+
+/** \brief Recomputes levels 1 to 6 of a tile from the copy of the board.
+
+Level 1 counts pairs of bits of two rows in parallel, 16 blocks of a row in the nibbles of a word, and its rows are summed into level 2 on the way. Every higher level adds the four blocks below it.
+\param tileX - column of the tile, a word column of the board
+\param tileY - row of the tile
+*/
+void DensityPyramid::updateTile(int tileX, int tileY) {
+	const uint64_t pairs = 0x5555555555555555ULL;
+	static const uint8_t levelOneDensities[5] = { 0, 64, 128, 192, 255 };
+	uint16_t blockCounts[2][16 * 16];
+	uint16_t* below = blockCounts[0];
+	uint16_t* above = blockCounts[1];
+	size_t first = (size_t)tileY * 32 * levelWidths[1] + (size_t)tileX * 32;
+	for (int r = 0; r < TILE_SIZE / 2; r++) {
+		int y = tileY * TILE_SIZE + r * 2;
+		uint64_t top = y < height ? shown[(size_t)y * wordsPerRow + tileX] : 0;
+		uint64_t bottom = y + 1 < height ? shown[(size_t)(y + 1) * wordsPerRow + tileX] : 0;
+		uint64_t topPairs = (top & pairs) + ((top >> 1) & pairs);
+		uint64_t bottomPairs = (bottom & pairs) + ((bottom >> 1) & pairs);
+		//nibble j of even is block 2 * j of the row of level 1, of odd block 2 * j + 1, both count up to 4
+		uint64_t even = (topPairs & 0x3333333333333333ULL) + (bottomPairs & 0x3333333333333333ULL);
+		uint64_t odd = ((topPairs >> 2) & 0x3333333333333333ULL) + ((bottomPairs >> 2) & 0x3333333333333333ULL);
+		uint8_t* row = &densities[1][first + (size_t)r * levelWidths[1]];
+		for (int c = 0; c < 16; c++) {
+			row[c * 2] = levelOneDensities[(even >> (c * 4)) & 15];
+			row[c * 2 + 1] = levelOneDensities[(odd >> (c * 4)) & 15];
+		}
+		//level 2 adds two blocks of a row here and two rows of blocks below
+		uint64_t sums = even + odd;
+		uint16_t* counts2 = &below[(r / 2) * 16];
+		for (int c = 0; c < 16; c++) {
+			uint16_t sum = (uint16_t)((sums >> (c * 4)) & 15);
+			counts2[c] = r % 2 ? (uint16_t)(counts2[c] + sum) : sum;
+		}
+	}
+	for (int level = 2; level <= TILE_LEVEL; level++) {
+		int side = TILE_SIZE >> level;
+		if (level > 2) {
+			for (int r = 0; r < side; r++) {
+				for (int c = 0; c < side; c++) {
+					const uint16_t* children = &below[r * 2 * side * 2 + c * 2];
+					above[r * side + c] = (uint16_t)(children[0] + children[1] + children[side * 2] + children[side * 2 + 1]);
+				}
+			}
+			swap(below, above);
+		}
+		first = (size_t)tileY * side * levelWidths[level] + (size_t)tileX * side;
+		if (level == TILE_LEVEL) {
+			counts[level][first] = below[0];
+			continue;
+		}
+		uint32_t roundUp = (1u << (2 * level)) - 1;
+		for (int r = 0; r < side; r++) {
+			uint8_t* row = &densities[level][first + (size_t)r * levelWidths[level]];
+			for (int c = 0; c < side; c++) {
+				row[c] = (uint8_t)((below[r * side + c] * 255u + roundUp) >> (2 * level));
+			}
+		}
+	}
+}
+
+/** \brief Brings the pyramid up to date with a board.
+
+A board of another size resizes the pyramid first.
+\param words - rows of the board, bit i of word j is the cell in column 64 * j + i
+\param width - number of board columns
+\param height - number of board rows
+\param rowWords - words in one row of words, at least (width + 63) / 64
+\return number of 64x64 tiles that were recomputed
+*/
+long long DensityPyramid::update(const uint64_t* words, int width, int height, int rowWords) {
+	if (width != this->width || height != this->height) {
+		resize(width, height);
+	}
+	long long changed = 0;
+	for (int y = 0; y < height; y++) {
+		const uint64_t* row = &words[(size_t)y * rowWords];
+		uint64_t* shownRow = &shown[(size_t)y * wordsPerRow];
+		unsigned char* tiles = &changedTiles[(size_t)(y / TILE_SIZE) * tileColumns];
+		for (int i = 0; i < wordsPerRow; i++) {
+			if (row[i] != shownRow[i]) {
+				shownRow[i] = row[i];
+				tiles[i] = 1;
+			}
+		}
+	}
+	vector<int> blocks;
+	for (int tileY = 0; tileY < tileRows; tileY++) {
+		for (int tileX = 0; tileX < tileColumns; tileX++) {
+			if (!changedTiles[(size_t)tileY * tileColumns + tileX]) continue;
+			changedTiles[(size_t)tileY * tileColumns + tileX] = 0;
+			updateTile(tileX, tileY);
+			blocks.push_back(tileY * tileColumns + tileX);
+			changed++;
+		}
+	}
+	//every changed block of a level marks its parent, parents are summed from their four children
+	for (int level = TILE_LEVEL + 1; level <= levelCount && !blocks.empty(); level++) {
+		int childWidth = levelWidths[level - 1];
+		int childHeight = levelHeights[level - 1];
+		vector<int> parents;
+		for (int block : blocks) {
+			int parent = (block / childWidth / 2) * levelWidths[level] + (block % childWidth) / 2;
+			if (changedBlocks[parent]) continue;
+			changedBlocks[parent] = 1;
+			parents.push_back(parent);
+		}
+		for (int parent : parents) {
+			changedBlocks[parent] = 0;
+			int x = parent % levelWidths[level] * 2;
+			int y = parent / levelWidths[level] * 2;
+			const uint32_t* children = counts[level - 1].data();
+			uint32_t count = children[(size_t)y * childWidth + x];
+			if (x + 1 < childWidth) count += children[(size_t)y * childWidth + x + 1];
+			if (y + 1 < childHeight) count += children[(size_t)(y + 1) * childWidth + x];
+			if (x + 1 < childWidth && y + 1 < childHeight) count += children[(size_t)(y + 1) * childWidth + x + 1];
+			counts[level][parent] = count;
+		}
+		blocks.swap(parents);
+	}
+	return changed;
+}
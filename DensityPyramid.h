@@ -0,0 +1,57 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+using namespace std;
+
+class DensityPyramid {
+private:
+	static const int TILE_SIZE = 64; /**< Tiles are one word wide and 64 rows high, levels 1 to 6 of a tile are computed together. */
+	static const int TILE_LEVEL = 6;
+
+	int width, height;
+	int wordsPerRow;
+	int tileColumns, tileRows;
+	int levelCount; /**< Highest level, its single block covers the whole board. */
+	vector<uint64_t> shown; /**< Board the pyramid was computed from, rows of wordsPerRow words. */
+	vector< vector<uint8_t> > densities; /**< Levels 1 to 5, see density. */
+	vector< vector<uint32_t> > counts; /**< Levels from 6 up, alive cells of every block. */
+	vector<int> levelWidths, levelHeights;
+	vector<unsigned char> changedTiles;
+	vector<unsigned char> changedBlocks;
+
+	void updateTile(int, int);
+
+public:
+	DensityPyramid();
+	void resize(int, int);
+	long long update(const uint64_t*, int, int, int);
+	/** \brief Returns the highest level, a block of it covers the whole board.
+	*/
+	int getLevelCount() {
+		return levelCount;
+	}
+	/** \brief Returns number of blocks in a row of a level.
+	*/
+	int getLevelWidth(int level) {
+		return levelWidths[level];
+	}
+	/** \brief Returns number of blocks in a column of a level.
+	*/
+	int getLevelHeight(int level) {
+		return levelHeights[level];
+	}
+	/** \brief Returns density of a block of 2^level x 2^level cells.
+
+	\param level - level from 1 to getLevelCount
+	\param x - column of the block
+	\param y - row of the block
+	\return share of alive cells from 0 to 255, rounded up, so a block with an alive cell is never 0
+	*/
+	int density(int level, int x, int y) {
+		if (level < TILE_LEVEL) {
+			return densities[level][(size_t)y * levelWidths[level] + x];
+		}
+		uint64_t count = counts[level][(size_t)y * levelWidths[level] + x];
+		return (int)((count * 255 + ((uint64_t)1 << (2 * level)) - 1) >> (2 * level));
+	}
+};
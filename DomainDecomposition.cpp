@@ -0,0 +1,208 @@
+#include "DomainDecomposition.h"
+#include "DenseEngine.h"
+#include "HaloExchange.h"
+#include "PatternFile.h"
+#include "SoupGenerator.h"
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+using namespace std;
+/** \file DomainDecomposition.cpp
+	\brief Simulation of one board by several processes.
+
+	The board is split into bands of whole rows, one per process, so a band has at most two neighbors and its halo is one row above and one below it. Columns stay in one band, their halo follows the topology inside every process. Every generation a band process sends its first and last row to its neighbors(HaloExchange.h), computes the rows that don't touch the halo while the rows travel, receives the rows of its neighbors as its halo rows and computes its first and last row(DenseEngine::stepWithHalo). Board edges keep their topology, bands on the top and bottom edge of a torus or Klein bottle are neighbors of each other.
+	Every cell sees the same neighbors as in a single DenseEngine, so the board is the same bit for bit. Processes are started with fork, on Windows runDomains fails.
+*/
+
+/** \brief Seeds the rows of a band of the board like a single process seeds the whole board.
+
+Soup words depend only on their position(SoupGenerator.h) and a pattern is placed in the middle of the whole board, so every band gets exactly its part of the board.
+\param config - board and seed
+\param engine - empty band of config.width columns with its topology and external halo set
+\param firstRow - row of the board that is the first row of the band
+\return false if the pattern could not be read
+*/
+bool seedDomain(const DomainConfig& config, DenseEngine* engine, int firstRow) {
+	if (!config.patternPath.empty()) {
+		PatternStats stats;
+		if (!readPattern(config.patternPath, NULL, 0, 0, &stats)) {
+			return false;
+		}
+		return readPattern(config.patternPath, engine, config.width / 2 - (stats.minX + stats.maxX) / 2, config.height / 2 - (stats.minY + stats.maxY) / 2 - firstRow, &stats);
+	}
+	SoupGenerator generator(config.soupSeed, config.density);
+	vector<uint64_t> row(engine->getWordsPerRow());
+	for (int y = 0; y < engine->getHeight(); y++) {
+		generator.fillRow(firstRow + y, 0, (int)row.size(), row.data());
+		engine->setRow(y, row.data());
+	}
+	return true;
+}
+
+#ifndef _WIN32
+/** \brief Runs the generations of one band, called in the band process.
+
+\param config - board and run
+\param firstRow - first row of the band
+\param lastRow - row after the band
+\param above - channel to the band above, NULL on the top edge of the board
+\param below - channel to the band below, NULL on the bottom edge of the board
+\param isWrapped - true if above and below connect the top and bottom edge of a torus or Klein bottle for the first and last band
+\param rows - shared rows of the whole board, get the rows of the band
+\param times - shared times of the band, gets seconds of the generations and of waiting for halo rows
+\return false if seeding or a channel failed
+*/
+static bool runBand(const DomainConfig& config, int firstRow, int lastRow, HaloChannel* above, HaloChannel* below, bool isWrapped, uint64_t* rows, double* times) {
+	DenseEngine engine(config.width, lastRow - firstRow, config.rule);
+	engine.setTopology(config.topology);
+	engine.setExternalHalo(above != NULL, below != NULL);
+	engine.setThreadCount(config.threads);
+	if (!seedDomain(config, &engine, firstRow)) {
+		return false;
+	}
+	int wordsPerRow = engine.getWordsPerRow();
+	vector<uint64_t> aboveRow(wordsPerRow), belowRow(wordsPerRow);
+	vector<HaloChannel*> channels;
+	vector<uint64_t*> haloRows;
+	if (above != NULL) {
+		channels.push_back(above);
+		haloRows.push_back(aboveRow.data());
+	}
+	if (below != NULL) {
+		channels.push_back(below);
+		haloRows.push_back(belowRow.data());
+	}
+	//rows across the glued edge of a Klein bottle are flipped
+	bool isAboveReversed = isWrapped && firstRow == 0 && config.topology == TOPOLOGY_KLEIN;
+	bool isBelowReversed = isWrapped && lastRow == config.height && config.topology == TOPOLOGY_KLEIN;
+	bool isFailed = false;
+	double haloSeconds = 0;
+	auto begin = chrono::steady_clock::now();
+	for (long long g = 0; g < config.generations && !isFailed; g++) {
+		if (above != NULL && !above->send(engine.getRow(0))) break;
+		if (below != NULL && !below->send(engine.getRow(engine.getHeight() - 1))) break;
+		engine.stepWithHalo([&]() {
+			auto waitBegin = chrono::steady_clock::now();
+			isFailed = !waitForHalo(channels, haloRows);
+			haloSeconds += chrono::duration<double>(chrono::steady_clock::now() - waitBegin).count();
+			if (above != NULL) engine.setHaloRow(true, aboveRow.data(), isAboveReversed);
+			if (below != NULL) engine.setHaloRow(false, belowRow.data(), isBelowReversed);
+		});
+	}
+	if (isFailed || engine.getGeneration() != config.generations) {
+		return false;
+	}
+	times[0] = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	times[1] = haloSeconds;
+	for (int y = 0; y < engine.getHeight(); y++) {
+		copy(engine.getRow(y), engine.getRow(y) + wordsPerRow, &rows[(size_t)(firstRow + y) * wordsPerRow]);
+	}
+	return true;
+}
+#endif
+
+/** \brief Computes generations of a board split between config.workers processes on this host.
+
+Channels of all boundaries and memory for the result are created first, then one process per band is forked. Every band process keeps only the channels of its own two boundaries, so a process that ends closes them and its neighbors fail instead of waiting forever. If a band process fails the others are killed. Has to be called before the calling process starts other threads.
+\param config - board, seed and run
+\param board - gets the board after config.generations generations, like a DenseEngine seeded with seedDomain and stepped in one process
+\param result - gets times measured by the band processes
+\return false if the configuration is invalid, a transport is not available or a band process failed
+*/
+bool runDomains(const DomainConfig& config, DenseEngine* board, DomainResult* result) {
+#ifdef _WIN32
+	cout << "Simulation in several processes needs fork, it is not supported on Windows." << endl;
+	return false;
+#else
+	int workers = config.workers;
+	if (config.width < 1 || config.height < 1 || workers < 1 || workers > config.height) {
+		return false;
+	}
+	int wordsPerRow = (config.width + 63) / 64;
+	bool isWrapped = workers > 1 && (config.topology == TOPOLOGY_TORUS || config.topology == TOPOLOGY_KLEIN);
+	//boundary b is below band b and above band b + 1, the last boundary of a wrapped board is below the last band and above the first one
+	int boundaryCount = isWrapped ? workers : workers - 1;
+	vector< unique_ptr<HaloChannel> > upperEnds(boundaryCount), lowerEnds(boundaryCount);
+	for (int b = 0; b < boundaryCount; b++) {
+		if (!createHaloChannels(config.transport, wordsPerRow, &upperEnds[b], &lowerEnds[b])) {
+			cout << "Channels of transport " << transportName(config.transport) << " could not be created." << endl;
+			return false;
+		}
+	}
+	size_t rowBytes = (size_t)config.height * wordsPerRow * sizeof(uint64_t);
+	size_t sharedSize = rowBytes + (size_t)workers * 2 * sizeof(double);
+	void* shared = mmap(NULL, sharedSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (shared == MAP_FAILED) {
+		return false;
+	}
+	uint64_t* rows = (uint64_t*)shared;
+	double* times = (double*)((char*)shared + rowBytes);
+	//buffered output would be written again by every process
+	cout.flush();
+	vector<pid_t> processes;
+	for (int band = 0; band < workers; band++) {
+		pid_t process = fork();
+		if (process < 0) {
+			break;
+		}
+		if (process == 0) {
+			HaloChannel* above = band > 0 || isWrapped ? lowerEnds[(band + boundaryCount - 1) % boundaryCount].release() : NULL;
+			HaloChannel* below = band < workers - 1 || isWrapped ? upperEnds[band].release() : NULL;
+			upperEnds.clear();
+			lowerEnds.clear();
+			bool isDone = runBand(config, (int)((long long)config.height * band / workers), (int)((long long)config.height * (band + 1) / workers), above, below, isWrapped, rows, &times[band * 2]);
+			delete above;
+			delete below;
+			_exit(isDone ? 0 : 1);
+		}
+		processes.push_back(process);
+	}
+	upperEnds.clear();
+	lowerEnds.clear();
+	bool isDone = (int)processes.size() == workers;
+	if (!isDone) {
+		for (pid_t process : processes) kill(process, SIGKILL);
+	}
+	for (size_t remaining = processes.size(); remaining > 0; remaining--) {
+		int status;
+		pid_t process = waitpid(-1, &status, 0);
+		if (process < 0) break;
+		if (find(processes.begin(), processes.end(), process) == processes.end()) {
+			remaining++;
+			continue;
+		}
+		if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+			if (isDone) {
+				for (pid_t other : processes) kill(other, SIGKILL);
+			}
+			isDone = false;
+		}
+	}
+	if (isDone) {
+		board->resize(config.width, config.height);
+		board->setRule(config.rule);
+		board->setTopology(config.topology);
+		for (int y = 0; y < config.height; y++) {
+			board->setRow(y, &rows[(size_t)y * wordsPerRow]);
+		}
+		board->setGeneration(config.generations);
+		result->seconds = 0;
+		result->haloSeconds = 0;
+		for (int band = 0; band < workers; band++) {
+			result->seconds = max(result->seconds, times[band * 2]);
+			result->haloSeconds = max(result->haloSeconds, times[band * 2 + 1]);
+		}
+	}
+	munmap(shared, sharedSize);
+	return isDone;
+#endif
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "DenseEngine.h"
+#include "HaloExchange.h"
+#include "LifeEngine.h"
+#include "LifeRule.h"
+#include <stdint.h>
+#include <string>
+using namespace std;
+
+/** \brief Board and run of a simulation split into bands of rows computed by separate processes. */
+struct DomainConfig {
+	int width, height;
+	LifeRule rule;
+	Topology topology;
+	int workers; /**< Number of band processes, at most the number of rows. */
+	HaloTransport transport;
+	int threads; /**< Threads of every band process. */
+	long long generations;
+	uint64_t soupSeed;
+	int density; /**< Percent of alive cells of the soup. */
+	string patternPath; /**< Pattern placed in the middle of the board instead of the soup, empty for the soup. */
+};
+
+/** \brief Times measured by the band processes of runDomains. */
+struct DomainResult {
+	double seconds; /**< Generations of the slowest band process, without starting the processes and seeding. */
+	double haloSeconds; /**< Longest time a band process waited for the rows of its neighbors. */
+};
+
+bool seedDomain(const DomainConfig&, DenseEngine*, int);
+bool runDomains(const DomainConfig&, DenseEngine*, DomainResult*);
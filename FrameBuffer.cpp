@@ -0,0 +1,173 @@
+#include "FrameBuffer.h"
+#include "DenseEngine.h"
+#include "LifeEngine.h"
+#include "LifeKernel.h"
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+using namespace std;
+/** \class FrameBuffer
+	\brief Software image of the board, redrawn only where cells changed.
+
+	Pixels have the ARGB8888 format of a streaming SDL_Texture and the look of drawCell, every cell is a square of scale pixels with a one pixel outline, cells smaller than GRID_MIN_SCALE have no outline. Nothing depends on SDL, so the image can be rendered and checked without a window.
+	Cells drawn in the image are kept as bit-packed rows, update compares them with the engine 64 cells at once and redraws only cells that changed, so its cost follows the number of changed cells. Changed cells are collected into tiles of 64x16 cells and neighboring changed tiles of a tile row are merged into rectangles, which are the only parts of the texture that have to be uploaded.
+*/
+
+/** \brief Class default constructor.
+
+	Creates empty image.
+*/
+FrameBuffer::FrameBuffer() {
+	this->resize(0, 0, 1);
+}
+
+/** \brief Class constructor with image parameters.
+
+	\param width - number of board columns
+	\param height - number of board rows
+	\param scale - size of Cell side in pixels
+*/
+FrameBuffer::FrameBuffer(int width, int height, int scale) {
+	this->resize(width, height, scale);
+}
+
+/** \brief Changes size of the image, all cells are drawn dead.
+
+	\param width - number of board columns
+	\param height - number of board rows
+	\param scale - size of Cell side in pixels
+*/
+void FrameBuffer::resize(int width, int height, int scale) {
+	this->width = width;
+	this->height = height;
+	this->scale = scale;
+	this->wordsPerRow = (width + 63) / 64;
+	this->tileColumns = (width + TILE_WIDTH - 1) / TILE_WIDTH;
+	this->tileRows = (height + TILE_HEIGHT - 1) / TILE_HEIGHT;
+	aliveCell.assign((size_t)scale * scale, scale >= GRID_MIN_SCALE ? ALIVE_OUTLINE : ALIVE_FILL);
+	deadCell.assign((size_t)scale * scale, scale >= GRID_MIN_SCALE ? DEAD_OUTLINE : DEAD_FILL);
+	for (int i = 1; i < scale - 1; i++) {
+		for (int j = 1; j < scale - 1; j++) {
+			aliveCell[i * scale + j] = ALIVE_FILL;
+			deadCell[i * scale + j] = DEAD_FILL;
+		}
+	}
+	pixels.assign((size_t)width * scale * height * scale, 0);
+	shown.assign((size_t)height * wordsPerRow, 0);
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			drawCell(x, y, false);
+		}
+	}
+	changedCells = 0;
+	markAllDirty();
+}
+
+/** \brief Draws one cell into the pixels.
+
+	\param x - column of the cell
+	\param y - row of the cell
+	\param isAlive - true if alive cell is drawn, false if dead cell is drawn
+*/
+void FrameBuffer::drawCell(int x, int y, bool isAlive) {
+	const uint32_t* cell = isAlive ? aliveCell.data() : deadCell.data();
+	size_t pixelWidth = (size_t)width * scale;
+	uint32_t* target = &pixels[(size_t)y * scale * pixelWidth + (size_t)x * scale];
+	for (int i = 0; i < scale; i++) {
+		memcpy(target + i * pixelWidth, cell + i * scale, scale * sizeof(uint32_t));
+	}
+}
+
+/** \brief Marks the whole image as changed, so the next update returns all of it.
+*/
+void FrameBuffer::markAllDirty() {
+	dirtyTiles.assign((size_t)tileColumns * tileRows, 1);
+}
+
+/** \brief Turns changed tiles into pixel rectangles and clears the tiles.
+
+	Neighboring changed tiles of one tile row become one rectangle.
+*/
+void FrameBuffer::collectDirtyRects() {
+	dirtyRects.clear();
+	for (int row = 0; row < tileRows; row++) {
+		unsigned char* tiles = &dirtyTiles[(size_t)row * tileColumns];
+		for (int column = 0; column < tileColumns; column++) {
+			if (!tiles[column]) continue;
+			int first = column;
+			while (column < tileColumns && tiles[column]) tiles[column++] = 0;
+			FrameRect rect;
+			rect.x = first * TILE_WIDTH * scale;
+			rect.y = row * TILE_HEIGHT * scale;
+			rect.w = min(column * TILE_WIDTH, width) * scale - rect.x;
+			rect.h = min((row + 1) * TILE_HEIGHT, height) * scale - rect.y;
+			dirtyRects.push_back(rect);
+		}
+	}
+}
+
+/** \brief Redraws cells of one row that changed since the last update.
+
+	\param y - row of the board
+	\param row - bit-packed cells of the row
+*/
+void FrameBuffer::updateRow(int y, const uint64_t* row) {
+	uint64_t* shownRow = &shown[(size_t)y * wordsPerRow];
+	for (int i = 0; i < wordsPerRow; i++) {
+		uint64_t changed = row[i] ^ shownRow[i];
+		if (!changed) continue;
+		shownRow[i] = row[i];
+		dirtyTiles[(size_t)(y / TILE_HEIGHT) * tileColumns + i * 64 / TILE_WIDTH] = 1;
+		for (; changed; changed &= changed - 1) {
+			int bit = lowestBit(changed);
+			drawCell(i * 64 + bit, y, (row[i] >> bit) & 1);
+			changedCells++;
+		}
+	}
+}
+
+/** \brief Redraws cells that changed since the last update.
+
+	Rows of DenseEngine are compared directly, other engines are first copied to bit-packed rows with forEachAlive. If the board has another size than the image, the image is resized and redrawn.
+	\param engine - simulation engine
+	\return rectangles of pixels that changed, valid until the next update
+*/
+const vector<FrameRect>& FrameBuffer::update(LifeEngine* engine) {
+	if (engine->getWidth() != width || engine->getHeight() != height) {
+		resize(engine->getWidth(), engine->getHeight(), scale);
+	}
+	DenseEngine* dense = dynamic_cast<DenseEngine*>(engine);
+	if (dense == NULL) {
+		alive.assign((size_t)height * wordsPerRow, 0);
+		engine->forEachAlive([&](int x, int y) {
+			alive[(size_t)y * wordsPerRow + x / 64] |= (uint64_t)1 << (x % 64);
+		});
+	}
+	changedCells = 0;
+	for (int y = 0; y < height; y++) {
+		updateRow(y, dense != NULL ? dense->getRow(y) : &alive[(size_t)y * wordsPerRow]);
+	}
+	collectDirtyRects();
+	return dirtyRects;
+}
+
+/** \brief Redraws cells that changed since the last update from bit-packed rows.
+
+	Used for boards copied from an engine, e.g. by SimulationThread. If the board has another size than the image, the image is resized and redrawn.
+	\param words - rows of the board, (width + 63) / 64 words each
+	\param width - number of board columns
+	\param height - number of board rows
+	\return rectangles of pixels that changed, valid until the next update
+*/
+const vector<FrameRect>& FrameBuffer::update(const uint64_t* words, int width, int height) {
+	if (width != this->width || height != this->height) {
+		resize(width, height, scale);
+	}
+	changedCells = 0;
+	for (int y = 0; y < height; y++) {
+		updateRow(y, &words[(size_t)y * wordsPerRow]);
+	}
+	collectDirtyRects();
+	return dirtyRects;
+}
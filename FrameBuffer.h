@@ -0,0 +1,74 @@
+#pragma once
+#include "LifeEngine.h"
+#include <stdint.h>
+#include <vector>
+using namespace std;
+
+/** \brief Rectangle of pixels changed by FrameBuffer::update. */
+struct FrameRect {
+	int x, y, w, h;
+};
+
+class FrameBuffer {
+private:
+	static const int TILE_WIDTH = 64; /**< Cells in a tile row, one word of a board row. */
+	static const int TILE_HEIGHT = 16;
+
+	int width;
+	int height;
+	int scale;
+	int wordsPerRow;
+	int tileColumns;
+	int tileRows;
+	vector<uint32_t> pixels; /**< ARGB8888 pixels, width * scale columns and height * scale rows. */
+	vector<uint64_t> shown; /**< Cells drawn in pixels, bit-packed rows like DenseEngine rows. */
+	vector<uint64_t> alive; /**< Cells of an engine that doesn't store bit-packed rows. */
+	vector<uint32_t> aliveCell; /**< Pixels of one alive cell, scale * scale. */
+	vector<uint32_t> deadCell;
+	vector<unsigned char> dirtyTiles;
+	vector<FrameRect> dirtyRects;
+	long long changedCells;
+
+	void drawCell(int, int, bool);
+	void markAllDirty();
+	void collectDirtyRects();
+	void updateRow(int, const uint64_t*);
+
+public:
+	static constexpr uint32_t ALIVE_FILL = 0xFFAAAAAA; /**< Colors of drawCell, also used by FrameExporter. */
+	static constexpr uint32_t ALIVE_OUTLINE = 0xFFDBDB93;
+	static constexpr uint32_t DEAD_FILL = 0xFF555555;
+	static constexpr uint32_t DEAD_OUTLINE = 0xFF444444;
+	static const int GRID_MIN_SCALE = 4; /**< Smallest cell side with an outline, smaller cells are filled and the grid is not drawn. */
+
+	FrameBuffer();
+	FrameBuffer(int, int, int);
+	void resize(int, int, int);
+	const vector<FrameRect>& update(LifeEngine*);
+	const vector<FrameRect>& update(const uint64_t*, int, int);
+	/** \brief Returns pixels, row after row.
+	*/
+	const uint32_t* getPixels() {
+		return pixels.data();
+	}
+	/** \brief Returns width of the image in pixels.
+	*/
+	int getPixelWidth() {
+		return width * scale;
+	}
+	/** \brief Returns height of the image in pixels.
+	*/
+	int getPixelHeight() {
+		return height * scale;
+	}
+	/** \brief Returns bytes between the starts of two pixel rows.
+	*/
+	int getPitch() {
+		return width * scale * (int)sizeof(uint32_t);
+	}
+	/** \brief Returns number of cells redrawn by the last update.
+	*/
+	long long getChangedCells() {
+		return changedCells;
+	}
+};
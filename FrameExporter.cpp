@@ -0,0 +1,613 @@
+#include "FrameExporter.h"
+#include "DenseEngine.h"
+#include "FrameBuffer.h"
+#include "LifeEngine.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+/** \class FrameExporter
+	\brief Writes generations of a board as video frames without a window.
+
+	addFrame copies the packed rows of the board into a bounded queue and returns, worker threads rasterize the rows straight into palette indexes with the look of FrameBuffer(a square of scale pixels for every cell, with a one pixel outline from FrameBuffer::GRID_MIN_SCALE up) and encode them. The simulation waits only when the queue is full.
+	Frames are encoded in parallel. Y4M and GIF frames are independent, so they are encoded in any order and appended to the file in the order they were added, every PNG frame is a file of its own. PNG uses a small deflate encoder with fixed Huffman codes whose matches are mostly runs of one color and the pixel row above, which is where almost all of the redundancy of a scaled board is.
+*/
+
+/** \brief Colors of the palette indexes written by rasterize, dead fill, dead outline, alive fill and alive outline. */
+static const uint32_t PALETTE[4] = { FrameBuffer::DEAD_FILL, FrameBuffer::DEAD_OUTLINE, FrameBuffer::ALIVE_FILL, FrameBuffer::ALIVE_OUTLINE };
+
+/** \brief Returns format of frames written to a path.
+
+Format is taken from the extension, .y4m, .png or .gif.
+\param path - path to the output
+\return format of the output, EXPORT_UNKNOWN for other extensions
+*/
+ExportFormat exportFormat(const string& path) {
+	size_t dot = path.find_last_of('.');
+	string extension = dot == string::npos ? "" : path.substr(dot + 1);
+	transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return (char)tolower(c); });
+	if (extension == "y4m") return EXPORT_Y4M;
+	if (extension == "png") return EXPORT_PNG;
+	if (extension == "gif") return EXPORT_GIF;
+	return EXPORT_UNKNOWN;
+}
+
+/** \brief Returns path of one PNG frame, frames.png gives frames_000000.png, frames_000001.png and so on.
+*/
+static string framePath(const string& path, long long number) {
+	size_t dot = path.find_last_of('.');
+	char suffix[32];
+	snprintf(suffix, sizeof(suffix), "_%06lld", number);
+	return path.substr(0, dot) + suffix + path.substr(dot);
+}
+
+/** \brief Appends a number to bytes, most significant byte first.
+*/
+static void appendBigEndian(vector<uint8_t>* bytes, uint32_t value) {
+	for (int shift = 24; shift >= 0; shift -= 8) bytes->push_back((uint8_t)(value >> shift));
+}
+
+/** \brief Appends a 16 bit number to bytes, least significant byte first.
+*/
+static void appendLittleEndian16(vector<uint8_t>* bytes, int value) {
+	bytes->push_back((uint8_t)value);
+	bytes->push_back((uint8_t)(value >> 8));
+}
+
+/** \brief Returns CRC-32 of bytes, the checksum of PNG chunks.
+*/
+static uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc) {
+	static const struct CrcTable {
+		uint32_t values[256];
+		CrcTable() {
+			for (uint32_t i = 0; i < 256; i++) {
+				uint32_t value = i;
+				for (int bit = 0; bit < 8; bit++) value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+				values[i] = value;
+			}
+		}
+	} table;
+	crc = ~crc;
+	for (size_t i = 0; i < size; i++) crc = table.values[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+
+/** \brief Returns Adler-32 of bytes, the checksum at the end of a zlib stream.
+*/
+static uint32_t adler32(const uint8_t* data, size_t size) {
+	uint32_t a = 1, b = 0;
+	while (size > 0) {
+		size_t block = min(size, (size_t)5552); //longest block whose sums can't overflow
+		for (size_t i = 0; i < block; i++) {
+			a += data[i];
+			b += a;
+		}
+		a %= 65521;
+		b %= 65521;
+		data += block;
+		size -= block;
+	}
+	return (b << 16) | a;
+}
+
+/** \brief Writes codes of variable length into bytes, lowest bit first, like deflate and GIF LZW. */
+struct BitWriter {
+	vector<uint8_t>* bytes;
+	uint64_t bits;
+	int count;
+
+	BitWriter(vector<uint8_t>* bytes) {
+		this->bytes = bytes;
+		this->bits = 0;
+		this->count = 0;
+	}
+	void write(uint32_t value, int length) {
+		bits |= (uint64_t)value << count;
+		count += length;
+		while (count >= 8) {
+			bytes->push_back((uint8_t)bits);
+			bits >>= 8;
+			count -= 8;
+		}
+	}
+	void flush() {
+		if (count > 0) bytes->push_back((uint8_t)bits);
+		bits = 0;
+		count = 0;
+	}
+};
+
+/** \brief Codes of the fixed Huffman deflate block, bit-reversed so they can be written lowest bit first. */
+struct FixedHuffman {
+	uint16_t literalCode[288];
+	uint8_t literalLength[288];
+	uint16_t lengthSymbol[259]; /**< Symbol of every match length from 3 to 258, 257 to 285. */
+	static const uint16_t lengthBase[29];
+	static const uint8_t lengthExtra[29];
+	static const uint16_t distanceBase[30];
+	static const uint8_t distanceExtra[30];
+
+	static uint32_t reverse(uint32_t code, int length) {
+		uint32_t reversed = 0;
+		for (int i = 0; i < length; i++) reversed |= ((code >> i) & 1) << (length - 1 - i);
+		return reversed;
+	}
+	FixedHuffman() {
+		for (int symbol = 0; symbol < 288; symbol++) {
+			uint32_t code;
+			int length;
+			if (symbol < 144) { code = 0x30 + symbol; length = 8; }
+			else if (symbol < 256) { code = 0x190 + symbol - 144; length = 9; }
+			else if (symbol < 280) { code = symbol - 256; length = 7; }
+			else { code = 0xC0 + symbol - 280; length = 8; }
+			literalCode[symbol] = (uint16_t)reverse(code, length);
+			literalLength[symbol] = (uint8_t)length;
+		}
+		for (int i = 0; i < 29; i++) {
+			int last = i == 28 ? 258 : lengthBase[i + 1] - 1;
+			for (int length = lengthBase[i]; length <= last; length++) lengthSymbol[length] = (uint16_t)i;
+		}
+	}
+};
+
+const uint16_t FixedHuffman::lengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+const uint8_t FixedHuffman::lengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+const uint16_t FixedHuffman::distanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+const uint8_t FixedHuffman::distanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+/** \brief Compresses bytes into a zlib stream with one fixed Huffman deflate block.
+
+Matches are looked for at distance 1(runs of one color), at the previous row and at the last position with the same three bytes, the longest one is taken.
+\param data - bytes to compress
+\param size - number of bytes
+\param rowBytes - distance of the previous row, 0 if the data has no rows
+\param bytes - stream is appended to it
+*/
+static void zlibCompress(const uint8_t* data, size_t size, size_t rowBytes, vector<uint8_t>* bytes) {
+	static const FixedHuffman huffman;
+	const int hashBits = 15;
+	const size_t window = 32768;
+	const size_t maxLength = 258;
+	vector<int64_t> head((size_t)1 << hashBits, -1);
+	bytes->push_back(0x78);
+	bytes->push_back(0x01);
+	BitWriter writer(bytes);
+	writer.write(1, 1); //last block
+	writer.write(1, 2); //fixed Huffman codes
+	size_t position = 0;
+	while (position < size) {
+		size_t bestLength = 0, bestDistance = 0;
+		if (position + 3 <= size) {
+			uint32_t key = data[position] | (data[position + 1] << 8) | (data[position + 2] << 16);
+			uint32_t hash = (key * 2654435761u) >> (32 - hashBits);
+			int64_t candidates[3] = { (int64_t)position - 1, rowBytes > 0 ? (int64_t)position - (int64_t)rowBytes : -1, head[hash] };
+			size_t limit = min(maxLength, size - position);
+			for (int64_t candidate : candidates) {
+				if (candidate < 0 || position - candidate > window) continue;
+				const uint8_t* from = data + candidate;
+				const uint8_t* to = data + position;
+				size_t length = 0;
+				while (length < limit && from[length] == to[length]) length++;
+				if (length > bestLength) {
+					bestLength = length;
+					bestDistance = position - candidate;
+				}
+			}
+			head[hash] = (int64_t)position;
+		}
+		if (bestLength >= 3) {
+			int symbol = huffman.lengthSymbol[bestLength];
+			writer.write(huffman.literalCode[257 + symbol], huffman.literalLength[257 + symbol]);
+			writer.write((uint32_t)(bestLength - FixedHuffman::lengthBase[symbol]), FixedHuffman::lengthExtra[symbol]);
+			int distanceSymbol = 29;
+			while (FixedHuffman::distanceBase[distanceSymbol] > bestDistance) distanceSymbol--;
+			writer.write(FixedHuffman::reverse(distanceSymbol, 5), 5);
+			writer.write((uint32_t)(bestDistance - FixedHuffman::distanceBase[distanceSymbol]), FixedHuffman::distanceExtra[distanceSymbol]);
+			position += bestLength;
+		}
+		else {
+			writer.write(huffman.literalCode[data[position]], huffman.literalLength[data[position]]);
+			position++;
+		}
+	}
+	writer.write(huffman.literalCode[256], huffman.literalLength[256]);
+	writer.flush();
+	appendBigEndian(bytes, adler32(data, size));
+}
+
+/** \brief Appends a PNG chunk with its length and CRC.
+*/
+static void appendPngChunk(vector<uint8_t>* bytes, const char* type, const vector<uint8_t>& data) {
+	appendBigEndian(bytes, (uint32_t)data.size());
+	size_t start = bytes->size();
+	bytes->insert(bytes->end(), type, type + 4);
+	bytes->insert(bytes->end(), data.begin(), data.end());
+	appendBigEndian(bytes, crc32(&(*bytes)[start], bytes->size() - start, 0));
+}
+
+/** \brief Appends one GIF image of palette indexes 0 to 3, compressed with LZW.
+
+Codes start at 3 bits and grow up to 12 bits, when the dictionary is full a clear code starts a new one.
+\param pixels - palette indexes, row after row
+\param bytes - image data is appended to it in blocks of at most 255 bytes
+*/
+static void appendGifImage(const vector<uint8_t>& pixels, vector<uint8_t>* bytes) {
+	const int minimumCodeSize = 2;
+	const int clearCode = 1 << minimumCodeSize;
+	const int endCode = clearCode + 1;
+	vector<uint16_t> children(4096 * 4, 0); //code of prefix followed by a pixel, 0 if it isn't in the dictionary
+	vector<uint8_t> data;
+	BitWriter writer(&data);
+	int codeSize = minimumCodeSize + 1;
+	int lastCode = endCode;
+	writer.write(clearCode, codeSize);
+	int prefix = pixels.empty() ? -1 : pixels[0];
+	for (size_t i = 1; i < pixels.size(); i++) {
+		int pixel = pixels[i];
+		int child = children[prefix * 4 + pixel];
+		if (child != 0) {
+			prefix = child;
+			continue;
+		}
+		writer.write(prefix, codeSize);
+		lastCode++;
+		children[prefix * 4 + pixel] = (uint16_t)lastCode;
+		if (lastCode >= (1 << codeSize)) codeSize++;
+		if (lastCode == 4095) {
+			writer.write(clearCode, codeSize);
+			fill(children.begin(), children.end(), 0);
+			codeSize = minimumCodeSize + 1;
+			lastCode = endCode;
+		}
+		prefix = pixel;
+	}
+	if (prefix >= 0) writer.write(prefix, codeSize);
+	writer.write(endCode, codeSize);
+	writer.flush();
+	bytes->push_back(minimumCodeSize);
+	for (size_t start = 0; start < data.size(); start += 255) {
+		size_t block = min((size_t)255, data.size() - start);
+		bytes->push_back((uint8_t)block);
+		bytes->insert(bytes->end(), data.begin() + start, data.begin() + start + block);
+	}
+	bytes->push_back(0);
+}
+
+/** \brief Class constructor, starts the worker threads.
+
+\param path - output file, for PNG the frame number is added before the extension
+\param format - format of the output
+\param scale - size of a cell side in pixels
+\param framesPerSecond - frame rate of the Y4M and GIF outputs
+\param threads - number of worker threads
+\param queueSize - number of frames that can wait for a worker before addFrame waits
+*/
+FrameExporter::FrameExporter(const string& path, ExportFormat format, int scale, int framesPerSecond, int threads, int queueSize) {
+	this->path = path;
+	this->format = format;
+	this->scale = max(1, scale);
+	this->framesPerSecond = max(1, framesPerSecond);
+	this->queueSize = max(1, queueSize);
+	this->width = 0;
+	this->height = 0;
+	this->wordsPerRow = 0;
+	this->file = NULL;
+	this->added = 0;
+	this->nextWritten = 0;
+	this->isWritingFile = false;
+	this->isStopping = false;
+	this->isFailed = format == EXPORT_UNKNOWN;
+	this->busyWorkers = 0;
+	this->written = 0;
+	this->stalls = 0;
+	this->stallSeconds = 0;
+	for (int i = 0; i < max(1, threads); i++) {
+		workers.push_back(thread(&FrameExporter::workerLoop, this));
+	}
+}
+
+/** \brief Class destructor.
+
+Writes the waiting frames, closes the output and stops the worker threads.
+*/
+FrameExporter::~FrameExporter() {
+	finish();
+	{
+		lock_guard<mutex> guard(lock);
+		isStopping = true;
+	}
+	wake.notify_all();
+	for (thread& worker : workers) {
+		worker.join();
+	}
+}
+
+/** \brief Opens the Y4M or GIF output and writes its header, called with the first frame.
+
+\return false if the file can't be created or the image is too big for the format
+*/
+bool FrameExporter::openFile() {
+	int pixelWidth = width * scale;
+	int pixelHeight = height * scale;
+	if (format == EXPORT_PNG) {
+		return true;
+	}
+	if (format == EXPORT_GIF && (pixelWidth > 65535 || pixelHeight > 65535)) {
+		return false;
+	}
+	file = fopen(path.c_str(), "wb");
+	if (file == NULL) {
+		return false;
+	}
+	vector<uint8_t> header;
+	if (format == EXPORT_Y4M) {
+		string text = "YUV4MPEG2 W" + to_string(pixelWidth) + " H" + to_string(pixelHeight) + " F" + to_string(framesPerSecond) + ":1 Ip A1:1 C420jpeg\n";
+		header.assign(text.begin(), text.end());
+	}
+	else {
+		const char* signature = "GIF89a";
+		header.assign(signature, signature + 6);
+		appendLittleEndian16(&header, pixelWidth);
+		appendLittleEndian16(&header, pixelHeight);
+		header.push_back(0xF1); //global palette of 4 colors
+		header.push_back(0);
+		header.push_back(0);
+		for (uint32_t color : PALETTE) {
+			header.push_back((uint8_t)(color >> 16));
+			header.push_back((uint8_t)(color >> 8));
+			header.push_back((uint8_t)color);
+		}
+		const char* loop = "\x21\xFF\x0BNETSCAPE2.0\x03\x01\x00\x00\x00"; //repeat forever
+		header.insert(header.end(), loop, loop + 19);
+	}
+	return fwrite(header.data(), 1, header.size(), file) == header.size();
+}
+
+/** \brief Copies the board of an engine and hands it to the workers.
+
+Waits only if queueSize frames are already waiting. The first frame sets the size of the output, frames of other sizes are rejected.
+\param engine - engine with the board
+\return false if the output can't be written or the board has another size than the first frame
+*/
+bool FrameExporter::addFrame(LifeEngine* engine) {
+	ExportFrame frame;
+	int frameWordsPerRow = (engine->getWidth() + 63) / 64;
+	frame.words.assign((size_t)engine->getHeight() * frameWordsPerRow, 0);
+	DenseEngine* dense = dynamic_cast<DenseEngine*>(engine);
+	if (dense != NULL) {
+		for (int y = 0; y < engine->getHeight(); y++) {
+			memcpy(&frame.words[(size_t)y * frameWordsPerRow], dense->getRow(y), frameWordsPerRow * sizeof(uint64_t));
+		}
+	}
+	else {
+		engine->forEachAlive([&](int x, int y) {
+			frame.words[(size_t)y * frameWordsPerRow + x / 64] |= (uint64_t)1 << (x % 64);
+		});
+	}
+	unique_lock<mutex> guard(lock);
+	if (added == 0 && !isFailed) {
+		width = engine->getWidth();
+		height = engine->getHeight();
+		wordsPerRow = frameWordsPerRow;
+		isFailed = width <= 0 || height <= 0 || !openFile();
+	}
+	if (isFailed || width != engine->getWidth() || height != engine->getHeight()) {
+		return false;
+	}
+	if ((int)queue.size() >= queueSize) {
+		stalls++;
+		auto begin = chrono::steady_clock::now();
+		space.wait(guard, [&] { return (int)queue.size() < queueSize; });
+		stallSeconds += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	}
+	frame.number = added++;
+	queue.push_back(move(frame));
+	wake.notify_one();
+	return true;
+}
+
+/** \brief Waits until every added frame is written and closes the output.
+
+\return false if a frame could not be written
+*/
+bool FrameExporter::finish() {
+	unique_lock<mutex> guard(lock);
+	idle.wait(guard, [&] { return queue.empty() && busyWorkers == 0; });
+	if (file != NULL) {
+		if (format == EXPORT_GIF && fputc(0x3B, file) == EOF) isFailed = true; //trailer
+		if (fclose(file) != 0) isFailed = true;
+		file = NULL;
+	}
+	return !isFailed;
+}
+
+/** \brief Main function of a worker thread.
+
+Takes frames from the queue until the exporter is destroyed, pixels and encoded bytes are kept between frames so they are allocated once.
+*/
+void FrameExporter::workerLoop() {
+	vector<uint8_t> pixels;
+	vector<uint8_t> bytes;
+	unique_lock<mutex> guard(lock);
+	while (true) {
+		wake.wait(guard, [&] { return isStopping || !queue.empty(); });
+		if (queue.empty()) return;
+		ExportFrame frame = move(queue.front());
+		queue.pop_front();
+		busyWorkers++;
+		space.notify_one();
+		guard.unlock();
+		rasterize(frame, &pixels);
+		encode(pixels, &bytes);
+		if (format == EXPORT_PNG) {
+			FILE* frameFile = fopen(framePath(path, frame.number).c_str(), "wb");
+			bool isWritten = frameFile != NULL && fwrite(bytes.data(), 1, bytes.size(), frameFile) == bytes.size();
+			if (frameFile != NULL) isWritten = fclose(frameFile) == 0 && isWritten;
+			guard.lock();
+			if (isWritten) written++;
+			else isFailed = true;
+		}
+		else {
+			guard.lock();
+			writeInOrder(guard, frame.number, &bytes);
+		}
+		busyWorkers--;
+		idle.notify_all();
+	}
+}
+
+/** \brief Draws a frame as palette indexes, one byte per pixel.
+
+Only the outline row and one inner row of a board row are drawn, the other pixel rows are copies. Words of 64 dead or 64 alive cells are copied from a prepared run of pixels.
+\param frame - board rows
+\param pixels - image, width * scale columns and height * scale rows
+*/
+void FrameExporter::rasterize(const ExportFrame& frame, vector<uint8_t>* pixels) {
+	size_t pixelWidth = (size_t)width * scale;
+	pixels->resize(pixelWidth * height * scale);
+	vector<uint8_t> runs[2][2]; //pixels of 64 cells in the outline row and in an inner row, dead and alive
+	for (int isInner = 0; isInner < 2; isInner++) {
+		for (int isAlive = 0; isAlive < 2; isAlive++) {
+			runs[isInner][isAlive].resize((size_t)64 * scale);
+			for (int i = 0; i < 64 * scale; i++) {
+				bool isOutline = scale >= FrameBuffer::GRID_MIN_SCALE && (!isInner || i % scale == 0 || i % scale == scale - 1);
+				runs[isInner][isAlive][i] = (uint8_t)(isAlive * 2 + isOutline);
+			}
+		}
+	}
+	int drawnRows = scale > 2 ? 2 : 1;
+	for (int y = 0; y < height; y++) {
+		const uint64_t* row = &frame.words[(size_t)y * wordsPerRow];
+		uint8_t* top = &(*pixels)[(size_t)y * scale * pixelWidth];
+		for (int isInner = 0; isInner < drawnRows; isInner++) {
+			uint8_t* out = top + isInner * pixelWidth;
+			for (int i = 0; i < wordsPerRow; i++) {
+				uint64_t word = row[i];
+				int cells = min(64, width - 64 * i);
+				uint8_t* cell = out + (size_t)64 * i * scale;
+				if (cells == 64 && (word == 0 || word == ~(uint64_t)0)) {
+					memcpy(cell, runs[isInner][word != 0].data(), (size_t)64 * scale);
+					continue;
+				}
+				for (int c = 0; c < cells; c++) {
+					memcpy(cell + c * scale, runs[isInner][(word >> c) & 1].data(), scale);
+				}
+			}
+		}
+		for (int r = drawnRows; r < scale; r++) {
+			memcpy(top + r * pixelWidth, r == scale - 1 ? top : top + pixelWidth, pixelWidth);
+		}
+	}
+}
+
+/** \brief Encodes a rasterized frame in the format of the output.
+
+Y4M frames are 4:2:0 with BT.601 colors, chroma is taken from the top left pixel of every 2x2 block. PNG frames are complete files. GIF frames are a graphic control block with the delay and an image with the global palette.
+\param pixels - palette indexes from rasterize
+\param bytes - encoded frame
+*/
+void FrameExporter::encode(const vector<uint8_t>& pixels, vector<uint8_t>* bytes) {
+	int pixelWidth = width * scale;
+	int pixelHeight = height * scale;
+	bytes->clear();
+	if (format == EXPORT_Y4M) {
+		uint8_t luma[4], blue[4], red[4];
+		for (int i = 0; i < 4; i++) {
+			int r = (PALETTE[i] >> 16) & 0xFF, g = (PALETTE[i] >> 8) & 0xFF, b = PALETTE[i] & 0xFF;
+			luma[i] = (uint8_t)(16 + ((66 * r + 129 * g + 25 * b + 128) >> 8));
+			blue[i] = (uint8_t)((-38 * r - 74 * g + 112 * b + 32896) >> 8);
+			red[i] = (uint8_t)((112 * r - 94 * g - 18 * b + 32896) >> 8);
+		}
+		int chromaWidth = (pixelWidth + 1) / 2, chromaHeight = (pixelHeight + 1) / 2;
+		const char* marker = "FRAME\n";
+		bytes->assign(marker, marker + 6);
+		size_t start = bytes->size();
+		bytes->resize(start + pixels.size() + (size_t)2 * chromaWidth * chromaHeight);
+		uint8_t* out = &(*bytes)[start];
+		for (size_t i = 0; i < pixels.size(); i++) out[i] = luma[pixels[i]];
+		uint8_t* blueOut = out + pixels.size();
+		uint8_t* redOut = blueOut + (size_t)chromaWidth * chromaHeight;
+		for (int y = 0; y < chromaHeight; y++) {
+			const uint8_t* row = &pixels[(size_t)y * 2 * pixelWidth];
+			for (int x = 0; x < chromaWidth; x++) {
+				*blueOut++ = blue[row[x * 2]];
+				*redOut++ = red[row[x * 2]];
+			}
+		}
+	}
+	else if (format == EXPORT_PNG) {
+		vector<uint8_t> scanlines((size_t)(pixelWidth + 1) * pixelHeight);
+		for (int y = 0; y < pixelHeight; y++) {
+			scanlines[(size_t)y * (pixelWidth + 1)] = 0; //no filter
+			memcpy(&scanlines[(size_t)y * (pixelWidth + 1) + 1], &pixels[(size_t)y * pixelWidth], pixelWidth);
+		}
+		const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		bytes->assign(signature, signature + 8);
+		vector<uint8_t> chunk;
+		appendBigEndian(&chunk, pixelWidth);
+		appendBigEndian(&chunk, pixelHeight);
+		const uint8_t imageType[5] = { 8, 3, 0, 0, 0 }; //8 bit palette indexes, deflate, no interlace
+		chunk.insert(chunk.end(), imageType, imageType + 5);
+		appendPngChunk(bytes, "IHDR", chunk);
+		chunk.clear();
+		for (uint32_t color : PALETTE) {
+			chunk.push_back((uint8_t)(color >> 16));
+			chunk.push_back((uint8_t)(color >> 8));
+			chunk.push_back((uint8_t)color);
+		}
+		appendPngChunk(bytes, "PLTE", chunk);
+		chunk.clear();
+		zlibCompress(scanlines.data(), scanlines.size(), pixelWidth + 1, &chunk);
+		appendPngChunk(bytes, "IDAT", chunk);
+		appendPngChunk(bytes, "IEND", vector<uint8_t>());
+	}
+	else if (format == EXPORT_GIF) {
+		int delay = max(2, (100 + framesPerSecond / 2) / framesPerSecond); //centiseconds, viewers slow down shorter delays
+		const uint8_t control[4] = { 0x21, 0xF9, 0x04, 0x00 };
+		bytes->assign(control, control + 4);
+		appendLittleEndian16(bytes, delay);
+		bytes->push_back(0);
+		bytes->push_back(0);
+		bytes->push_back(0x2C);
+		appendLittleEndian16(bytes, 0);
+		appendLittleEndian16(bytes, 0);
+		appendLittleEndian16(bytes, pixelWidth);
+		appendLittleEndian16(bytes, pixelHeight);
+		bytes->push_back(0);
+		appendGifImage(pixels, bytes);
+	}
+}
+
+/** \brief Appends encoded frames to the Y4M or GIF output in the order they were added.
+
+Called by a worker with the lock held. The frame waits in encoded until the frames before it are written, the worker that finds no other worker writing writes every frame that is ready, the lock is released during fwrite.
+\param guard - lock of the exporter, held by the caller
+\param number - number of the frame
+\param bytes - encoded frame, swapped with an empty vector
+*/
+void FrameExporter::writeInOrder(unique_lock<mutex>& guard, long long number, vector<uint8_t>* bytes) {
+	encoded[number].swap(*bytes);
+	if (isWritingFile) {
+		return;
+	}
+	isWritingFile = true;
+	vector<uint8_t> next;
+	for (map<long long, vector<uint8_t> >::iterator it = encoded.find(nextWritten); it != encoded.end(); it = encoded.find(nextWritten)) {
+		next.swap(it->second);
+		encoded.erase(it);
+		guard.unlock();
+		bool isWritten = fwrite(next.data(), 1, next.size(), file) == next.size();
+		guard.lock();
+		if (isWritten) written++;
+		else isFailed = true;
+		nextWritten++;
+	}
+	isWritingFile = false;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "LifeEngine.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+/** \brief File format of exported frames. */
+enum ExportFormat {
+	EXPORT_UNKNOWN,
+	EXPORT_Y4M, /**< One YUV4MPEG2 video, uncompressed 4:2:0 frames read by ffmpeg and most players. */
+	EXPORT_PNG, /**< One indexed PNG file for every frame, the frame number is added before the extension. */
+	EXPORT_GIF /**< One looping animated GIF. */
+};
+
+/** \brief Board copied from an engine, waiting to be rasterized. */
+struct ExportFrame {
+	long long number; /**< Position of the frame in the output, from 0. */
+	vector<uint64_t> words; /**< Rows of the board, bit i of word j is the cell in column 64 * j + i. */
+};
+
+ExportFormat exportFormat(const string&);
+
+class FrameExporter {
+private:
+	string path;
+	ExportFormat format;
+	int scale;
+	int framesPerSecond;
+	int queueSize; /**< Frames waiting for a worker, addFrame waits when the queue is full. */
+	int width, height, wordsPerRow; /**< Board size, set by the first frame. */
+	FILE* file; /**< Y4M or GIF output, NULL for PNG and after finish. */
+	deque<ExportFrame> queue;
+	map<long long, vector<uint8_t> > encoded; /**< Encoded frames waiting for the frames before them, Y4M and GIF only. */
+	long long added;
+	long long nextWritten; /**< Number of the next frame written to the file. */
+	bool isWritingFile;
+	bool isStopping;
+	bool isFailed;
+	int busyWorkers;
+	long long written;
+	long long stalls;
+	double stallSeconds;
+	mutex lock;
+	condition_variable wake;
+	condition_variable space;
+	condition_variable idle;
+	vector<thread> workers;
+
+	bool openFile();
+	void workerLoop();
+	void rasterize(const ExportFrame&, vector<uint8_t>*);
+	void encode(const vector<uint8_t>&, vector<uint8_t>*);
+	void writeInOrder(unique_lock<mutex>&, long long, vector<uint8_t>*);
+
+public:
+	FrameExporter(const string&, ExportFormat, int, int, int, int);
+	~FrameExporter();
+	bool addFrame(LifeEngine*);
+	bool finish();
+	/** \brief Returns number of frames written to the output.
+	*/
+	long long getWrittenCount() {
+		lock_guard<mutex> guard(lock);
+		return written;
+	}
+	/** \brief Returns number of addFrame calls that waited for a full queue.
+	*/
+	long long getStallCount() {
+		lock_guard<mutex> guard(lock);
+		return stalls;
+	}
+	/** \brief Returns time addFrame spent waiting for a full queue.
+	*/
+	double getStallSeconds() {
+		lock_guard<mutex> guard(lock);
+		return stallSeconds;
+	}
+};
@@ -0,0 +1,129 @@
+#include "GenerationStats.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <climits>
+#include <string>
+#include <vector>
+using namespace std;
+/** \class StatsWriter
+	\brief Buffered writer of per-generation statistics.
+
+	Records are formatted with snprintf straight into a 64 KB buffer, which is written to the file only when it's almost full, so a generation costs one formatting call and no system call. Format is chosen by the file extension, .csv for CSV, anything else for JSON lines.
+	Writer is fed by the engine from the simulation thread, only setRenderSeconds may be called from another thread.
+*/
+/** \brief Class constructor, writer is closed.
+*/
+StatsWriter::StatsWriter() {
+	this->file = NULL;
+	this->format = STATS_CSV;
+	this->used = 0;
+	this->records = 0;
+	this->renderSeconds = 0;
+}
+
+/** \brief Class destructor, writes the buffer and closes the file.
+*/
+StatsWriter::~StatsWriter() {
+	close();
+}
+
+/** \brief Opens the file, CSV files get a header line.
+
+\param path - path to a .csv or .jsonl file, existing file is replaced
+\return true if the file was opened
+*/
+bool StatsWriter::open(const string& path) {
+	close();
+	file = fopen(path.c_str(), "wb");
+	if (file == NULL) {
+		return false;
+	}
+	format = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0 ? STATS_CSV : STATS_JSONL;
+	buffer.resize(BUFFER_SIZE);
+	used = 0;
+	records = 0;
+	if (format == STATS_CSV) {
+		used = snprintf(&buffer[0], BUFFER_SIZE, "generation,population,births,deaths,active,min_x,min_y,max_x,max_y,neighbors_s,update_s,swap_s,render_s\n");
+	}
+	return true;
+}
+
+/** \brief Adds statistics of one generation.
+
+\param stats - statistics of the generation
+*/
+void StatsWriter::write(const GenerationStats& stats) {
+	if (file == NULL) {
+		return;
+	}
+	if (BUFFER_SIZE - used < RECORD_SIZE) {
+		flush();
+	}
+	double render = renderSeconds.load(memory_order_relaxed);
+	const char* pattern = format == STATS_CSV ? "%lld,%lld,%lld,%lld,%lld,%d,%d,%d,%d,%.9f,%.9f,%.9f,%.9f\n"
+		: "{\"generation\":%lld,\"population\":%lld,\"births\":%lld,\"deaths\":%lld,\"active\":%lld,\"min_x\":%d,\"min_y\":%d,\"max_x\":%d,\"max_y\":%d,"
+		"\"neighbors_s\":%.9f,\"update_s\":%.9f,\"swap_s\":%.9f,\"render_s\":%.9f}\n";
+	int length = snprintf(&buffer[used], BUFFER_SIZE - used, pattern, stats.generation, stats.population, stats.births, stats.deaths, stats.activeCells,
+		stats.minX, stats.minY, stats.maxX, stats.maxY, stats.phaseSeconds[PHASE_NEIGHBORS], stats.phaseSeconds[PHASE_UPDATE], stats.phaseSeconds[PHASE_SWAP], render);
+	if (length > 0) used += min((size_t)length, BUFFER_SIZE - used - 1);
+	records++;
+}
+
+/** \brief Writes the buffer to the file.
+*/
+void StatsWriter::flush() {
+	if (file == NULL) {
+		return;
+	}
+	if (used > 0) fwrite(&buffer[0], 1, used, file);
+	used = 0;
+	fflush(file);
+}
+
+/** \brief Writes the buffer and closes the file.
+*/
+void StatsWriter::close() {
+	if (file == NULL) {
+		return;
+	}
+	flush();
+	fclose(file);
+	file = NULL;
+}
+
+/** \brief Clears statistics before a generation is collected.
+
+\param stats - statistics to clear
+\param generation - generation the statistics are for
+*/
+void resetStats(GenerationStats* stats, long long generation) {
+	stats->generation = generation;
+	stats->population = 0;
+	stats->births = 0;
+	stats->deaths = 0;
+	stats->activeCells = 0;
+	stats->minX = INT_MAX;
+	stats->minY = INT_MAX;
+	stats->maxX = INT_MIN;
+	stats->maxY = INT_MIN;
+	for (int i = 0; i < PHASE_COUNT; i++) {
+		stats->phaseSeconds[i] = 0;
+	}
+}
+
+/** \brief Adds counts and bounding box of a part of the board, e.g. a band computed by another thread.
+
+\param stats - statistics of the whole board
+\param part - statistics of the part
+*/
+void mergeStats(GenerationStats* stats, const GenerationStats& part) {
+	stats->population += part.population;
+	stats->births += part.births;
+	stats->deaths += part.deaths;
+	stats->activeCells += part.activeCells;
+	stats->minX = min(stats->minX, part.minX);
+	stats->minY = min(stats->minY, part.minY);
+	stats->maxX = max(stats->maxX, part.maxX);
+	stats->maxY = max(stats->maxY, part.maxY);
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <string>
+#include <vector>
+using namespace std;
+
+/** \brief Statistics code is compiled only with -DCONWAY_STATS, otherwise STATS(...) expands to nothing and engines don't collect anything. */
+#ifdef CONWAY_STATS
+#define STATS(...) __VA_ARGS__
+#else
+#define STATS(...)
+#endif
+
+/** \brief Phase of a generation. */
+enum StatsPhase {
+	PHASE_NEIGHBORS, /**< Counting neighbors, DenseEngine counts neighbors and applies the rule in one step kernel. */
+	PHASE_UPDATE, /**< Writing next states to the board(updateMainMatrix of SparseEngine). */
+	PHASE_SWAP, /**< Swapping buffers, including the active set of SparseEngine and board edges of DenseEngine. */
+	PHASE_RENDER, /**< Latest frame drawn by the screen. */
+	PHASE_COUNT
+};
+
+/** \brief Statistics of one generation. */
+struct GenerationStats {
+	long long generation;
+	long long population;
+	long long births;
+	long long deaths;
+	long long activeCells; /**< Cells computed in the generation. */
+	int minX, minY, maxX, maxY; /**< Bounding box of alive cells, empty if minX > maxX. */
+	double phaseSeconds[PHASE_COUNT];
+};
+
+/** \brief File format of statistics. */
+enum StatsFormat {
+	STATS_CSV, /**< Header line and one line of comma separated values for every generation. */
+	STATS_JSONL /**< One JSON object on every line. */
+};
+
+class StatsWriter {
+private:
+	static const size_t BUFFER_SIZE = 1 << 16;
+	static const size_t RECORD_SIZE = 512; /**< Longest formatted record. */
+
+	FILE* file;
+	StatsFormat format;
+	vector<char> buffer;
+	size_t used;
+	long long records;
+	atomic<double> renderSeconds;
+
+public:
+	StatsWriter();
+	~StatsWriter();
+	bool open(const string&);
+	void write(const GenerationStats&);
+	void flush();
+	void close();
+	/** \brief Sets time of the latest frame, can be called from the render thread.
+	*/
+	void setRenderSeconds(double seconds) {
+		renderSeconds.store(seconds, memory_order_relaxed);
+	}
+	/** \brief Returns number of written generations.
+	*/
+	long long getRecordCount() {
+		return records;
+	}
+};
+
+void resetStats(GenerationStats*, long long);
+void mergeStats(GenerationStats*, const GenerationStats&);
@@ -0,0 +1,322 @@
+#include "GenerationsEngine.h"
+#include "DenseEngine.h"
+#include "LifeKernel.h"
+#include "ThreadPool.h"
+#include <stdint.h>
+#include <algorithm>
+#include <functional>
+#include <vector>
+using namespace std;
+/** \class GenerationsEngine
+	\brief Bit-packed engine for Generations rules(B/S/C), cells have states from 0(dead) through 1(alive) to states - 1(dying).
+
+	Only alive cells are counted as neighbors, so the alive cells are kept in a DenseEngine with the B/S part of the rule and neighbors are counted by its step kernels, on its threads and with its topologies. States are stored as 2 bit planes for rules with up to 4 states or 4 bit planes for up to 16 states, bit b of the state of a cell is bit b of plane b, so the state of a cell costs 2 or 4 bits instead of the 16 bytes of a Cell.
+	After the DenseEngine step a word of every plane is updated at once: cells that are alive in the step result and weren't dying become state 1, every other cell that isn't dead is incremented with a carry chain across the planes and cells that reach the number of states become dead. These are plain word operations on consecutive words, so the compiler vectorizes them.
+	Rules with 2 states behave like DenseEngine.
+*/
+/** \brief Class default constructor.
+
+	Creates empty engine, board has to be set with resize.
+*/
+GenerationsEngine::GenerationsEngine() {
+	this->bits = 2;
+	this->wordsPerRow = 0;
+	this->planeSize = 0;
+	this->threadCount = 1;
+}
+
+/** \brief Class constructor with board parameters.
+
+\param width - number of columns of the board
+\param height - number of rows of the board
+\param rule - rule of the game, number of states is taken from it
+*/
+GenerationsEngine::GenerationsEngine(int width, int height, const LifeRule& rule) {
+	this->rule = rule;
+	this->bits = bitsForStates(rule.getStates());
+	this->threadCount = 1;
+	this->resize(width, height);
+}
+
+/** \brief Returns number of bit planes needed for a number of states.
+*/
+int GenerationsEngine::bitsForStates(int states) {
+	return states <= 4 ? 2 : 4;
+}
+
+/** \brief Changes number of bit planes, used when the rule changes.
+
+Cells with states that don't fit into fewer planes become dead.
+\param bits - new number of planes, 2 or 4
+*/
+void GenerationsEngine::setBits(int bits) {
+	if (bits == this->bits) {
+		return;
+	}
+	if (bits < this->bits) {
+		for (size_t i = 0; i < planeSize; i++) {
+			uint64_t lost = 0;
+			for (int b = bits; b < this->bits; b++) lost |= planes[b * planeSize + i];
+			for (int b = 0; b < bits; b++) planes[b * planeSize + i] &= ~lost;
+		}
+	}
+	planes.resize(bits * planeSize, 0);
+	this->bits = bits;
+}
+
+/** \brief Creates a new dead board.
+
+\param width - number of columns of the board
+\param height - number of rows of the board
+*/
+void GenerationsEngine::resize(int width, int height) {
+	this->width = width;
+	this->height = height;
+	live.setRule(rule.getIsTotalistic() ? LifeRule(rule.getBirth(), rule.getSurvival()) : rule);
+	live.resize(width, height);
+	wordsPerRow = live.getWordsPerRow();
+	planeSize = (size_t)height * wordsPerRow;
+	planes.assign(bits * planeSize, 0);
+	nextLive.assign(planeSize, 0);
+	generation = 0;
+}
+
+/** \brief Kills every cell and resets the generation counter.
+*/
+void GenerationsEngine::clear() {
+	live.clear();
+	fill(planes.begin(), planes.end(), 0);
+	generation = 0;
+}
+
+/** \brief Sets a cell alive or dead.
+
+\param x - column of the cell
+\param y - row of the cell
+\param alive - true for state 1, false for state 0
+*/
+void GenerationsEngine::setCell(int x, int y, bool alive) {
+	setState(x, y, alive ? 1 : 0);
+}
+
+/** \brief Returns true if a cell is alive, dying cells are not alive.
+
+\param x - column of the cell
+\param y - row of the cell
+*/
+bool GenerationsEngine::getCell(int x, int y) {
+	return getState(x, y) == 1;
+}
+
+/** \brief Sets state of a cell.
+
+Cells outside the board, cells on the dead frame(TOPOLOGY_FRAME) and states the rule doesn't have are ignored.
+\param x - column of the cell
+\param y - row of the cell
+\param state - 0 for dead, 1 for alive, from 2 to states - 1 for dying
+*/
+void GenerationsEngine::setState(int x, int y, int state) {
+	int frame = topology == TOPOLOGY_FRAME ? 1 : 0;
+	if (x < frame || y < frame || x > width - 1 - frame || y > height - 1 - frame || state < 0 || state >= rule.getStates()) {
+		return;
+	}
+	setBits(bitsForStates(rule.getStates()));
+	size_t index = (size_t)y * wordsPerRow + x / 64;
+	uint64_t bit = (uint64_t)1 << (x % 64);
+	for (int b = 0; b < bits; b++) {
+		if ((state >> b) & 1) planes[b * planeSize + index] |= bit;
+		else planes[b * planeSize + index] &= ~bit;
+	}
+	live.setCell(x, y, state == 1);
+}
+
+/** \brief Returns state of a cell.
+
+\param x - column of the cell
+\param y - row of the cell
+\return 0 for dead cells and cells outside the board, 1 for alive cells, 2 or more for dying cells
+*/
+int GenerationsEngine::getState(int x, int y) {
+	if (x < 0 || y < 0 || x >= width || y >= height) {
+		return 0;
+	}
+	size_t index = (size_t)y * wordsPerRow + x / 64;
+	int state = 0;
+	for (int b = 0; b < bits; b++) {
+		state |= (int)((planes[b * planeSize + index] >> (x % 64)) & 1) << b;
+	}
+	return state;
+}
+
+/** \brief Updates states of consecutive words stored in 2 bit planes after the alive cells were stepped.
+
+Every plane is a separate local, so the loop stays in registers and is vectorized.
+\param planes - first word in plane 0, plane 1 starts planeSize words later
+\param planeSize - words of one plane
+\param stepped - alive cells computed by DenseEngine from the previous alive cells
+\param nextLive - alive cells of the next generation
+\param count - number of words
+\param states - number of states of the rule, from 2 to 4
+*/
+static void ageWords2(uint64_t* planes, size_t planeSize, const uint64_t* stepped, uint64_t* nextLive, int count, int states) {
+	uint64_t* plane0 = planes;
+	uint64_t* plane1 = planes + planeSize;
+	uint64_t flip0 = states & 1 ? 0 : ~(uint64_t)0;
+	uint64_t flip1 = states & 2 ? 0 : ~(uint64_t)0;
+	uint64_t canWrap = states < 4 ? ~(uint64_t)0 : 0;
+	for (int i = 0; i < count; i++) {
+		uint64_t p0 = plane0[i], p1 = plane1[i];
+		//states from 2 up have a bit set above plane 0
+		uint64_t alive = stepped[i] & ~p1;
+		//increment every cell that isn't dead, alive cells that survive are set to 1 below
+		uint64_t carry = p0 | p1;
+		uint64_t next = p0 & carry;
+		p0 ^= carry;
+		p1 ^= next;
+		//cells that reached the number of states die, with 4 states the carry already wrapped them to 0
+		uint64_t isLast = (p0 ^ flip0) & (p1 ^ flip1) & canWrap;
+		plane0[i] = (p0 & ~isLast) | alive;
+		plane1[i] = p1 & ~isLast & ~alive;
+		nextLive[i] = alive;
+	}
+}
+
+/** \brief Updates states of consecutive words stored in 4 bit planes after the alive cells were stepped.
+
+\param planes - first word in plane 0, plane b starts b * planeSize words later
+\param planeSize - words of one plane
+\param stepped - alive cells computed by DenseEngine from the previous alive cells
+\param nextLive - alive cells of the next generation
+\param count - number of words
+\param states - number of states of the rule, from 2 to 16
+*/
+static void ageWords4(uint64_t* planes, size_t planeSize, const uint64_t* stepped, uint64_t* nextLive, int count, int states) {
+	uint64_t* plane0 = planes;
+	uint64_t* plane1 = planes + planeSize;
+	uint64_t* plane2 = planes + 2 * planeSize;
+	uint64_t* plane3 = planes + 3 * planeSize;
+	uint64_t flip0 = states & 1 ? 0 : ~(uint64_t)0;
+	uint64_t flip1 = states & 2 ? 0 : ~(uint64_t)0;
+	uint64_t flip2 = states & 4 ? 0 : ~(uint64_t)0;
+	uint64_t flip3 = states & 8 ? 0 : ~(uint64_t)0;
+	uint64_t canWrap = states < 16 ? ~(uint64_t)0 : 0;
+	for (int i = 0; i < count; i++) {
+		uint64_t p0 = plane0[i], p1 = plane1[i], p2 = plane2[i], p3 = plane3[i];
+		uint64_t upper = p1 | p2 | p3;
+		uint64_t alive = stepped[i] & ~upper;
+		uint64_t carry = p0 | upper;
+		uint64_t next = p0 & carry;
+		p0 ^= carry;
+		carry = p1 & next;
+		p1 ^= next;
+		next = p2 & carry;
+		p2 ^= carry;
+		p3 ^= next;
+		uint64_t isLast = (p0 ^ flip0) & (p1 ^ flip1) & (p2 ^ flip2) & (p3 ^ flip3) & canWrap;
+		plane0[i] = (p0 & ~isLast) | alive;
+		plane1[i] = p1 & ~isLast & ~alive;
+		plane2[i] = p2 & ~isLast & ~alive;
+		plane3[i] = p3 & ~isLast & ~alive;
+		nextLive[i] = alive;
+	}
+}
+
+/** \brief Computes next generations.
+
+Alive cells are stepped by DenseEngine, then bands of rows are aged on all threads and the alive cells of the next generation are written back to DenseEngine.
+\param generations - number of generations to compute
+*/
+void GenerationsEngine::step(int generations) {
+	//non-totalistic rules have no dying states, so they are used as they are
+	LifeRule liveRule = rule.getIsTotalistic() ? LifeRule(rule.getBirth(), rule.getSurvival()) : rule;
+	if (live.getRule() != liveRule) live.setRule(liveRule);
+	setBits(bitsForStates(rule.getStates()));
+	int states = rule.getStates();
+	int bandCount = pool ? min(height, threadCount * 4) : 1;
+	function<void(int)> ageBand = [&](int band) {
+		for (int y = height * band / bandCount; y < height * (band + 1) / bandCount; y++) {
+			size_t row = (size_t)y * wordsPerRow;
+			if (bits == 2) ageWords2(&planes[row], planeSize, live.getRow(y), &nextLive[row], wordsPerRow, states);
+			else ageWords4(&planes[row], planeSize, live.getRow(y), &nextLive[row], wordsPerRow, states);
+		}
+	};
+	for (int g = 0; g < generations && height > 0; g++) {
+		live.step(1);
+		if (pool) pool->parallelFor(bandCount, ageBand);
+		else ageBand(0);
+		for (int y = 0; y < height; y++) {
+			live.setRow(y, &nextLive[(size_t)y * wordsPerRow]);
+		}
+		generation++;
+	}
+}
+
+/** \brief Returns number of alive cells, dying cells are not counted.
+*/
+long long GenerationsEngine::population() {
+	return live.population();
+}
+
+/** \brief Calls a function for every alive cell.
+
+\param callback - function called with x and y of every cell in state 1
+*/
+void GenerationsEngine::forEachAlive(const function<void(int, int)>& callback) {
+	live.forEachAlive(callback);
+}
+
+/** \brief Calls a function for every cell that isn't dead.
+
+\param callback - function called with x, y and state of every alive or dying cell
+*/
+void GenerationsEngine::forEachState(const function<void(int, int, int)>& callback) {
+	for (int y = 0; y < height; y++) {
+		for (int i = 0; i < wordsPerRow; i++) {
+			size_t index = (size_t)y * wordsPerRow + i;
+			uint64_t word = 0;
+			for (int b = 0; b < bits; b++) word |= planes[b * planeSize + index];
+			while (word) {
+				int x = i * 64 + lowestBit(word);
+				callback(x, y, getState(x, y));
+				word &= word - 1;
+			}
+		}
+	}
+}
+
+/** \brief Sets topology of the board edges, all topologies of DenseEngine are supported.
+
+\param topology - topology of the board edges
+\return true if topology was set
+*/
+bool GenerationsEngine::setTopology(Topology topology) {
+	if (!live.setTopology(topology)) {
+		return false;
+	}
+	this->topology = topology;
+	if (topology == TOPOLOGY_FRAME && width > 0 && height > 0) {
+		uint64_t firstBit = 1, lastBit = (uint64_t)1 << ((width - 1) % 64);
+		for (int b = 0; b < bits; b++) {
+			uint64_t* plane = &planes[b * planeSize];
+			fill(plane, plane + wordsPerRow, 0);
+			fill(plane + planeSize - wordsPerRow, plane + planeSize, 0);
+			for (int y = 0; y < height; y++) {
+				plane[(size_t)y * wordsPerRow] &= ~firstBit;
+				plane[(size_t)y * wordsPerRow + (width - 1) / 64] &= ~lastBit;
+			}
+		}
+	}
+	return true;
+}
+
+/** \brief Sets number of threads used by step.
+
+\param threadCount - number of threads, 1 computes generations on the calling thread only
+*/
+void GenerationsEngine::setThreadCount(int threadCount) {
+	if (threadCount < 1) threadCount = 1;
+	if (threadCount == this->threadCount) return;
+	this->threadCount = threadCount;
+	live.setThreadCount(threadCount);
+	pool.reset(threadCount > 1 ? new ThreadPool(threadCount) : NULL);
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <stdint.h>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "LifeEngine.h"
+#include "DenseEngine.h"
+#include "ThreadPool.h"
+using namespace std;
+
+class GenerationsEngine : public LifeEngine {
+private:
+	DenseEngine live; /**< Alive cells(state 1), the only cells counted as neighbors. */
+	int bits; /**< Bits per cell state, 2 or 4. */
+	int wordsPerRow;
+	size_t planeSize; /**< Words of one bit plane. */
+	vector<uint64_t> planes; /**< Bit planes of cell states, bit b of the state of a cell is in plane b. */
+	vector<uint64_t> nextLive;
+	int threadCount;
+	unique_ptr<ThreadPool> pool;
+
+	static int bitsForStates(int);
+	void setBits(int);
+
+public:
+	GenerationsEngine();
+	GenerationsEngine(int, int, const LifeRule&);
+	void resize(int, int);
+	void clear();
+	void setCell(int, int, bool);
+	bool getCell(int, int);
+	void setState(int, int, int);
+	int getState(int, int);
+	void step(int);
+	long long population();
+	void forEachAlive(const function<void(int, int)>&);
+	void forEachState(const function<void(int, int, int)>&);
+	bool setTopology(Topology);
+	void setThreadCount(int);
+	/** \brief Returns number of bits used to store the state of a cell.
+	*/
+	int getBitsPerCell() {
+		return bits;
+	}
+};
@@ -0,0 +1,328 @@
+#include "HaloExchange.h"
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+using namespace std;
+/** \class HaloChannel
+	\brief One end of the boundary between two bands of a decomposed board.
+
+	Both ends of a boundary are created by createHaloChannels in one process before it starts the processes of the bands, every band process keeps the ends of its own boundaries and destroys the others. Socket channels send rows through a non-blocking socket and keep the part of a row that didn't fit into the socket until the next call, so two neighbors sending to each other at the same time never block each other. Shared memory channels write rows into two slots per direction and publish them with a counter, a neighbor is at most one generation ahead, so a slot is never written before it was read.
+	Only POSIX systems are supported, on Windows no channel can be created.
+*/
+
+/** \brief Class destructor.
+*/
+HaloChannel::~HaloChannel() {
+}
+
+#ifndef _WIN32
+class SocketHaloChannel : public HaloChannel {
+private:
+	int socket;
+	size_t rowBytes;
+	vector<unsigned char> outgoing; /**< Sent bytes that didn't fit into the socket yet. */
+	size_t outgoingOffset;
+	vector<unsigned char> incoming; /**< Part of the row of the neighbor received so far. */
+	size_t incomingBytes;
+
+public:
+	/** \brief Class constructor, the channel owns the socket and closes it.
+
+	\param socket - connected socket, made non-blocking
+	\param wordsPerRow - words in one row
+	*/
+	SocketHaloChannel(int socket, int wordsPerRow) {
+		this->socket = socket;
+		this->rowBytes = (size_t)wordsPerRow * sizeof(uint64_t);
+		this->outgoingOffset = 0;
+		this->incoming.resize(rowBytes);
+		this->incomingBytes = 0;
+		fcntl(socket, F_SETFL, fcntl(socket, F_GETFL, 0) | O_NONBLOCK);
+	}
+	/** \brief Class destructor, closes the socket, the neighbor sees the end of the stream.
+	*/
+	~SocketHaloChannel() {
+		close(socket);
+	}
+	/** \brief Writes as much of the waiting bytes as the socket takes.
+
+	\return false if the connection failed
+	*/
+	bool flush() {
+		while (outgoingOffset < outgoing.size()) {
+			ssize_t written = ::send(socket, &outgoing[outgoingOffset], outgoing.size() - outgoingOffset, MSG_NOSIGNAL);
+			if (written > 0) outgoingOffset += written;
+			else if (written < 0 && errno == EINTR) continue;
+			else return written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+		}
+		outgoing.clear();
+		outgoingOffset = 0;
+		return true;
+	}
+	/** \brief Starts sending a row.
+
+	\param words - row next to the boundary
+	\return false if the connection failed
+	*/
+	bool send(const uint64_t* words) {
+		const unsigned char* bytes = (const unsigned char*)words;
+		outgoing.insert(outgoing.end(), bytes, bytes + rowBytes);
+		return flush();
+	}
+	/** \brief Sends waiting bytes and reads the row of the neighbor without waiting.
+
+	\param words - gets the row of the neighbor once it is complete
+	\return 1 if the row was received, 0 if it is not complete yet, -1 if the connection failed or was closed
+	*/
+	int progress(uint64_t* words) {
+		if (!flush()) {
+			return -1;
+		}
+		while (incomingBytes < rowBytes) {
+			//only the rest of this row is read, the next row stays in the socket
+			ssize_t received = recv(socket, &incoming[incomingBytes], rowBytes - incomingBytes, 0);
+			if (received > 0) incomingBytes += received;
+			else if (received < 0 && errno == EINTR) continue;
+			else return received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+		}
+		memcpy(words, incoming.data(), rowBytes);
+		incomingBytes = 0;
+		return 1;
+	}
+	int getDescriptor() {
+		return socket;
+	}
+	bool isSending() {
+		return outgoingOffset < outgoing.size();
+	}
+};
+
+/** \brief Memory shared by both ends of a boundary, unmapped when the last end is destroyed. */
+struct SharedHaloMemory {
+	void* data;
+	size_t size;
+
+	~SharedHaloMemory() {
+		munmap(data, size);
+	}
+};
+
+class SharedHaloChannel : public HaloChannel {
+private:
+	shared_ptr<SharedHaloMemory> memory;
+	int wordsPerRow;
+	atomic<uint64_t>* sentRows; /**< Rows sent by this end. */
+	atomic<uint64_t>* neighborRows; /**< Rows sent by the other end. */
+	uint64_t* slots; /**< Two rows written by this end. */
+	const uint64_t* neighborSlots; /**< Two rows written by the other end. */
+	uint64_t sent, received;
+
+public:
+	/** \brief Class constructor.
+
+	\param memory - mapping with two counters and four rows
+	\param wordsPerRow - words in one row
+	\param end - 0 or 1, the two ends use the counters and slots in opposite order
+	*/
+	SharedHaloChannel(const shared_ptr<SharedHaloMemory>& memory, int wordsPerRow, int end) {
+		this->memory = memory;
+		this->wordsPerRow = wordsPerRow;
+		atomic<uint64_t>* counters = (atomic<uint64_t>*)memory->data;
+		uint64_t* rows = (uint64_t*)(counters + 2);
+		this->sentRows = &counters[end];
+		this->neighborRows = &counters[1 - end];
+		this->slots = &rows[(size_t)end * 2 * wordsPerRow];
+		this->neighborSlots = &rows[(size_t)(1 - end) * 2 * wordsPerRow];
+		this->sent = 0;
+		this->received = 0;
+	}
+	/** \brief Writes a row to the next slot and publishes it.
+
+	\param words - row next to the boundary
+	\return true
+	*/
+	bool send(const uint64_t* words) {
+		memcpy(&slots[(sent % 2) * wordsPerRow], words, (size_t)wordsPerRow * sizeof(uint64_t));
+		sent++;
+		sentRows->store(sent, memory_order_release);
+		return true;
+	}
+	/** \brief Reads the row of the neighbor if it was published.
+
+	\param words - gets the row of the neighbor
+	\return 1 if the row was received, 0 if the neighbor didn't send it yet
+	*/
+	int progress(uint64_t* words) {
+		if (neighborRows->load(memory_order_acquire) <= received) {
+			return 0;
+		}
+		memcpy(words, &neighborSlots[(received % 2) * wordsPerRow], (size_t)wordsPerRow * sizeof(uint64_t));
+		received++;
+		return 1;
+	}
+};
+
+/** \brief Creates a connected pair of TCP sockets on the loopback interface.
+
+\return false if the sockets could not be created or connected
+*/
+static bool connectLoopback(int* first, int* second) {
+	int listener = socket(AF_INET, SOCK_STREAM, 0);
+	if (listener < 0) {
+		return false;
+	}
+	sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = 0;
+	socklen_t length = sizeof(address);
+	int client = -1, server = -1;
+	if (bind(listener, (sockaddr*)&address, sizeof(address)) == 0 && listen(listener, 1) == 0 && getsockname(listener, (sockaddr*)&address, &length) == 0) {
+		client = socket(AF_INET, SOCK_STREAM, 0);
+		if (client >= 0 && connect(client, (sockaddr*)&address, sizeof(address)) == 0) server = accept(listener, NULL, NULL);
+	}
+	close(listener);
+	if (server < 0) {
+		if (client >= 0) close(client);
+		return false;
+	}
+	//rows are small and every one is waited for
+	int isEnabled = 1;
+	setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &isEnabled, sizeof(isEnabled));
+	setsockopt(server, IPPROTO_TCP, TCP_NODELAY, &isEnabled, sizeof(isEnabled));
+	*first = client;
+	*second = server;
+	return true;
+}
+#endif
+
+/** \brief Creates both ends of the boundary between two bands, has to be called before the band processes are started.
+
+\param transport - how rows are sent
+\param wordsPerRow - words in one row
+\param first - gets the end of the band above the boundary
+\param second - gets the end of the band below the boundary
+\return false if the transport is not available
+*/
+bool createHaloChannels(HaloTransport transport, int wordsPerRow, unique_ptr<HaloChannel>* first, unique_ptr<HaloChannel>* second) {
+#ifdef _WIN32
+	return false;
+#else
+	if (transport == TRANSPORT_SHARED) {
+		size_t size = 2 * sizeof(atomic<uint64_t>) + (size_t)4 * wordsPerRow * sizeof(uint64_t);
+		void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		if (data == MAP_FAILED) {
+			return false;
+		}
+		shared_ptr<SharedHaloMemory> memory(new SharedHaloMemory());
+		memory->data = data;
+		memory->size = size;
+		new (data) atomic<uint64_t>[2];
+		((atomic<uint64_t>*)data)[0] = 0;
+		((atomic<uint64_t>*)data)[1] = 0;
+		first->reset(new SharedHaloChannel(memory, wordsPerRow, 0));
+		second->reset(new SharedHaloChannel(memory, wordsPerRow, 1));
+		return true;
+	}
+	int sockets[2];
+	if (transport == TRANSPORT_TCP) {
+		if (!connectLoopback(&sockets[0], &sockets[1])) return false;
+	}
+	else if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+		return false;
+	}
+	first->reset(new SocketHaloChannel(sockets[0], wordsPerRow));
+	second->reset(new SocketHaloChannel(sockets[1], wordsPerRow));
+	return true;
+#endif
+}
+
+/** \brief Receives one row from every channel and finishes sending to them.
+
+Sockets are waited for with poll, shared memory channels by yielding the processor until the neighbor publishes its row.
+\param channels - channels of one band process
+\param rows - gets the row received from each channel, one row per channel
+\return false if a channel failed, e.g. the neighbor process ended
+*/
+bool waitForHalo(const vector<HaloChannel*>& channels, const vector<uint64_t*>& rows) {
+#ifdef _WIN32
+	return channels.empty();
+#else
+	vector<bool> isReceived(channels.size(), false);
+	size_t remaining = channels.size();
+	vector<pollfd> descriptors;
+	while (true) {
+		bool isSending = false;
+		for (size_t i = 0; i < channels.size(); i++) {
+			if (!isReceived[i]) {
+				int result = channels[i]->progress(rows[i]);
+				if (result < 0) return false;
+				if (result > 0) {
+					isReceived[i] = true;
+					remaining--;
+				}
+			}
+			else if (!channels[i]->flush()) {
+				return false;
+			}
+			isSending = isSending || channels[i]->isSending();
+		}
+		if (remaining == 0 && !isSending) {
+			return true;
+		}
+		descriptors.clear();
+		bool isSpinning = false;
+		for (size_t i = 0; i < channels.size(); i++) {
+			short events = (isReceived[i] ? 0 : POLLIN) | (channels[i]->isSending() ? POLLOUT : 0);
+			if (events == 0) continue;
+			if (channels[i]->getDescriptor() < 0) isSpinning = true;
+			else descriptors.push_back({ channels[i]->getDescriptor(), events, 0 });
+		}
+		if (isSpinning) this_thread::yield();
+		else if (poll(descriptors.data(), descriptors.size(), -1) < 0 && errno != EINTR) return false;
+	}
+#endif
+}
+
+/** \brief Returns name of a transport used in options, e.g. "tcp".
+*/
+const char* transportName(HaloTransport transport) {
+	switch (transport) {
+	case TRANSPORT_TCP: return "tcp";
+	case TRANSPORT_UNIX: return "unix";
+	case TRANSPORT_SHARED: return "shm";
+	default: return "unknown";
+	}
+}
+
+/** \brief Reads name of a transport.
+
+\param name - tcp, unix or shm
+\param transport - gets the transport
+\return false if the name is not a transport
+*/
+bool parseTransport(const string& name, HaloTransport* transport) {
+	for (int i = 0; i < TRANSPORT_COUNT; i++) {
+		if (name == transportName((HaloTransport)i)) {
+			*transport = (HaloTransport)i;
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+using namespace std;
+
+/** \brief How neighboring processes of a decomposed board send their edge rows to each other. */
+enum HaloTransport {
+	TRANSPORT_TCP, /**< TCP connection over the loopback interface, could connect processes of different hosts. */
+	TRANSPORT_UNIX, /**< Connected pair of Unix domain sockets. */
+	TRANSPORT_SHARED, /**< Shared memory of processes on the same host, rows are copied with no system calls. */
+	TRANSPORT_COUNT
+};
+
+/** \brief One end of the boundary between two bands of a board, owned by the process of one band.
+
+Every generation the process sends its row next to the boundary and receives the row of the neighbor on the other side, rows of a generation are received in the order they were sent. Sending doesn't wait for the neighbor, progress moves the row on as far as it can without waiting, so the caller can compute in between and wait for several channels at once.
+*/
+class HaloChannel {
+public:
+	virtual ~HaloChannel();
+	virtual bool send(const uint64_t*) = 0;
+	virtual int progress(uint64_t*) = 0;
+	/** \brief Returns socket to wait for with poll, -1 if the channel can only be polled by calling progress.
+	*/
+	virtual int getDescriptor() {
+		return -1;
+	}
+	/** \brief Sends the rest of sent rows without waiting and without receiving.
+
+	\return false if the channel failed
+	*/
+	virtual bool flush() {
+		return true;
+	}
+	/** \brief Returns true if a sent row still waits for room in the socket.
+	*/
+	virtual bool isSending() {
+		return false;
+	}
+};
+
+bool createHaloChannels(HaloTransport, int, unique_ptr<HaloChannel>*, unique_ptr<HaloChannel>*);
+bool waitForHalo(const vector<HaloChannel*>&, const vector<uint64_t*>&);
+const char* transportName(HaloTransport);
+bool parseTransport(const string&, HaloTransport*);
@@ -0,0 +1,499 @@
+#include "HashLifeEngine.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <vector>
+using namespace std;
+/** \class HashLifeEngine
+	\brief Engine that stores the plane as a quadtree of canonical nodes and memoizes their future (HashLife).
+
+	Every square of 2^level x 2^level cells is a node made of four nodes of the level below, equal squares share one node, found in a hash table. A node of level L knows its center square of level L - 1 computed 2^(L - 2) generations ahead, the result is computed once from the results of its sub squares and cached, so repeated and empty regions cost nothing and advance(2^k) takes a few recursive calls per distinct square instead of 2^k full generations.
+	Unlike the other engines the plane is unbounded and has no dead frame, width and height only set the window reported by forEachAlive. Cells can be set at any position, the root grows to hold them.
+	Node table grows until the memory limit is reached, after that nodes not used by the current pattern and all cached results are dropped by a garbage collection before the next step. One step can still go over the limit.
+	Rules with birth on 0 neighbors(B0) are not supported.
+*/
+const uint32_t HashLifeEngine::NO_NODE;
+
+/** \brief Class default constructor.
+
+	Creates empty plane with a window of size 0.
+*/
+HashLifeEngine::HashLifeEngine() {
+	this->maxNodes = ((size_t)256 << 20) / (sizeof(Node) + 2 * sizeof(uint32_t));
+	this->collections = 0;
+	this->reset();
+}
+
+/** \brief Class constructor with window parameters.
+
+\param width - number of columns of the window
+\param height - number of rows of the window
+\param rule - rule of the game
+*/
+HashLifeEngine::HashLifeEngine(int width, int height, const LifeRule& rule) {
+	this->maxNodes = ((size_t)256 << 20) / (sizeof(Node) + 2 * sizeof(uint32_t));
+	this->collections = 0;
+	this->rule = rule;
+	this->resize(width, height);
+}
+
+/** \brief Removes all nodes and creates an empty root.
+*/
+void HashLifeEngine::reset() {
+	nodes.clear();
+	Node cell = { NO_NODE, NO_NODE, NO_NODE, NO_NODE, NO_NODE, 0, 0 };
+	nodes.push_back(cell);
+	cell.population = 1;
+	nodes.push_back(cell);
+	table.assign(1024, NO_NODE);
+	emptyNodes.clear();
+	stepLog = -1;
+	cachedRule = rule;
+	root = emptyNode(3);
+	originX = -4;
+	originY = -4;
+	generation = 0;
+}
+
+/** \brief Sets size of the window and kills every cell.
+
+\param width - number of columns of the window
+\param height - number of rows of the window
+*/
+void HashLifeEngine::resize(int width, int height) {
+	this->width = width;
+	this->height = height;
+	reset();
+}
+
+/** \brief Kills every cell and frees the node table.
+*/
+void HashLifeEngine::clear() {
+	reset();
+}
+
+/** \brief Sets approximate memory used by the node table.
+
+Garbage collection is run before a step when the table has more nodes than fit in the limit.
+\param bytes - memory limit in bytes
+*/
+void HashLifeEngine::setMemoryLimit(size_t bytes) {
+	maxNodes = bytes / (sizeof(Node) + 2 * sizeof(uint32_t));
+}
+
+/** \brief Returns hash of the four children of a node.
+*/
+static inline size_t hashChildren(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) {
+	uint64_t hash = nw * 0x9E3779B97F4A7C15ULL;
+	hash = (hash ^ ne) * 0xC2B2AE3D27D4EB4FULL;
+	hash = (hash ^ sw) * 0x165667B19E3779F9ULL;
+	hash = (hash ^ se) * 0x9E3779B97F4A7C15ULL;
+	return (size_t)(hash ^ (hash >> 32));
+}
+
+/** \brief Returns the canonical node with the given children.
+
+Node is looked up in the hash table and created only if it does not exist yet.
+\param nw - top left child
+\param ne - top right child
+\param sw - bottom left child
+\param se - bottom right child
+\return index of the node
+*/
+uint32_t HashLifeEngine::makeNode(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) {
+	size_t mask = table.size() - 1;
+	size_t slot = hashChildren(nw, ne, sw, se) & mask;
+	while (table[slot] != NO_NODE) {
+		const Node& node = nodes[table[slot]];
+		if (node.nw == nw && node.ne == ne && node.sw == sw && node.se == se) {
+			return table[slot];
+		}
+		slot = (slot + 1) & mask;
+	}
+	Node node = { nw, ne, sw, se, NO_NODE, nodes[nw].level + 1,
+		nodes[nw].population + nodes[ne].population + nodes[sw].population + nodes[se].population };
+	uint32_t index = (uint32_t)nodes.size();
+	nodes.push_back(node);
+	table[slot] = index;
+	if (nodes.size() * 2 > table.size()) {
+		//grow the table, nodes 0 and 1 are cells and are not in the table
+		table.assign(table.size() * 2, NO_NODE);
+		mask = table.size() - 1;
+		for (uint32_t i = 2; i < nodes.size(); i++) {
+			slot = hashChildren(nodes[i].nw, nodes[i].ne, nodes[i].sw, nodes[i].se) & mask;
+			while (table[slot] != NO_NODE) slot = (slot + 1) & mask;
+			table[slot] = i;
+		}
+	}
+	return index;
+}
+
+/** \brief Returns the empty node of a level.
+
+\param level - level of the node, 0 is a single cell
+*/
+uint32_t HashLifeEngine::emptyNode(int level) {
+	if (level == 0) return 0;
+	while ((int)emptyNodes.size() <= level) emptyNodes.push_back(NO_NODE);
+	if (emptyNodes[level] == NO_NODE) {
+		uint32_t child = emptyNode(level - 1);
+		emptyNodes[level] = makeNode(child, child, child, child);
+	}
+	return emptyNodes[level];
+}
+
+/** \brief Returns center square of a node, one level lower, at the same generation.
+
+\param index - node of level 2 or more
+*/
+uint32_t HashLifeEngine::centerNode(uint32_t index) {
+	Node node = nodes[index];
+	return makeNode(nodes[node.nw].se, nodes[node.ne].sw, nodes[node.sw].ne, nodes[node.se].nw);
+}
+
+/** \brief Computes center 2x2 cells of a 4x4 node one generation ahead.
+
+\param index - node of level 2
+\return node of level 1
+*/
+uint32_t HashLifeEngine::stepLeaf(uint32_t index) {
+	Node node = nodes[index];
+	bool cells[4][4];
+	uint32_t quadrants[4] = { node.nw, node.ne, node.sw, node.se };
+	for (int q = 0; q < 4; q++) {
+		const Node& quadrant = nodes[quadrants[q]];
+		int x = (q % 2) * 2;
+		int y = (q / 2) * 2;
+		cells[y][x] = quadrant.nw == 1;
+		cells[y][x + 1] = quadrant.ne == 1;
+		cells[y + 1][x] = quadrant.sw == 1;
+		cells[y + 1][x + 1] = quadrant.se == 1;
+	}
+	uint32_t next[4];
+	for (int i = 0; i < 4; i++) {
+		int x = 1 + i % 2;
+		int y = 1 + i / 2;
+		unsigned neighborhood = 0;
+		for (int dy = -1; dy <= 1; dy++) {
+			for (int dx = -1; dx <= 1; dx++) {
+				if (cells[y + dy][x + dx]) neighborhood |= 1u << (3 * (dy + 1) + dx + 1);
+			}
+		}
+		next[i] = rule.nextStateOf(neighborhood) ? 1 : 0;
+	}
+	return makeNode(next[0], next[1], next[2], next[3]);
+}
+
+/** \brief Returns center square of a node computed 2^min(stepLog, level - 2) generations ahead.
+
+Node is split into nine overlapping squares of the level below. For a full step each of them is advanced by half of the time and the four squares made of their results are advanced by the other half, for a shorter step the nine squares are only cut to their centers. Results are cached in the node.
+\param index - node of level 2 or more
+\return node one level lower
+*/
+uint32_t HashLifeEngine::nextGeneration(uint32_t index) {
+	Node node = nodes[index];
+	if (node.next != NO_NODE) return node.next;
+	uint32_t result;
+	if (node.population == 0) {
+		result = emptyNode(node.level - 1);
+	}
+	else if (node.level == 2) {
+		result = stepLeaf(index);
+	}
+	else {
+		Node nw = nodes[node.nw], ne = nodes[node.ne], sw = nodes[node.sw], se = nodes[node.se];
+		uint32_t squares[9] = {
+			node.nw,
+			makeNode(nw.ne, ne.nw, nw.se, ne.sw),
+			node.ne,
+			makeNode(nw.sw, nw.se, sw.nw, sw.ne),
+			makeNode(nw.se, ne.sw, sw.ne, se.nw),
+			makeNode(ne.sw, ne.se, se.nw, se.ne),
+			node.sw,
+			makeNode(sw.ne, se.nw, sw.se, se.sw),
+			node.se
+		};
+		bool isFullStep = stepLog >= node.level - 2;
+		for (int i = 0; i < 9; i++) {
+			squares[i] = isFullStep ? nextGeneration(squares[i]) : centerNode(squares[i]);
+		}
+		result = makeNode(
+			nextGeneration(makeNode(squares[0], squares[1], squares[3], squares[4])),
+			nextGeneration(makeNode(squares[1], squares[2], squares[4], squares[5])),
+			nextGeneration(makeNode(squares[3], squares[4], squares[6], squares[7])),
+			nextGeneration(makeNode(squares[4], squares[5], squares[7], squares[8])));
+	}
+	nodes[index].next = result;
+	return result;
+}
+
+/** \brief Doubles the root, old root becomes its center square.
+*/
+void HashLifeEngine::expandRoot() {
+	Node node = nodes[root];
+	uint32_t empty = emptyNode(node.level - 1);
+	uint32_t nw = makeNode(empty, empty, empty, node.nw);
+	uint32_t ne = makeNode(empty, empty, node.ne, empty);
+	uint32_t sw = makeNode(empty, node.sw, empty, empty);
+	uint32_t se = makeNode(node.se, empty, empty, empty);
+	root = makeNode(nw, ne, sw, se);
+	originX -= (long long)1 << (node.level - 1);
+	originY -= (long long)1 << (node.level - 1);
+}
+
+/** \brief Halves the root while all alive cells are in its center square.
+*/
+void HashLifeEngine::shrinkRoot() {
+	while (nodes[root].level > 3) {
+		uint32_t center = centerNode(root);
+		if (nodes[center].population != nodes[root].population) return;
+		originX += (long long)1 << (nodes[root].level - 2);
+		originY += (long long)1 << (nodes[root].level - 2);
+		root = center;
+	}
+}
+
+/** \brief Forgets all cached results.
+*/
+void HashLifeEngine::clearResults() {
+	for (unsigned int i = 0; i < nodes.size(); i++) {
+		nodes[i].next = NO_NODE;
+	}
+}
+
+/** \brief Removes nodes that are not part of the current pattern.
+
+Nodes reachable from the root are kept in the same order, so children are still stored before their parents, cached results are dropped because they may point to removed nodes.
+*/
+void HashLifeEngine::collectGarbage() {
+	vector<uint32_t> newIndex(nodes.size(), NO_NODE);
+	vector<uint32_t> stack(1, root);
+	newIndex[0] = 0;
+	newIndex[1] = 1;
+	while (!stack.empty()) {
+		uint32_t index = stack.back();
+		stack.pop_back();
+		if (newIndex[index] != NO_NODE) continue;
+		newIndex[index] = 0;
+		const Node& node = nodes[index];
+		stack.push_back(node.nw);
+		stack.push_back(node.ne);
+		stack.push_back(node.sw);
+		stack.push_back(node.se);
+	}
+	uint32_t count = 2;
+	for (uint32_t i = 2; i < nodes.size(); i++) {
+		if (newIndex[i] == NO_NODE) continue;
+		Node node = nodes[i];
+		node.nw = newIndex[node.nw];
+		node.ne = newIndex[node.ne];
+		node.sw = newIndex[node.sw];
+		node.se = newIndex[node.se];
+		node.next = NO_NODE;
+		newIndex[i] = count;
+		nodes[count++] = node;
+	}
+	nodes[0].next = nodes[1].next = NO_NODE;
+	nodes.resize(count);
+	nodes.shrink_to_fit();
+	root = newIndex[root];
+	size_t tableSize = 1024;
+	while (tableSize < (size_t)count * 2) tableSize *= 2;
+	table.assign(tableSize, NO_NODE);
+	for (uint32_t i = 2; i < count; i++) {
+		size_t slot = hashChildren(nodes[i].nw, nodes[i].ne, nodes[i].sw, nodes[i].se) & (tableSize - 1);
+		while (table[slot] != NO_NODE) slot = (slot + 1) & (tableSize - 1);
+		table[slot] = i;
+	}
+	emptyNodes.clear();
+	collections++;
+}
+
+/** \brief Computes 2^k generations.
+
+Root is grown until the pattern is in its center quarter and the root is big enough to be advanced by 2^k generations at once, so no alive cell can leave the result.
+\param k - log2 of number of generations
+*/
+void HashLifeEngine::stepPowerOfTwo(int k) {
+	if (nodes.size() > maxNodes) collectGarbage();
+	if (stepLog != k || cachedRule != rule) {
+		stepLog = k;
+		cachedRule = rule;
+		clearResults();
+	}
+	while (true) {
+		Node node = nodes[root];
+		bool isCentered = node.level >= k + 2 && nodes[centerNode(root)].population == node.population;
+		if (isCentered) break;
+		expandRoot();
+	}
+	expandRoot();
+	int level = nodes[root].level;
+	root = nextGeneration(root);
+	originX += (long long)1 << (level - 2);
+	originY += (long long)1 << (level - 2);
+	shrinkRoot();
+	generation += (long long)1 << k;
+}
+
+/** \brief Computes any number of generations.
+
+Number of generations is split into powers of two, every one of them is computed in one call of nextGeneration.
+\param generations - number of generations to compute
+*/
+void HashLifeEngine::advance(long long generations) {
+	for (int k = 0; generations >> k != 0; k++) {
+		if ((generations >> k) & 1) {
+			if (nodes[root].population == 0) generation += (long long)1 << k;
+			else stepPowerOfTwo(k);
+		}
+	}
+}
+
+/** \brief Computes next generations.
+
+\param generations - number of generations to compute
+*/
+void HashLifeEngine::step(int generations) {
+	advance(generations);
+}
+
+/** \brief Returns node with one cell changed.
+
+\param index - node containing the cell
+\param x - column of the cell relative to the node
+\param y - row of the cell relative to the node
+\param alive - new state of the cell
+*/
+uint32_t HashLifeEngine::setCellIn(uint32_t index, long long x, long long y, bool alive) {
+	Node node = nodes[index];
+	if (node.level == 0) return alive ? 1 : 0;
+	long long half = (long long)1 << (node.level - 1);
+	if (y < half) {
+		if (x < half) node.nw = setCellIn(node.nw, x, y, alive);
+		else node.ne = setCellIn(node.ne, x - half, y, alive);
+	}
+	else {
+		if (x < half) node.sw = setCellIn(node.sw, x, y - half, alive);
+		else node.se = setCellIn(node.se, x - half, y - half, alive);
+	}
+	return makeNode(node.nw, node.ne, node.sw, node.se);
+}
+
+/** \brief Sets state of a single cell.
+
+Plane is unbounded, cells outside the window are set as well.
+\param x - column of the cell
+\param y - row of the cell
+\param alive - true if cell is going to be alive, false if it's dead
+*/
+void HashLifeEngine::setCell(int x, int y, bool alive) {
+	while (true) {
+		long long size = (long long)1 << nodes[root].level;
+		if (x >= originX && y >= originY && x < originX + size && y < originY + size) break;
+		expandRoot();
+	}
+	root = setCellIn(root, x - originX, y - originY, alive);
+}
+
+/** \brief Returns state of a single cell.
+
+\param x - column of the cell
+\param y - row of the cell
+\return true if cell is alive, false if it's dead
+*/
+bool HashLifeEngine::getCell(int x, int y) {
+	long long cellX = x - originX;
+	long long cellY = y - originY;
+	uint32_t index = root;
+	long long size = (long long)1 << nodes[root].level;
+	if (cellX < 0 || cellY < 0 || cellX >= size || cellY >= size) {
+		return false;
+	}
+	while (nodes[index].level > 0) {
+		const Node& node = nodes[index];
+		if (node.population == 0) return false;
+		long long half = (long long)1 << (node.level - 1);
+		if (cellY < half) index = cellX < half ? node.nw : node.ne;
+		else index = cellX < half ? node.sw : node.se;
+		if (cellX >= half) cellX -= half;
+		if (cellY >= half) cellY -= half;
+	}
+	return index == 1;
+}
+
+/** \brief Returns number of alive cells on the whole plane.
+*/
+long long HashLifeEngine::population() {
+	return nodes[root].population;
+}
+
+/** \brief Counts alive cells of a node inside a rectangle.
+
+\param index - node
+\param nodeX - column of the top left cell of the node
+\param nodeY - row of the top left cell of the node
+\param left, top, right, bottom - rectangle, right and bottom are excluded
+*/
+long long HashLifeEngine::populationIn(uint32_t index, long long nodeX, long long nodeY, long long left, long long top, long long right, long long bottom) {
+	const Node& node = nodes[index];
+	long long size = (long long)1 << node.level;
+	if (node.population == 0 || nodeX >= right || nodeY >= bottom || nodeX + size <= left || nodeY + size <= top) {
+		return 0;
+	}
+	if (nodeX >= left && nodeY >= top && nodeX + size <= right && nodeY + size <= bottom) {
+		return node.population;
+	}
+	long long half = size / 2;
+	Node copy = node;
+	return populationIn(copy.nw, nodeX, nodeY, left, top, right, bottom)
+		+ populationIn(copy.ne, nodeX + half, nodeY, left, top, right, bottom)
+		+ populationIn(copy.sw, nodeX, nodeY + half, left, top, right, bottom)
+		+ populationIn(copy.se, nodeX + half, nodeY + half, left, top, right, bottom);
+}
+
+/** \brief Returns number of alive cells in a rectangle of the plane.
+
+Nodes fully inside or outside the rectangle are not visited, so the cost depends on the length of the rectangle border, not on its area.
+\param x - column of the top left cell
+\param y - row of the top left cell
+\param width - number of columns
+\param height - number of rows
+*/
+long long HashLifeEngine::population(long long x, long long y, long long width, long long height) {
+	return populationIn(root, originX, originY, x, y, x + width, y + height);
+}
+
+/** \brief Calls a function for alive cells of a node inside the window.
+
+\param index - node
+\param nodeX - column of the top left cell of the node
+\param nodeY - row of the top left cell of the node
+\param callback - function called with x and y of every alive cell
+*/
+void HashLifeEngine::forEachAliveIn(uint32_t index, long long nodeX, long long nodeY, const function<void(int, int)>& callback) {
+	const Node& node = nodes[index];
+	long long size = (long long)1 << node.level;
+	if (node.population == 0 || nodeX >= width || nodeY >= height || nodeX + size <= 0 || nodeY + size <= 0) {
+		return;
+	}
+	if (node.level == 0) {
+		callback((int)nodeX, (int)nodeY);
+		return;
+	}
+	long long half = size / 2;
+	Node copy = node;
+	forEachAliveIn(copy.nw, nodeX, nodeY, callback);
+	forEachAliveIn(copy.ne, nodeX + half, nodeY, callback);
+	forEachAliveIn(copy.sw, nodeX, nodeY + half, callback);
+	forEachAliveIn(copy.se, nodeX + half, nodeY + half, callback);
+}
+
+/** \brief Calls a function for every alive cell inside the window.
+
+Cells are visited in quadtree order, empty nodes are skipped.
+\param callback - function called with x and y of every alive cell
+*/
+void HashLifeEngine::forEachAlive(const function<void(int, int)>& callback) {
+	forEachAliveIn(root, originX, originY, callback);
+}
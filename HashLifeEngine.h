@@ -0,0 +1,76 @@
+#pragma once
+#include "LifeEngine.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <vector>
+using namespace std;
+
+class HashLifeEngine : public LifeEngine {
+private:
+	/** \brief Square of 2^level x 2^level cells made of four squares of the level below.
+
+	Nodes are canonical, there is exactly one node for every content, so equal squares are found by comparing indexes.
+	*/
+	struct Node {
+		uint32_t nw, ne, sw, se;
+		uint32_t next; /**< Center square 2^stepLog generations later(or 2^(level - 2) if less), NO_NODE if not computed yet. */
+		int level;
+		long long population;
+	};
+	static const uint32_t NO_NODE = 0xFFFFFFFF;
+
+	vector<Node> nodes; /**< Nodes 0 and 1 are dead and alive cells, children are always stored before their parents. */
+	vector<uint32_t> table; /**< Open addressing hash table of node indexes. */
+	vector<uint32_t> emptyNodes; /**< Empty node of every level, NO_NODE if not created yet. */
+	uint32_t root;
+	long long originX, originY; /**< Position of the top left cell of the root. */
+	int stepLog;
+	LifeRule cachedRule; /**< Rule used by the cached results. */
+	size_t maxNodes;
+	long long collections;
+
+	void reset();
+	uint32_t makeNode(uint32_t, uint32_t, uint32_t, uint32_t);
+	uint32_t emptyNode(int);
+	uint32_t centerNode(uint32_t);
+	uint32_t stepLeaf(uint32_t);
+	uint32_t nextGeneration(uint32_t);
+	void expandRoot();
+	void shrinkRoot();
+	void clearResults();
+	void collectGarbage();
+	void stepPowerOfTwo(int);
+	uint32_t setCellIn(uint32_t, long long, long long, bool);
+	void forEachAliveIn(uint32_t, long long, long long, const function<void(int, int)>&);
+	long long populationIn(uint32_t, long long, long long, long long, long long, long long, long long);
+
+public:
+	HashLifeEngine();
+	HashLifeEngine(int, int, const LifeRule&);
+	void resize(int, int);
+	void clear();
+	void setCell(int, int, bool);
+	bool getCell(int, int);
+	void step(int);
+	void advance(long long);
+	long long population();
+	long long population(long long, long long, long long, long long);
+	void forEachAlive(const function<void(int, int)>&);
+	void setMemoryLimit(size_t);
+	/** \brief Returns number of nodes in the node table, including nodes not used by the current pattern.
+	*/
+	size_t getNodeCount() {
+		return nodes.size();
+	}
+	/** \brief Returns number of garbage collections run since the engine was created.
+	*/
+	long long getCollections() {
+		return collections;
+	}
+	/** \brief Returns bytes taken by the node table.
+	*/
+	size_t getMemoryUsage() {
+		return nodes.capacity() * sizeof(Node) + table.capacity() * sizeof(uint32_t);
+	}
+};
@@ -0,0 +1,361 @@
+#include "LargerThanLifeEngine.h"
+#include "LtlRule.h"
+#include "ThreadPool.h"
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include <vector>
+using namespace std;
+/** \class LargerThanLifeEngine
+	\brief Engine for Larger than Life rules, neighbors are counted in a square, diamond or disc of range r instead of the 8 cells next to a cell.
+
+	Counting every neighbor costs (2r + 1)^2 cell reads per cell, 441 for range 10, so each generation first copies the board into a padded array with a halo of r + 1 cells filled according to the topology and builds running sums over it, then the count of every cell is read from the sums:
+	- Moore: summed-area table, sum of any rectangle is 4 reads.
+	- von Neumann: prefix sums along both diagonals, the diamond of the next cell in a row is the diamond of the previous cell plus its 2 right edges minus the 2 left edges of the previous diamond, 8 reads.
+	- circular: row prefix sums, every row of the disc is 2 reads, 4r + 2 reads per cell.
+	Sums are unsigned 32 bit, they may wrap on huge boards but differences of them are still exact. Rows of the next generation are computed in bands on all threads.
+*/
+/** \brief Class default constructor.
+
+	Creates empty engine with Bosco's rule, board has to be set with resize.
+*/
+LargerThanLifeEngine::LargerThanLifeEngine() {
+	this->halo = 0;
+	this->paddedWidth = 0;
+	this->paddedHeight = 0;
+	this->threadCount = 1;
+}
+
+/** \brief Class constructor with board parameters.
+
+\param width - number of columns of the board
+\param height - number of rows of the board
+\param ltlRule - Larger than Life rule of the game
+*/
+LargerThanLifeEngine::LargerThanLifeEngine(int width, int height, const LtlRule& ltlRule) {
+	this->ltlRule = ltlRule;
+	this->halo = 0;
+	this->paddedWidth = 0;
+	this->paddedHeight = 0;
+	this->threadCount = 1;
+	this->resize(width, height);
+}
+
+/** \brief Creates a new dead board.
+
+\param width - number of columns of the board
+\param height - number of rows of the board
+*/
+void LargerThanLifeEngine::resize(int width, int height) {
+	this->width = width;
+	this->height = height;
+	cells.assign((size_t)width * height, 0);
+	nextCells.assign((size_t)width * height, 0);
+	generation = 0;
+}
+
+/** \brief Kills every cell and resets the generation counter.
+*/
+void LargerThanLifeEngine::clear() {
+	fill(cells.begin(), cells.end(), 0);
+	generation = 0;
+}
+
+/** \brief Sets a cell alive or dead.
+
+Cells outside the board and cells on the dead frame(TOPOLOGY_FRAME) are ignored.
+\param x - column of the cell
+\param y - row of the cell
+\param alive - true for alive cell
+*/
+void LargerThanLifeEngine::setCell(int x, int y, bool alive) {
+	int frame = topology == TOPOLOGY_FRAME ? 1 : 0;
+	if (x < frame || y < frame || x > width - 1 - frame || y > height - 1 - frame) {
+		return;
+	}
+	cells[(size_t)y * width + x] = alive ? 1 : 0;
+}
+
+/** \brief Returns true if a cell is alive, cells outside the board are dead.
+
+\param x - column of the cell
+\param y - row of the cell
+*/
+bool LargerThanLifeEngine::getCell(int x, int y) {
+	if (x < 0 || y < 0 || x >= width || y >= height) {
+		return false;
+	}
+	return cells[(size_t)y * width + x] != 0;
+}
+
+/** \brief Maps a column or row outside the board to the cell it sees, the range may reach over the whole board and beyond.
+
+\param coordinate - column or row, may be outside the board
+\param size - width or height of the board
+\param flipped - pointer to flag which is toggled for every wrap of a row on the Klein bottle, NULL for columns
+\return coordinate on the board, -1 for dead cells
+*/
+int LargerThanLifeEngine::sourceCoordinate(int coordinate, int size, bool* flipped) const {
+	if (coordinate >= 0 && coordinate < size) {
+		return coordinate;
+	}
+	if (topology == TOPOLOGY_FRAME || topology == TOPOLOGY_DEAD) {
+		return -1;
+	}
+	if (topology == TOPOLOGY_MIRROR) {
+		int period = 2 * size;
+		int folded = ((coordinate % period) + period) % period;
+		return folded < size ? folded : period - 1 - folded;
+	}
+	int wraps = coordinate < 0 ? (coordinate + 1) / size - 1 : coordinate / size;
+	if (flipped && topology == TOPOLOGY_KLEIN && wraps % 2 != 0) *flipped = !*flipped;
+	return coordinate - wraps * size;
+}
+
+/** \brief Copies a band of rows of the board into padded and fills their halo.
+
+\param band - index of the band, padded rows are split into bands evenly
+*/
+void LargerThanLifeEngine::fillPadded(int band) {
+	int bandCount = pool ? min(paddedHeight, threadCount * 4) : 1;
+	for (int py = paddedHeight * band / bandCount; py < paddedHeight * (band + 1) / bandCount; py++) {
+		uint8_t* row = &padded[(size_t)py * paddedWidth];
+		bool isFlipped = false;
+		int y = sourceCoordinate(py - halo, height, &isFlipped);
+		if (y < 0) {
+			memset(row, 0, paddedWidth);
+			continue;
+		}
+		const uint8_t* source = &cells[(size_t)y * width];
+		if (isFlipped) {
+			for (int x = 0; x < width; x++) row[halo + x] = source[width - 1 - x];
+		}
+		else {
+			memcpy(row + halo, source, width);
+		}
+		for (int px = 0; px < paddedWidth; px++) {
+			if (px == halo) px += width;
+			if (px >= paddedWidth) break;
+			int x = sourceCoordinate(px - halo, width, NULL);
+			row[px] = x < 0 ? 0 : row[halo + x];
+		}
+	}
+}
+
+/** \brief Builds running sums of padded needed by the neighborhood of the rule.
+
+Prefix sums along rows are independent and run on all threads, the sums across rows depend on the previous row and run on one thread with the inner loop vectorized.
+*/
+void LargerThanLifeEngine::buildSums() {
+	int sumsWidth = paddedWidth + 1;
+	if (ltlRule.getNeighborhood() == NEIGHBORHOOD_VON_NEUMANN) {
+		for (int py = 0; py < paddedHeight; py++) {
+			const uint8_t* row = &padded[(size_t)py * paddedWidth];
+			uint32_t* down = &diagonal[(size_t)py * paddedWidth];
+			uint32_t* left = &antiDiagonal[(size_t)py * paddedWidth];
+			if (py == 0) {
+				for (int px = 0; px < paddedWidth; px++) down[px] = left[px] = row[px];
+				continue;
+			}
+			const uint32_t* up = down - paddedWidth;
+			const uint32_t* right = left - paddedWidth;
+			down[0] = row[0];
+			for (int px = 1; px < paddedWidth; px++) down[px] = row[px] + up[px - 1];
+			for (int px = 0; px < paddedWidth - 1; px++) left[px] = row[px] + right[px + 1];
+			left[paddedWidth - 1] = row[paddedWidth - 1];
+		}
+		return;
+	}
+	//Moore table has a zero row on top, so rectangle sums don't need bounds checks
+	int firstRow = ltlRule.getNeighborhood() == NEIGHBORHOOD_MOORE ? 1 : 0;
+	int bandCount = pool ? min(paddedHeight, threadCount * 4) : 1;
+	function<void(int)> sumBand = [&](int band) {
+		for (int py = paddedHeight * band / bandCount; py < paddedHeight * (band + 1) / bandCount; py++) {
+			const uint8_t* row = &padded[(size_t)py * paddedWidth];
+			uint32_t* sum = &sums[(size_t)(py + firstRow) * sumsWidth];
+			sum[0] = 0;
+			for (int px = 0; px < paddedWidth; px++) sum[px + 1] = sum[px] + row[px];
+		}
+	};
+	if (pool) pool->parallelFor(bandCount, sumBand);
+	else sumBand(0);
+	if (firstRow == 1) {
+		fill(sums.begin(), sums.begin() + sumsWidth, 0);
+		for (int py = 1; py <= paddedHeight; py++) {
+			uint32_t* sum = &sums[(size_t)py * sumsWidth];
+			const uint32_t* above = sum - sumsWidth;
+			for (int px = 0; px < sumsWidth; px++) sum[px] += above[px];
+		}
+	}
+}
+
+/** \brief Computes a row of the next generation from the running sums.
+
+\param y - row of the board
+*/
+void LargerThanLifeEngine::stepRow(int y) {
+	uint8_t* next = &nextCells[(size_t)y * width];
+	if (topology == TOPOLOGY_FRAME && (y == 0 || y == height - 1)) {
+		memset(next, 0, width);
+		return;
+	}
+	int range = ltlRule.getRange();
+	int py = y + halo;
+	const uint8_t* center = &padded[(size_t)py * paddedWidth + halo];
+	uint32_t uncounted = ltlRule.getHasCenter() ? 0 : 1;
+	if (ltlRule.getNeighborhood() == NEIGHBORHOOD_MOORE) {
+		size_t sumsWidth = paddedWidth + 1;
+		//rectangle from padded rows py - range to py + range, columns px - range to px + range
+		const uint32_t* top = &sums[(size_t)(py - range) * sumsWidth + halo - range];
+		const uint32_t* bottom = &sums[(size_t)(py + range + 1) * sumsWidth + halo - range];
+		int span = 2 * range + 1;
+		for (int x = 0; x < width; x++) {
+			uint32_t count = bottom[x + span] - bottom[x] - top[x + span] + top[x] - uncounted * center[x];
+			next[x] = ltlRule.nextState(center[x] != 0, (int)count);
+		}
+	}
+	else if (ltlRule.getNeighborhood() == NEIGHBORHOOD_CIRCULAR) {
+		size_t sumsWidth = paddedWidth + 1;
+		const uint32_t* rows[2 * LtlRule::maxRange + 1];
+		int halfWidths[2 * LtlRule::maxRange + 1];
+		for (int dy = -range; dy <= range; dy++) {
+			rows[dy + range] = &sums[(size_t)(py + dy) * sumsWidth + halo];
+			halfWidths[dy + range] = ltlRule.halfWidth(dy);
+		}
+		for (int x = 0; x < width; x++) {
+			uint32_t count = 0;
+			for (int i = 0; i <= 2 * range; i++) count += rows[i][x + halfWidths[i] + 1] - rows[i][x - halfWidths[i]];
+			next[x] = ltlRule.nextState(center[x] != 0, (int)(count - uncounted * center[x]));
+		}
+	}
+	else {
+		//diamond of the first cell is counted directly, then it slides right
+		uint32_t count = 0;
+		for (int dy = -range; dy <= range; dy++) {
+			const uint8_t* row = &padded[(size_t)(py + dy) * paddedWidth + halo];
+			for (int dx = -ltlRule.halfWidth(dy); dx <= ltlRule.halfWidth(dy); dx++) count += row[dx];
+		}
+		const uint32_t* down = &diagonal[0];
+		const uint32_t* left = &antiDiagonal[0];
+		size_t above = (size_t)(py - range - 1) * paddedWidth;
+		size_t middle = (size_t)py * paddedWidth;
+		size_t below = (size_t)(py + range) * paddedWidth;
+		for (int x = 0; x < width; x++) {
+			next[x] = ltlRule.nextState(center[x] != 0, (int)(count - uncounted * center[x]));
+			int px = x + halo;
+			//upper right and lower right edges of the next diamond
+			count += down[middle + px + 1 + range] - down[above + px] + left[below + px + 1] - left[middle + px + 1 + range];
+			//upper left and lower left edges of this diamond
+			count -= left[middle + px - range] - left[above + px + 1] + down[below + px] - down[middle + px - range];
+		}
+	}
+	if (topology == TOPOLOGY_FRAME) {
+		next[0] = 0;
+		next[width - 1] = 0;
+	}
+}
+
+/** \brief Computes next generations.
+
+\param generations - number of generations to compute
+*/
+void LargerThanLifeEngine::step(int generations) {
+	if (width < 1 || height < 1) {
+		return;
+	}
+	halo = ltlRule.getRange() + 1;
+	paddedWidth = width + 2 * halo;
+	paddedHeight = height + 2 * halo;
+	padded.resize((size_t)paddedWidth * paddedHeight);
+	if (ltlRule.getNeighborhood() == NEIGHBORHOOD_VON_NEUMANN) {
+		diagonal.resize(padded.size());
+		antiDiagonal.resize(padded.size());
+		sums.clear();
+	}
+	else {
+		sums.resize((size_t)(paddedWidth + 1) * (paddedHeight + 1));
+		diagonal.clear();
+		antiDiagonal.clear();
+	}
+	int paddedBands = pool ? min(paddedHeight, threadCount * 4) : 1;
+	int bandCount = pool ? min(height, threadCount * 4) : 1;
+	function<void(int)> fillBand = [&](int band) {
+		fillPadded(band);
+	};
+	function<void(int)> stepBand = [&](int band) {
+		for (int y = height * band / bandCount; y < height * (band + 1) / bandCount; y++) {
+			stepRow(y);
+		}
+	};
+	for (int g = 0; g < generations; g++) {
+		if (pool) pool->parallelFor(paddedBands, fillBand);
+		else fillBand(0);
+		buildSums();
+		if (pool) pool->parallelFor(bandCount, stepBand);
+		else stepBand(0);
+		cells.swap(nextCells);
+		generation++;
+	}
+}
+
+/** \brief Returns number of alive cells.
+*/
+long long LargerThanLifeEngine::population() {
+	long long count = 0;
+	for (size_t i = 0; i < cells.size(); i++) {
+		count += cells[i];
+	}
+	return count;
+}
+
+/** \brief Calls a function for every alive cell.
+
+\param callback - function called with x and y of every alive cell
+*/
+void LargerThanLifeEngine::forEachAlive(const function<void(int, int)>& callback) {
+	for (int y = 0; y < height; y++) {
+		const uint8_t* row = &cells[(size_t)y * width];
+		for (int x = 0; x < width; x++) {
+			if (row[x]) callback(x, y);
+		}
+	}
+}
+
+/** \brief Sets topology of the board edges.
+
+Switching to TOPOLOGY_FRAME kills cells on the frame.
+\param topology - topology of the board edges
+\return true, all topologies are supported
+*/
+bool LargerThanLifeEngine::setTopology(Topology topology) {
+	this->topology = topology;
+	if (topology == TOPOLOGY_FRAME && width > 0 && height > 0) {
+		for (int x = 0; x < width; x++) {
+			cells[x] = 0;
+			cells[(size_t)(height - 1) * width + x] = 0;
+		}
+		for (int y = 0; y < height; y++) {
+			cells[(size_t)y * width] = 0;
+			cells[(size_t)y * width + width - 1] = 0;
+		}
+	}
+	return true;
+}
+
+/** \brief Sets Larger than Life rule of the game, the board is kept.
+*/
+void LargerThanLifeEngine::setLtlRule(const LtlRule& ltlRule) {
+	this->ltlRule = ltlRule;
+}
+
+/** \brief Sets number of threads used by step.
+
+\param threadCount - number of threads, 1 computes generations on the calling thread only
+*/
+void LargerThanLifeEngine::setThreadCount(int threadCount) {
+	if (threadCount < 1) threadCount = 1;
+	if (threadCount == this->threadCount) return;
+	this->threadCount = threadCount;
+	pool.reset(threadCount > 1 ? new ThreadPool(threadCount) : NULL);
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <stdint.h>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "LifeEngine.h"
+#include "LtlRule.h"
+#include "ThreadPool.h"
+using namespace std;
+
+class LargerThanLifeEngine : public LifeEngine {
+private:
+	LtlRule ltlRule;
+	vector<uint8_t> cells; /**< One byte per cell, 1 for alive. */
+	vector<uint8_t> nextCells;
+	int halo; /**< Cells around the board in padded, range + 1. */
+	int paddedWidth, paddedHeight;
+	vector<uint8_t> padded; /**< Board with a halo filled according to the topology. */
+	vector<uint32_t> sums; /**< Summed-area table for Moore, row prefix sums for circular. */
+	vector<uint32_t> diagonal; /**< Prefix sums down-right along diagonals, von Neumann only. */
+	vector<uint32_t> antiDiagonal; /**< Prefix sums down-left along anti-diagonals, von Neumann only. */
+	int threadCount;
+	unique_ptr<ThreadPool> pool;
+
+	int sourceCoordinate(int, int, bool*) const;
+	void fillPadded(int);
+	void buildSums();
+	void stepRow(int);
+
+public:
+	LargerThanLifeEngine();
+	LargerThanLifeEngine(int, int, const LtlRule&);
+	void resize(int, int);
+	void clear();
+	void setCell(int, int, bool);
+	bool getCell(int, int);
+	void step(int);
+	long long population();
+	void forEachAlive(const function<void(int, int)>&);
+	bool setTopology(Topology);
+	void setLtlRule(const LtlRule&);
+	void setThreadCount(int);
+	/** \brief Returns Larger than Life rule of the game.
+	*/
+	const LtlRule& getLtlRule() {
+		return ltlRule;
+	}
+};
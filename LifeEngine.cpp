@@ -0,0 +1,73 @@
+#include "LifeEngine.h"
+#include <vector>
+using namespace std;
+/** \class LifeEngine
+	\brief Interface of a headless simulation engine.
+
+	Engine stores the board, computes successive generations and exposes alive cells to its clients. It does not depend on SDL or on any system header, so it can be used by the graphical front-end as well as on machines without a display.
+	Board coordinates are cell indexes: x is a column from 0 to width - 1, y is a row from 0 to height - 1.
+*/
+/** \brief Class default constructor.
+
+	Sets empty board, basic Conway rules and generation counter to 0.
+*/
+LifeEngine::LifeEngine() {
+	this->width = 0;
+	this->height = 0;
+	this->generation = 0;
+	this->topology = TOPOLOGY_FRAME;
+	this->statsWriter = NULL;
+}
+
+/** \brief Class destructor.
+*/
+LifeEngine::~LifeEngine() {
+}
+
+/** \brief Loads a pattern.
+
+Clears the board, sets every listed cell alive and resets the generation counter.
+\param cells - list of (x, y) positions of alive cells
+*/
+void LifeEngine::load(const vector< pair<int, int> >& cells) {
+	this->clear();
+	for (unsigned int i = 0; i < cells.size(); i++) {
+		this->setCell(cells[i].first, cells[i].second, true);
+	}
+	this->generation = 0;
+}
+
+/** \brief Loads board of another engine.
+
+Board size, rule, alive cells and generation counter are copied, so a pattern created in one engine(e.g. by createRandomGenerator) can be continued in another one.
+\param source - engine with the pattern
+*/
+void LifeEngine::load(LifeEngine* source) {
+	this->resize(source->getWidth(), source->getHeight());
+	this->setRule(source->getRule());
+	source->forEachAlive([&](int x, int y) {
+		this->setCell(x, y, true);
+	});
+	this->generation = source->getGeneration();
+}
+
+/** \brief Sets rule of the game.
+
+Engines that can't simulate the rule keep their rule and return false.
+\param rule - one of the variants(LifeRule::preset) or any B/S rule
+\return true if rule was set
+*/
+bool LifeEngine::setRule(const LifeRule& rule) {
+	this->rule = rule;
+	return true;
+}
+
+/** \brief Sets topology of the board edges.
+
+Engines that support only the dead frame keep it and return false for any other topology.
+\param topology - topology of the board edges
+\return true if topology was set
+*/
+bool LifeEngine::setTopology(Topology topology) {
+	return topology == this->topology;
+}
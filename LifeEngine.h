@@ -0,0 +1,85 @@
+#pragma once
+#include <functional>
+#include <utility>
+#include <vector>
+#include "LifeRule.h"
+using namespace std;
+
+class StatsWriter;
+
+/** \brief What cells on the edge of the board see outside of it. */
+enum Topology {
+	TOPOLOGY_FRAME, /**< Outermost ring of the board is always dead, like in the original game. */
+	TOPOLOGY_DEAD, /**< Cells outside the board are dead, edge cells evolve. */
+	TOPOLOGY_TORUS, /**< Opposite edges are glued together. */
+	TOPOLOGY_KLEIN, /**< Left and right edges are glued, top and bottom are glued with a horizontal flip. */
+	TOPOLOGY_MIRROR /**< Every edge is a mirror, cell outside the board has the state of the edge cell next to it. */
+};
+
+class LifeEngine {
+protected:
+	int width, height;
+	LifeRule rule;
+	long long generation;
+	Topology topology;
+	StatsWriter* statsWriter; /**< Gets statistics of every generation if compiled with CONWAY_STATS, see GenerationStats.h. */
+
+public:
+	LifeEngine();
+	virtual ~LifeEngine();
+	virtual void resize(int, int) = 0;
+	virtual void clear() = 0;
+	virtual void setCell(int, int, bool) = 0;
+	virtual bool getCell(int, int) = 0;
+	virtual void step(int) = 0;
+	virtual long long population() = 0;
+	virtual void forEachAlive(const function<void(int, int)>&) = 0;
+	void load(const vector< pair<int, int> >&);
+	void load(LifeEngine*);
+	virtual bool setRule(const LifeRule&);
+	virtual bool setTopology(Topology);
+	/** \brief Sets writer of per-generation statistics.
+
+	Statistics are collected by DenseEngine and SparseEngine only if the program is compiled with CONWAY_STATS.
+	\param statsWriter - writer, NULL to stop collecting
+	*/
+	void setStatsWriter(StatsWriter* statsWriter) {
+		this->statsWriter = statsWriter;
+	}
+	/** \brief Returns board width in cells.
+
+	\return width - number of columns of the board
+	*/
+	int getWidth() {
+		return width;
+	}
+	/** \brief Returns board height in cells.
+
+	\return height - number of rows of the board
+	*/
+	int getHeight() {
+		return height;
+	}
+	/** \brief Returns number of generations computed since the board was loaded.
+
+	\return generation - generation counter
+	*/
+	long long getGeneration() {
+		return generation;
+	}
+	/** \brief Sets generation counter, used when a saved board is restored.
+	*/
+	void setGeneration(long long generation) {
+		this->generation = generation;
+	}
+	/** \brief Returns topology of the board edges.
+	*/
+	Topology getTopology() {
+		return topology;
+	}
+	/** \brief Returns rule of the game.
+	*/
+	const LifeRule& getRule() {
+		return rule;
+	}
+};
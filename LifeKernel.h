@@ -0,0 +1,433 @@
+#pragma once
+#include <stdint.h>
+#include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+using namespace std;
+
+/** \brief Neighbor counts of cells stored as bit planes.
+
+Bit i of bit0..bit3 is the binary number of alive neighbors of cell i, from 0 to 8. Word is uint64_t for 64 cells or a vector type from one of the StepKernels files for several words at once.
+*/
+template <class Word>
+struct BitCount {
+	Word bit0, bit1, bit2, bit3;
+};
+
+typedef BitCount<uint64_t> NeighborCount;
+
+/** \brief Loads words starting at the given address, address does not have to be aligned.
+
+Vector types specialize this function in their StepKernels file.
+*/
+template <class Word>
+inline Word loadWords(const uint64_t* words);
+
+template <>
+inline uint64_t loadWords<uint64_t>(const uint64_t* words) {
+	return *words;
+}
+
+/** \brief Stores one word.
+*/
+inline void storeWords(uint64_t* words, uint64_t value) {
+	*words = value;
+}
+
+/** \brief Returns number of set bits in a word.
+*/
+inline int popCount(uint64_t word) {
+#ifdef _MSC_VER
+	return (int)__popcnt64(word);
+#else
+	return __builtin_popcountll(word);
+#endif
+}
+
+/** \brief Returns index of the lowest set bit of a non zero word.
+*/
+inline int lowestBit(uint64_t word) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, word);
+	return (int)index;
+#else
+	return __builtin_ctzll(word);
+#endif
+}
+
+/** \brief Returns index of the highest set bit of a non zero word.
+*/
+inline int highestBit(uint64_t word) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanReverse64(&index, word);
+	return (int)index;
+#else
+	return 63 - __builtin_clzll(word);
+#endif
+}
+
+/** \brief Alive cells of a row of words and of its eight neighbors as bit planes.
+
+Bit i of every plane is the neighbor of cell i in that direction, e.g. bit i of aboveWest is the cell above and left of cell i.
+*/
+template <class Word>
+struct Neighborhood {
+	Word aboveWest, above, aboveEast;
+	Word west, center, east;
+	Word belowWest, below, belowEast;
+};
+
+/** \brief Loads the neighbors of 64 cells, or of several words of cells at once.
+
+Bit i of a word is the cell in column 64 * word + i. Every row pointer points to the current word of its row, words before and after the loaded ones have to be readable, they give left and right neighbors of the first and last bit.
+\param above - current word of the row above
+\param row - current word of the row
+\param below - current word of the row below
+\param cells - neighbors of the cells
+*/
+template <class Word>
+inline void loadNeighborhood(const uint64_t* above, const uint64_t* row, const uint64_t* below, Neighborhood<Word>* cells) {
+	cells->above = loadWords<Word>(above);
+	cells->center = loadWords<Word>(row);
+	cells->below = loadWords<Word>(below);
+	cells->aboveWest = (cells->above << 1) | (loadWords<Word>(above - 1) >> 63);
+	cells->aboveEast = (cells->above >> 1) | (loadWords<Word>(above + 1) << 63);
+	cells->west = (cells->center << 1) | (loadWords<Word>(row - 1) >> 63);
+	cells->east = (cells->center >> 1) | (loadWords<Word>(row + 1) << 63);
+	cells->belowWest = (cells->below << 1) | (loadWords<Word>(below - 1) >> 63);
+	cells->belowEast = (cells->below >> 1) | (loadWords<Word>(below + 1) << 63);
+}
+
+/** \brief Counts alive neighbors of loaded cells.
+
+The eight neighbor words are summed with full and half adders, so every bit of the result is computed in parallel.
+\param cells - neighbors of the cells
+\param count - neighbor counts of the cells
+*/
+template <class Word>
+inline void countNeighbors(const Neighborhood<Word>& cells, BitCount<Word>* count) {
+	//full adder of the row above
+	Word aboveOnes = cells.aboveWest ^ cells.above ^ cells.aboveEast;
+	Word aboveTwos = (cells.aboveWest & cells.above) | (cells.aboveEast & (cells.aboveWest ^ cells.above));
+	//half adder of the row
+	Word rowOnes = cells.west ^ cells.east;
+	Word rowTwos = cells.west & cells.east;
+	//full adder of the row below
+	Word belowOnes = cells.belowWest ^ cells.below ^ cells.belowEast;
+	Word belowTwos = (cells.belowWest & cells.below) | (cells.belowEast & (cells.belowWest ^ cells.below));
+
+	//sum of ones
+	Word ones = aboveOnes ^ rowOnes ^ belowOnes;
+	Word onesCarry = (aboveOnes & rowOnes) | (belowOnes & (aboveOnes ^ rowOnes));
+	//sum of twos
+	Word twos = aboveTwos ^ rowTwos ^ belowTwos;
+	Word twosCarry = (aboveTwos & rowTwos) | (belowTwos & (aboveTwos ^ rowTwos));
+	count->bit0 = ones;
+	count->bit1 = twos ^ onesCarry;
+	//sum of fours
+	Word fours = twos & onesCarry;
+	count->bit2 = twosCarry ^ fours;
+	count->bit3 = twosCarry & fours;
+}
+
+/** \brief Counts alive neighbors of 64 cells, or of several words of cells at once.
+
+\param above - current word of the row above
+\param row - current word of the row
+\param below - current word of the row below
+\param count - neighbor counts of the cells
+*/
+template <class Word>
+inline void countNeighbors(const uint64_t* above, const uint64_t* row, const uint64_t* below, BitCount<Word>* count) {
+	Neighborhood<Word> cells;
+	loadNeighborhood(above, row, below, &cells);
+	countNeighbors(cells, count);
+}
+
+/** \brief Returns cells with exactly the given number of alive neighbors.
+
+\param count - neighbor counts of the cells
+\param neighbors - number of neighbors from 0 to 8
+*/
+template <class Word>
+inline Word countEquals(const BitCount<Word>& count, int neighbors) {
+	Word result = (neighbors & 1) ? count.bit0 : ~count.bit0;
+	result = result & ((neighbors & 2) ? count.bit1 : ~count.bit1);
+	result = result & ((neighbors & 4) ? count.bit2 : ~count.bit2);
+	result = result & ((neighbors & 8) ? count.bit3 : ~count.bit3);
+	return result;
+}
+
+/** \brief Returns cells whose number of neighbors is in a mask known at compile time.
+
+Template is expanded into an OR of countEquals for every set bit of the mask, so no mask bit is tested at run time.
+\param count - neighbor counts of the cells
+*/
+template <unsigned Mask, int Neighbors, class Word>
+inline Word countMatches(const BitCount<Word>& count) {
+	if constexpr (Neighbors == 8) {
+		return ((Mask >> 8) & 1) ? countEquals(count, 8) : (count.bit0 & ~count.bit0);
+	}
+	else if constexpr (((Mask >> Neighbors) & 1) != 0) {
+		return countEquals(count, Neighbors) | countMatches<Mask, Neighbors + 1>(count);
+	}
+	else {
+		return countMatches<Mask, Neighbors + 1>(count);
+	}
+}
+
+/** \brief Rule known at compile time.
+
+Used for the game variants, every variant gets its own step kernel without any rule checks in the loop.
+*/
+template <unsigned Birth, unsigned Survival>
+struct FixedRule {
+	/** \brief Returns next state of the cells.
+
+	\param count - neighbor counts of the cells
+	\param alive - current state of the cells
+	*/
+	template <class Word>
+	Word apply(const BitCount<Word>& count, Word alive) const {
+		return (countMatches<Birth, 0>(count) & ~alive) | (countMatches<Survival, 0>(count) & alive);
+	}
+};
+
+/** \brief Rule known only at run time.
+
+Keeps a table of neighbor counts that give a live cell, for each of them countEquals is computed once per word and added to born or survived cells.
+*/
+struct MaskRule {
+	int counts[9];
+	bool isBirth[9], isSurvival[9];
+	int countsSize;
+
+	/** \brief Class constructor with rule masks.
+
+	\param birth - bit n is set if dead cell with n neighbors becomes alive
+	\param survival - bit n is set if alive cell with n neighbors stays alive
+	*/
+	MaskRule(unsigned birth, unsigned survival) {
+		countsSize = 0;
+		for (int n = 0; n <= 8; n++) {
+			if (((birth | survival) >> n) & 1) {
+				counts[countsSize] = n;
+				isBirth[countsSize] = (birth >> n) & 1;
+				isSurvival[countsSize] = (survival >> n) & 1;
+				countsSize++;
+			}
+		}
+	}
+
+	/** \brief Returns next state of the cells.
+
+	\param count - neighbor counts of the cells
+	\param alive - current state of the cells
+	*/
+	template <class Word>
+	Word apply(const BitCount<Word>& count, Word alive) const {
+		Word born = alive & ~alive;
+		Word survived = born;
+		for (int i = 0; i < countsSize; i++) {
+			Word match = countEquals(count, counts[i]);
+			if (isBirth[i]) born = born | match;
+			if (isSurvival[i]) survived = survived | match;
+		}
+		return (born & ~alive) | (survived & alive);
+	}
+};
+
+/** \brief Non-totalistic part of a rule known only at run time, evaluated on the bit planes of the neighbors.
+
+Only the counts of the partial masks are computed here, MaskRule gives the other ones. Cells of one count whose edge neighbors(N, E, S, W) form a given pattern have a known number of alive corners, so at most three corner literals tell the shapes of the pattern from the other shapes of the count: single corners, pairs of corners, or with three alive corners the dead one. Every edge pattern with live shapes of a partial count becomes a term, the edge pattern ANDed with an OR of corner literals that may be inverted, and the terms of one count and state are ORed. If the shapes that stay dead need fewer terms, their terms are ORed and inverted instead. Every term has the same operations without branches and everything is bitwise, so any Word resolves 64 cells per operation.
+*/
+struct IsotropicRule {
+	/** \brief Edge pattern and the corners of its live shapes. */
+	struct Term {
+		unsigned char northSouth, eastWest; /**< Index of the pattern of the N and S neighbors(bit 0 is N) and of the E and W neighbors(bit 0 is E). */
+		unsigned char literals[3]; /**< Corner planes, see apply. */
+		bool isInverted;
+	};
+	/** \brief Terms of one count and state. */
+	struct Group {
+		int neighbors;
+		bool isAlive;
+		bool isInverted; /**< Terms give the shapes that stay dead. */
+		int firstTerm, lastTerm;
+	};
+	static const int deadCorner = 4; /**< Plane of the first dead corner. */
+	static const int firstPair = 8; /**< Plane of the first pair of corners. */
+	static const int noCorner = 14; /**< Empty plane. */
+	Term terms[2 * 7 * 16];
+	Group groups[2 * 7];
+	int groupCount;
+	int termCount;
+	bool hasPairs; /**< Some term has literals of pairs of corners. */
+	const uint64_t* neighborhoods; /**< Next state of every 3x3 neighborhood, for stepRowsIsotropicTable. */
+	MaskRule partialRule; /**< Cells with a partial count, for stepRowsIsotropicTable. */
+	static const int tableTerms = 36; /**< Above this many terms per board word of a Word, looking up the cells with a partial count in neighborhoods is faster. */
+
+	/** \brief Class constructor with the table of a non-totalistic rule.
+
+	\param neighborhoods - next state of every 3x3 neighborhood(LifeRule::getNeighborhoods)
+	\param partialBirth - counts for which only some neighborhoods give birth
+	\param partialSurvival - counts for which only some neighborhoods survive
+	*/
+	IsotropicRule(const uint64_t* neighborhoods, unsigned partialBirth, unsigned partialSurvival) : partialRule(partialBirth, partialSurvival) {
+		this->neighborhoods = neighborhoods;
+		groupCount = 0;
+		hasPairs = false;
+		termCount = 0;
+		for (int isAlive = 0; isAlive <= 1; isAlive++) {
+			unsigned partial = isAlive ? partialSurvival : partialBirth;
+			//counts 0 and 8 have a single shape, so they are never partial
+			for (int neighbors = 1; neighbors <= 7; neighbors++) {
+				if (((partial >> neighbors) & 1) == 0) continue;
+				Term live[16], dead[16];
+				int liveCount = addTerms(neighborhoods, neighbors, isAlive == 1, true, live);
+				int deadCount = addTerms(neighborhoods, neighbors, isAlive == 1, false, dead);
+				Group& group = groups[groupCount++];
+				group.neighbors = neighbors;
+				group.isAlive = isAlive == 1;
+				group.isInverted = deadCount < liveCount;
+				group.firstTerm = termCount;
+				if (group.isInverted) termCount = (int)(copy(dead, dead + deadCount, terms + termCount) - terms);
+				else termCount = (int)(copy(live, live + liveCount, terms + termCount) - terms);
+				group.lastTerm = termCount;
+			}
+		}
+		for (int t = 0; t < termCount; t++) {
+			for (int i = 0; i < 3; i++) hasPairs = hasPairs || (terms[t].literals[i] >= firstPair && terms[t].literals[i] != noCorner);
+		}
+	}
+
+	/** \brief Creates terms of the live or dead shapes of one count and state.
+
+	\param neighborhoods - next state of every 3x3 neighborhood
+	\param neighbors - number of alive neighbors of the shapes
+	\param isAlive - state of the cells
+	\param isLive - true for the shapes that become or stay alive, false for the other ones
+	\param group - gets at most 16 terms, one per edge pattern
+	\return number of terms
+	*/
+	int addTerms(const uint64_t* neighborhoods, int neighbors, bool isAlive, bool isLive, Term* group) {
+		//neighborhood bits of N, E, S, W and of NW, NE, SE, SW
+		static const unsigned edgeBits[4] = { 0x002, 0x020, 0x080, 0x008 };
+		static const unsigned cornerBits[4] = { 0x001, 0x004, 0x100, 0x040 };
+		int groupTermCount = 0;
+		for (unsigned edges = 0; edges < 16; edges++) {
+			int corners = neighbors - popCount(edges);
+			if (corners < 0 || corners > 4) continue;
+			//bit b is set if corner pattern b(bit 0 is NW, then NE, SE, SW) has the right number of corners, or gives a shape of the group
+			unsigned all = 0, selected = 0;
+			for (unsigned b = 0; b < 16; b++) {
+				if (popCount(b) != corners) continue;
+				unsigned neighborhood = isAlive ? 0x010 : 0;
+				for (int i = 0; i < 4; i++) {
+					if ((edges >> i) & 1) neighborhood |= edgeBits[i];
+					if ((b >> i) & 1) neighborhood |= cornerBits[i];
+				}
+				all |= 1u << b;
+				if ((((neighborhoods[neighborhood >> 6] >> (neighborhood & 63)) & 1) != 0) == isLive) selected |= 1u << b;
+			}
+			if (selected == 0) continue;
+			Term& term = group[groupTermCount++];
+			term.northSouth = (unsigned char)((edges & 1) | ((edges >> 1) & 2));
+			term.eastWest = (unsigned char)(((edges >> 1) & 1) | ((edges >> 2) & 2));
+			setCorners(&term, corners, selected, all);
+		}
+		return groupTermCount;
+	}
+
+	/** \brief Sets the corner literals of a term.
+
+	\param term - term of an edge pattern
+	\param corners - number of alive corners of the shapes of the term
+	\param selected - corner patterns of the shapes of the term
+	\param all - every corner pattern with this number of alive corners
+	*/
+	void setCorners(Term* term, int corners, unsigned selected, unsigned all) {
+		fill(term->literals, term->literals + 3, (unsigned char)noCorner);
+		//no literal and inverted matches every pattern
+		term->isInverted = true;
+		if (selected == all) {
+			return;
+		}
+		//with one or two alive corners the pattern is told by them, with three by the dead one, literals of the other patterns are inverted if they are fewer
+		unsigned other = all & ~selected;
+		term->isInverted = popCount(other) < popCount(selected);
+		unsigned patterns = term->isInverted ? other : selected;
+		int literalCount = 0;
+		for (unsigned b = 0; b < 16; b++) {
+			if (((patterns >> b) & 1) == 0) continue;
+			int literal;
+			if (corners == 1) literal = lowestBit(b);
+			else if (corners == 3) literal = deadCorner + lowestBit(15 & ~b);
+			else literal = pairIndex(b);
+			term->literals[literalCount++] = (unsigned char)literal;
+		}
+	}
+
+	/** \brief Returns plane of a pair of corners.
+
+	\param pair - corner pattern with two alive corners
+	*/
+	static int pairIndex(unsigned pair) {
+		static const int pairs[3] = { firstPair, firstPair + 3, firstPair + 5 };
+		int first = lowestBit(pair);
+		return pairs[first] + highestBit(pair) - first - 1;
+	}
+
+	/** \brief Checks if stepRowsIsotropicTable is faster than the terms for a Word.
+
+	Terms cost the same for every cell, the table costs only for cells with a partial count, but one at a time.
+	\param lanes - number of board words in a Word
+	*/
+	bool isTableFaster(int lanes) const {
+		return termCount > tableTerms * lanes;
+	}
+
+	/** \brief Returns cells with a partial count that become or stay alive.
+
+	Corner planes are the alive corners NW, NE, SE and SW, the same corners dead, the pairs of alive corners and an empty plane for unused literals.
+	\param cells - neighbors of the cells
+	\param count - neighbor counts of the cells
+	*/
+	template <class Word>
+	Word apply(const Neighborhood<Word>& cells, const BitCount<Word>& count) const {
+		Word none = cells.center & ~cells.center;
+		Word inversions[2] = { none, ~none };
+		Word corners[15];
+		corners[0] = cells.aboveWest;
+		corners[1] = cells.aboveEast;
+		corners[2] = cells.belowEast;
+		corners[3] = cells.belowWest;
+		for (int i = 0; i < 4; i++) corners[deadCorner + i] = ~corners[i];
+		if (hasPairs) {
+			int pair = firstPair;
+			for (int first = 0; first < 3; first++) {
+				for (int second = first + 1; second < 4; second++) corners[pair++] = corners[first] & corners[second];
+			}
+		}
+		corners[noCorner] = none;
+		Word notAbove = ~cells.above, notBelow = ~cells.below, notEast = ~cells.east, notWest = ~cells.west;
+		Word northSouth[4] = { notAbove & notBelow, cells.above & notBelow, notAbove & cells.below, cells.above & cells.below };
+		Word eastWest[4] = { notEast & notWest, cells.east & notWest, notEast & cells.west, cells.east & cells.west };
+		Word result = none;
+		for (int g = 0; g < groupCount; g++) {
+			const Group& group = groups[g];
+			Word live = none;
+			for (int t = group.firstTerm; t < group.lastTerm; t++) {
+				const Term& term = terms[t];
+				Word match = corners[term.literals[0]] | corners[term.literals[1]] | corners[term.literals[2]];
+				live = live | (northSouth[term.northSouth] & eastWest[term.eastWest] & (match ^ inversions[term.isInverted]));
+			}
+			Word state = cells.center ^ inversions[!group.isAlive];
+			result = result | ((live ^ inversions[group.isInverted]) & state & countEquals(count, group.neighbors));
+		}
+		return result;
+	}
+};
@@ -0,0 +1,386 @@
+#include "LifeRule.h"
+#include <ctype.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+using namespace std;
+/** \class LifeRule
+	\brief Outer-totalistic rule of the game.
+
+	Rule is stored as two bit masks: bit n of birth is set if a dead cell with n alive neighbors becomes alive, bit n of survival is set if an alive cell with n alive neighbors stays alive. Rules are written as B3/S23, the eight game variants are presets of this class.
+	Generations rules(B2/S/C3) have more than two states: an alive cell that doesn't survive starts dying, goes through states 2 to states - 1 one generation at a time and becomes dead, dying cells are not counted as neighbors and can't be born. Rules with 2 states are ordinary rules.
+	Isotropic non-totalistic rules in Hensel notation(B2n3/S23-q) split every count into the shapes its neighbors can form, a letter after a count keeps only the given shapes, a minus keeps all shapes except the given ones. Every rule is compiled into a table of next states of all 512 3x3 neighborhoods, the masks hold the counts for which every shape gives birth or survives, the partial masks the counts that need the table.
+*/
+
+static const char* presetRules[LifeRule::presetCount] = {
+	"B3/S23",
+	"B34/S34",
+	"B368/S245",
+	"B357/S238",
+	"B36/S125",
+	"B345/S5",
+	"B3678/S012345678",
+	"B1/S12345678"
+};
+
+/** \brief Hensel letters of every number of alive neighbors, in the order of the notation. */
+static const char* henselLetters[9] = { "", "ce", "cekain", "cekainyqjr", "cekainyqjrtwz", "cekainyqjr", "cekain", "ce", "" };
+
+/** \brief Alive neighbors of one shape of every letter of counts 1 to 4, shapes of counts 5 to 8 are complements of counts 3 to 0.
+
+Bits are the bits of a neighborhood: NW 0x001, N 0x002, NE 0x004, W 0x008, E 0x020, SW 0x040, S 0x080 and SE 0x100.
+*/
+static const unsigned henselShapes[5][13] = {
+	{ 0 },
+	{ 0x001, 0x002 },
+	{ 0x005, 0x022, 0x102, 0x006, 0x082, 0x101 },
+	{ 0x105, 0x02A, 0x0A1, 0x00B, 0x049, 0x106, 0x085, 0x046, 0x0A4, 0x086 },
+	{ 0x145, 0x0AA, 0x10E, 0x126, 0x186, 0x107, 0x146, 0x066, 0x08E, 0x0A6, 0x087, 0x123, 0x0C6 }
+};
+
+static const char* presetDescriptions[LifeRule::presetCount] = {
+	"Basic Conway rules.",
+	"Many small oscilators and ships.",
+	"Cells die fast, some small oscilators and ships.",
+	"Similar to basic Conway.",
+	"Many oscilators and ships",
+	"Oscilators.",
+	"Growing spots, cells never die.",
+	"Cells create square-like shapes, cells never die."
+};
+
+/** \brief Returns number of alive neighbors in a 3x3 neighborhood, the cell itself(bit 4) is not counted.
+*/
+static int aliveNeighbors(unsigned neighborhood) {
+	int count = 0;
+	for (int bit = 0; bit < 9; bit++) {
+		if (bit != 4 && ((neighborhood >> bit) & 1)) count++;
+	}
+	return count;
+}
+
+/** \brief Returns a neighborhood turned by one of the 8 rotations and reflections of the square.
+
+\param neighborhood - 3x3 neighborhood, bit 3 * (dy + 1) + dx + 1 is the cell at dx, dy
+\param symmetry - bits 0 and 1 are the number of quarter turns, bit 2 flips columns first
+*/
+static unsigned transformNeighborhood(unsigned neighborhood, int symmetry) {
+	unsigned result = 0;
+	for (int bit = 0; bit < 9; bit++) {
+		if (((neighborhood >> bit) & 1) == 0) continue;
+		int dx = bit % 3 - 1;
+		int dy = bit / 3 - 1;
+		if (symmetry & 4) dx = -dx;
+		for (int turn = 0; turn < (symmetry & 3); turn++) {
+			int turned = -dy;
+			dy = dx;
+			dx = turned;
+		}
+		result |= 1u << (3 * (dy + 1) + dx + 1);
+	}
+	return result;
+}
+
+/** \brief Returns the smallest of the 8 rotations and reflections of a neighborhood, equal for all shapes of a letter.
+*/
+static unsigned canonicalNeighborhood(unsigned neighborhood) {
+	unsigned smallest = neighborhood;
+	for (int symmetry = 1; symmetry < 8; symmetry++) {
+		smallest = min(smallest, transformNeighborhood(neighborhood, symmetry));
+	}
+	return smallest;
+}
+
+/** \brief Returns Hensel letter of the alive neighbors of a cell.
+
+\param neighborhood - 3x3 neighborhood, the cell itself is ignored
+\return letter from henselLetters, 0 for 0 and 8 neighbors which have no letters
+*/
+static char henselLetter(unsigned neighborhood) {
+	//letter of every canonical neighborhood, built once on first use
+	static const struct LetterTable {
+		char letters[512];
+		LetterTable() {
+			fill(letters, letters + 512, 0);
+			for (int count = 1; count <= 7; count++) {
+				for (int i = 0; henselLetters[count][i] != 0; i++) {
+					unsigned shape = count <= 4 ? henselShapes[count][i] : 0x1EF & ~henselShapes[8 - count][i];
+					letters[canonicalNeighborhood(shape)] = henselLetters[count][i];
+				}
+			}
+		}
+	} table;
+	return table.letters[canonicalNeighborhood(neighborhood & 0x1EF)];
+}
+
+/** \brief Class default constructor.
+
+	Sets basic Conway rules B3/S23.
+*/
+LifeRule::LifeRule() {
+	this->birth = 0x008;
+	this->survival = 0x00C;
+	this->states = 2;
+	buildTable();
+	buildNeighborhoods();
+}
+
+/** \brief Class constructor with rule masks.
+
+\param birth - bit n is set if dead cell with n neighbors becomes alive
+\param survival - bit n is set if alive cell with n neighbors stays alive
+*/
+LifeRule::LifeRule(unsigned birth, unsigned survival) {
+	this->birth = birth & 0x1FF;
+	this->survival = survival & 0x1FF;
+	this->states = 2;
+	buildTable();
+	buildNeighborhoods();
+}
+
+/** \brief Class constructor of a Generations rule.
+
+\param birth - bit n is set if dead cell with n neighbors becomes alive
+\param survival - bit n is set if alive cell with n neighbors stays alive
+\param states - number of cell states, from 2 to maxStates
+*/
+LifeRule::LifeRule(unsigned birth, unsigned survival, int states) {
+	this->birth = birth & 0x1FF;
+	this->survival = survival & 0x1FF;
+	this->states = states < 2 ? 2 : states > maxStates ? maxStates : states;
+	buildTable();
+	buildNeighborhoods();
+}
+
+/** \brief Class constructor with the next state of every neighborhood, used for non-totalistic rules.
+
+Masks are computed from the table, the rule is totalistic if all neighborhoods with the same count have the same next state.
+\param neighborhoods - 8 words, bit n is the next state of a cell with 3x3 neighborhood n(see nextStateOf)
+*/
+LifeRule::LifeRule(const uint64_t* neighborhoods) {
+	copy(neighborhoods, neighborhoods + 8, this->neighborhoods);
+	this->states = 2;
+	unsigned some[2] = { 0, 0 };
+	unsigned every[2] = { 0x1FF, 0x1FF };
+	for (unsigned n = 0; n < 512; n++) {
+		int isAlive = (n >> 4) & 1;
+		unsigned count = 1u << aliveNeighbors(n);
+		if (nextStateOf(n)) some[isAlive] |= count;
+		else every[isAlive] &= ~count;
+	}
+	this->birth = every[0];
+	this->survival = every[1];
+	this->partialBirth = some[0] & ~every[0];
+	this->partialSurvival = some[1] & ~every[1];
+	this->isTotalistic = partialBirth == 0 && partialSurvival == 0;
+	buildTable();
+}
+
+/** \brief Class equals operator.
+
+Two rules are equal if they have the same next state of every neighborhood and number of states.
+*/
+bool LifeRule::operator==(const LifeRule &rule) const {
+	return equal(neighborhoods, neighborhoods + 8, rule.neighborhoods) && this->states == rule.states;
+}
+
+/** \brief Class not equal operator.
+*/
+bool LifeRule::operator!=(const LifeRule &rule) const {
+	return !(*this == rule);
+}
+
+/** \brief Fills lookup table of next states from the masks.
+*/
+void LifeRule::buildTable() {
+	for (int n = 0; n <= 8; n++) {
+		table[0][n] = (birth >> n) & 1;
+		table[1][n] = (survival >> n) & 1;
+	}
+}
+
+/** \brief Fills table of next states of all neighborhoods from the masks of a totalistic rule.
+*/
+void LifeRule::buildNeighborhoods() {
+	fill(neighborhoods, neighborhoods + 8, 0);
+	for (unsigned n = 0; n < 512; n++) {
+		if (table[(n >> 4) & 1][aliveNeighbors(n)]) neighborhoods[n >> 6] |= (uint64_t)1 << (n & 63);
+	}
+	isTotalistic = true;
+	partialBirth = 0;
+	partialSurvival = 0;
+}
+
+/** \brief Parses rule string.
+
+Accepts B/S notation(B36/S23, letters in any case, S part may come first), the notation used by the game menu, survival/birth(23/36), and both of them with the number of states of a Generations rule(B2/S/C3, 345/2/4).
+Counts may be followed by Hensel letters(B2n3/S23-q), such rules can't have dying states.
+\param text - rule string
+\param rule - pointer to rule which is set if parsing succeeds
+\return true if text is a valid rule
+*/
+bool LifeRule::parse(const string& text, LifeRule* rule) {
+	unsigned birth = 0;
+	unsigned survival = 0;
+	int states = 0;
+	unsigned* current = &survival;
+	bool isStates = false;
+	bool hasStates = false;
+	bool hasLetters = false;
+	bool hasDigits = false;
+	int slashes = 0;
+	//Hensel letters of every count of birth(0) and survival(1)
+	string shapes[2][9];
+	bool isExcluded[2][9] = {};
+	bool isNonTotalistic = false;
+	int lastCount = -1;
+	for (unsigned int i = 0; i < text.size(); i++) {
+		char c = text[i];
+		if (c == ' ' || c == '\t' || c == '\r' || c == '\n') continue;
+		char letter = (char)tolower((unsigned char)c);
+		int section = current == &birth ? 0 : 1;
+		if (lastCount >= 0 && current != NULL && letter != 0 && strchr(henselLetters[lastCount], letter) != NULL) {
+			shapes[section][lastCount] += letter;
+			isNonTotalistic = true;
+			continue;
+		}
+		if (c == '-' && lastCount >= 0 && current != NULL && shapes[section][lastCount].empty()) {
+			isExcluded[section][lastCount] = true;
+			isNonTotalistic = true;
+			continue;
+		}
+		lastCount = -1;
+		if (c == 'B' || c == 'b') {
+			current = &birth;
+			isStates = false;
+			hasLetters = true;
+		}
+		else if (c == 'S' || c == 's') {
+			current = &survival;
+			isStates = false;
+			hasLetters = true;
+		}
+		else if (c == 'C' || c == 'c' || c == 'G' || c == 'g') {
+			current = NULL;
+			isStates = true;
+			hasStates = true;
+			hasLetters = true;
+		}
+		else if (c == '/') {
+			if (++slashes > 2) return false;
+			isStates = !hasLetters && slashes == 2;
+			hasStates = hasStates || isStates;
+			current = hasLetters || isStates ? NULL : &birth;
+		}
+		else if (c >= '0' && c <= '9' && isStates) {
+			states = states * 10 + (c - '0');
+			if (states > maxStates) return false;
+		}
+		else if (c >= '0' && c <= '8') {
+			if (current == NULL) return false;
+			*current |= 1u << (c - '0');
+			hasDigits = true;
+			lastCount = c - '0';
+		}
+		else {
+			return false;
+		}
+	}
+	if (!hasLetters && !hasDigits && slashes == 0) return false;
+	if (hasStates && states < 2) return false;
+	if (!isNonTotalistic) {
+		*rule = LifeRule(birth, survival, hasStates ? states : 2);
+		return true;
+	}
+	if (hasStates && states > 2) return false;
+	uint64_t neighborhoods[8] = {};
+	for (unsigned n = 0; n < 512; n++) {
+		int isAlive = (n >> 4) & 1;
+		int count = aliveNeighbors(n);
+		if ((((isAlive ? survival : birth) >> count) & 1) == 0) continue;
+		const string& letters = shapes[isAlive][count];
+		if (letters.empty() && isExcluded[isAlive][count]) return false;
+		bool isListed = letters.find(henselLetter(n)) != string::npos;
+		if (letters.empty() || isListed != isExcluded[isAlive][count]) neighborhoods[n >> 6] |= (uint64_t)1 << (n & 63);
+	}
+	*rule = LifeRule(neighborhoods);
+	return true;
+}
+
+/** \brief Returns one of the game variants.
+
+\param variant - number of the variant, from 1 to presetCount
+\return rule of the variant, basic Conway rules if variant is out of range
+*/
+LifeRule LifeRule::preset(int variant) {
+	LifeRule rule;
+	if (variant >= 1 && variant <= presetCount) parse(presetRules[variant - 1], &rule);
+	return rule;
+}
+
+/** \brief Returns description of one of the game variants shown in the menu.
+
+\param variant - number of the variant, from 1 to presetCount
+*/
+string LifeRule::presetDescription(int variant) {
+	if (variant < 1 || variant > presetCount) return "";
+	return presetDescriptions[variant - 1];
+}
+
+/** \brief Returns number of the game variant with this rule.
+
+Called by the engines before every step to pick a kernel, so only the masks are compared with the masks of the variants, which are parsed once on first use.
+\return number of the variant, from 1 to presetCount, or 0 if rule is not a preset
+*/
+int LifeRule::presetIndex() const {
+	static const struct PresetMasks {
+		unsigned birth[presetCount], survival[presetCount];
+		PresetMasks() {
+			for (int i = 0; i < presetCount; i++) {
+				LifeRule rule = preset(i + 1);
+				birth[i] = rule.birth;
+				survival[i] = rule.survival;
+			}
+		}
+	} masks;
+	//variants are totalistic rules without dying states, so their masks decide the whole rule
+	if (!isTotalistic || states != 2) return 0;
+	for (int i = 0; i < presetCount; i++) {
+		if (masks.birth[i] == birth && masks.survival[i] == survival) return i + 1;
+	}
+	return 0;
+}
+
+/** \brief Returns letters of the shapes of a count that give birth or survive, with a minus if the excluded shapes are fewer.
+
+\return empty string if every shape of the count does
+*/
+string LifeRule::henselPart(int isAlive, int count) const {
+	string included, excluded;
+	for (int i = 0; henselLetters[count][i] != 0; i++) {
+		char letter = henselLetters[count][i];
+		unsigned shape = count <= 4 ? henselShapes[count][i] : 0x1EF & ~henselShapes[8 - count][i];
+		if (nextStateOf(shape | (isAlive << 4))) included += letter;
+		else excluded += letter;
+	}
+	if (excluded.empty()) return "";
+	return excluded.size() < included.size() ? "-" + excluded : included;
+}
+
+/** \brief Returns rule string in B/S notation, Generations rules in B/S/C notation, non-totalistic rules with Hensel letters.
+*/
+string LifeRule::toString() const {
+	string text = "B";
+	for (int n = 0; n <= 8; n++) {
+		if ((birth >> n) & 1) text += (char)('0' + n);
+		else if ((partialBirth >> n) & 1) text += (char)('0' + n) + henselPart(0, n);
+	}
+	text += "/S";
+	for (int n = 0; n <= 8; n++) {
+		if ((survival >> n) & 1) text += (char)('0' + n);
+		else if ((partialSurvival >> n) & 1) text += (char)('0' + n) + henselPart(1, n);
+	}
+	if (states > 2) text += "/C" + to_string(states);
+	return text;
+}
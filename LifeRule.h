@@ -0,0 +1,90 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+using namespace std;
+
+class LifeRule {
+private:
+	unsigned birth, survival;
+	int states; /**< Number of cell states of a Generations rule, 2 for rules without dying states. */
+	bool table[2][9]; /**< Next state indexed by current state and number of alive neighbors. */
+	uint64_t neighborhoods[8]; /**< Bit n is the next state of a cell with 3x3 neighborhood n, see nextStateOf. */
+	bool isTotalistic; /**< Next state depends only on the number of alive neighbors. */
+	unsigned partialBirth, partialSurvival; /**< Bit n is set if only some neighborhoods with n alive neighbors give birth or survive. */
+
+	void buildTable();
+	void buildNeighborhoods();
+	string henselPart(int, int) const;
+
+public:
+	static const int presetCount = 8;
+	static const int maxStates = 16;
+
+	LifeRule();
+	LifeRule(unsigned, unsigned);
+	LifeRule(unsigned, unsigned, int);
+	explicit LifeRule(const uint64_t*);
+	bool operator==(const LifeRule & rule) const;
+	bool operator!=(const LifeRule & rule) const;
+	static bool parse(const string&, LifeRule*);
+	static LifeRule preset(int);
+	static string presetDescription(int);
+	int presetIndex() const;
+	string toString() const;
+	/** \brief Returns next state of a cell.
+
+	\param isAlive - current state of the cell
+	\param neighbors - number of alive neighbors, from 0 to 8
+	\return true if cell is alive in the next generation
+	*/
+	bool nextState(bool isAlive, int neighbors) const {
+		return table[isAlive][neighbors];
+	}
+	/** \brief Returns next state of a cell from its whole 3x3 neighborhood, works for non-totalistic rules as well.
+
+	\param neighborhood - bits 0 to 2 are the row above(west to east), bits 3 to 5 the row of the cell with the cell in bit 4, bits 6 to 8 the row below
+	\return true if cell is alive in the next generation
+	*/
+	bool nextStateOf(unsigned neighborhood) const {
+		return (neighborhoods[neighborhood >> 6] >> (neighborhood & 63)) & 1;
+	}
+	/** \brief Returns birth mask, bit n is set if dead cell with n neighbors becomes alive.
+
+	For non-totalistic rules bit n is set if every neighborhood with n alive neighbors gives birth.
+	*/
+	unsigned getBirth() const {
+		return birth;
+	}
+	/** \brief Returns survival mask, bit n is set if alive cell with n neighbors stays alive.
+
+	For non-totalistic rules bit n is set if every neighborhood with n alive neighbors survives.
+	*/
+	unsigned getSurvival() const {
+		return survival;
+	}
+	/** \brief Returns number of cell states, 2 for alive and dead, more for Generations rules with dying states.
+	*/
+	int getStates() const {
+		return states;
+	}
+	/** \brief Returns true if next state depends only on the number of alive neighbors, false for rules like B2n3/S23-q.
+	*/
+	bool getIsTotalistic() const {
+		return isTotalistic;
+	}
+	/** \brief Returns counts for which only some neighborhoods give birth, nextStateOf decides for them.
+	*/
+	unsigned getPartialBirth() const {
+		return partialBirth;
+	}
+	/** \brief Returns counts for which only some neighborhoods survive, nextStateOf decides for them.
+	*/
+	unsigned getPartialSurvival() const {
+		return partialSurvival;
+	}
+	/** \brief Returns next-state table of all 512 neighborhoods, 8 words.
+	*/
+	const uint64_t* getNeighborhoods() const {
+		return neighborhoods;
+	}
+};
@@ -0,0 +1,150 @@
+#include "LtlRule.h"
+#include <ctype.h>
+#include <string>
+using namespace std;
+/** \class LtlRule
+	\brief Larger than Life rule, an outer-totalistic rule over a neighborhood of range r.
+
+	Rule is written in the notation of Golly, e.g. Bosco's rule R5,C0,M1,S34..58,B34..45,NM: R is the range, C the number of states(0 or 2, only alive and dead cells are supported), M1 counts the cell itself, an alive cell survives if the count is in the S interval, a dead cell is born if it's in the B interval, and N is the neighborhood, NM for Moore, NN for von Neumann and NC for circular.
+*/
+/** \brief Class default constructor.
+
+	Sets Bosco's rule R5,C0,M1,S34..58,B34..45,NM.
+*/
+LtlRule::LtlRule() {
+	this->range = 5;
+	this->hasCenter = true;
+	this->survivalMin = 34;
+	this->survivalMax = 58;
+	this->birthMin = 34;
+	this->birthMax = 45;
+	this->neighborhood = NEIGHBORHOOD_MOORE;
+}
+
+/** \brief Class constructor with rule parameters.
+
+\param range - range of the neighborhood, from 1 to maxRange
+\param hasCenter - true if the cell itself is counted
+\param survivalMin - smallest count with which an alive cell survives
+\param survivalMax - largest count with which an alive cell survives
+\param birthMin - smallest count with which a dead cell is born
+\param birthMax - largest count with which a dead cell is born
+\param neighborhood - shape of the neighborhood
+*/
+LtlRule::LtlRule(int range, bool hasCenter, int survivalMin, int survivalMax, int birthMin, int birthMax, LtlNeighborhood neighborhood) {
+	this->range = range < 1 ? 1 : range > maxRange ? maxRange : range;
+	this->hasCenter = hasCenter;
+	this->survivalMin = survivalMin;
+	this->survivalMax = survivalMax;
+	this->birthMin = birthMin;
+	this->birthMax = birthMax;
+	this->neighborhood = neighborhood;
+}
+
+/** \brief Class equals operator.
+*/
+bool LtlRule::operator==(const LtlRule& rule) const {
+	return range == rule.range && hasCenter == rule.hasCenter && survivalMin == rule.survivalMin && survivalMax == rule.survivalMax
+		&& birthMin == rule.birthMin && birthMax == rule.birthMax && neighborhood == rule.neighborhood;
+}
+
+/** \brief Class not equal operator.
+*/
+bool LtlRule::operator!=(const LtlRule& rule) const {
+	return !(*this == rule);
+}
+
+/** \brief Reads a number, or an interval written as min..max or min-max.
+
+\return false if text is not a number or an interval
+*/
+static bool parseInterval(const string& text, int* minimum, int* maximum) {
+	size_t separator = text.find("..");
+	size_t length = 2;
+	if (separator == string::npos) {
+		separator = text.find('-');
+		length = 1;
+	}
+	string first = text.substr(0, separator);
+	string last = separator == string::npos ? first : text.substr(separator + length);
+	if (first.empty() || last.empty() || first.size() > 6 || last.size() > 6 || first.find_first_not_of("0123456789") != string::npos || last.find_first_not_of("0123456789") != string::npos) {
+		return false;
+	}
+	*minimum = stoi(first);
+	*maximum = stoi(last);
+	return true;
+}
+
+/** \brief Parses rule string.
+
+Fields are separated by commas and may come in any order, letters in any case. R, S and B are required, C0, M0 and NM are the defaults.
+\param text - rule string like R5,C0,M1,S34..58,B34..45,NM
+\param rule - pointer to rule which is set if parsing succeeds
+\return true if text is a valid rule
+*/
+bool LtlRule::parse(const string& text, LtlRule* rule) {
+	int range = 0;
+	bool hasCenter = false;
+	int survivalMin = -1, survivalMax = -1, birthMin = -1, birthMax = -1;
+	LtlNeighborhood neighborhood = NEIGHBORHOOD_MOORE;
+	size_t start = 0;
+	while (start <= text.size()) {
+		size_t end = text.find(',', start);
+		if (end == string::npos) end = text.size();
+		string field;
+		for (size_t i = start; i < end; i++) {
+			if (!isspace((unsigned char)text[i])) field += (char)toupper((unsigned char)text[i]);
+		}
+		start = end + 1;
+		if (field.empty()) continue;
+		string value = field.substr(1);
+		int minimum, maximum;
+		if (field[0] == 'R' && parseInterval(value, &minimum, &maximum) && minimum == maximum) range = minimum;
+		else if (field[0] == 'C' && parseInterval(value, &minimum, &maximum) && minimum == maximum && (minimum == 0 || minimum == 2)) continue;
+		else if (field[0] == 'M' && (value == "0" || value == "1")) hasCenter = value == "1";
+		else if (field[0] == 'S' && parseInterval(value, &survivalMin, &survivalMax)) continue;
+		else if (field[0] == 'B' && parseInterval(value, &birthMin, &birthMax)) continue;
+		else if (field == "NM") neighborhood = NEIGHBORHOOD_MOORE;
+		else if (field == "NN") neighborhood = NEIGHBORHOOD_VON_NEUMANN;
+		else if (field == "NC") neighborhood = NEIGHBORHOOD_CIRCULAR;
+		else return false;
+	}
+	if (range < 1 || range > maxRange || survivalMin < 0 || birthMin < 0) {
+		return false;
+	}
+	*rule = LtlRule(range, hasCenter, survivalMin, survivalMax, birthMin, birthMax, neighborhood);
+	return true;
+}
+
+/** \brief Returns rule string in the notation of Golly.
+*/
+string LtlRule::toString() const {
+	const char* neighborhoods[] = { "NM", "NN", "NC" };
+	return "R" + to_string(range) + ",C0,M" + (hasCenter ? "1" : "0") + ",S" + to_string(survivalMin) + ".." + to_string(survivalMax)
+		+ ",B" + to_string(birthMin) + ".." + to_string(birthMax) + "," + neighborhoods[neighborhood];
+}
+
+/** \brief Returns half width of the neighborhood in a row.
+
+\param dy - row relative to the cell, from -range to range
+\return cells from -halfWidth to halfWidth of the row are in the neighborhood
+*/
+int LtlRule::halfWidth(int dy) const {
+	if (dy < 0) dy = -dy;
+	if (neighborhood == NEIGHBORHOOD_MOORE) return range;
+	if (neighborhood == NEIGHBORHOOD_VON_NEUMANN) return range - dy;
+	//largest dx with 4 * (dx * dx + dy * dy) < (2 * range + 1)^2
+	int dx = 0;
+	while (4 * ((dx + 1) * (dx + 1) + dy * dy) < (2 * range + 1) * (2 * range + 1)) dx++;
+	return dx;
+}
+
+/** \brief Returns number of cells in the neighborhood, including the cell itself.
+*/
+int LtlRule::neighborhoodSize() const {
+	int size = 0;
+	for (int dy = -range; dy <= range; dy++) {
+		size += 2 * halfWidth(dy) + 1;
+	}
+	return size;
+}
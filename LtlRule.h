@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+using namespace std;
+
+/** \brief Cells counted by a Larger than Life rule, all of them within the range. */
+enum LtlNeighborhood {
+	NEIGHBORHOOD_MOORE, /**< Square, |dx| <= r and |dy| <= r. */
+	NEIGHBORHOOD_VON_NEUMANN, /**< Diamond, |dx| + |dy| <= r. */
+	NEIGHBORHOOD_CIRCULAR /**< Disc, dx * dx + dy * dy < (r + 1/2)^2. */
+};
+
+class LtlRule {
+private:
+	int range;
+	bool hasCenter; /**< Cell itself is counted. */
+	int survivalMin, survivalMax;
+	int birthMin, birthMax;
+	LtlNeighborhood neighborhood;
+
+public:
+	static const int maxRange = 50;
+
+	LtlRule();
+	LtlRule(int, bool, int, int, int, int, LtlNeighborhood);
+	bool operator==(const LtlRule&) const;
+	bool operator!=(const LtlRule&) const;
+	static bool parse(const string&, LtlRule*);
+	string toString() const;
+	int neighborhoodSize() const;
+	int halfWidth(int) const;
+	/** \brief Returns next state of a cell.
+
+	\param isAlive - current state of the cell
+	\param count - number of alive cells in the neighborhood, including the cell if hasCenter is set
+	\return true if cell is alive in the next generation
+	*/
+	bool nextState(bool isAlive, int count) const {
+		return isAlive ? count >= survivalMin && count <= survivalMax : count >= birthMin && count <= birthMax;
+	}
+	/** \brief Returns range of the neighborhood.
+	*/
+	int getRange() const {
+		return range;
+	}
+	/** \brief Returns true if the cell itself is counted.
+	*/
+	bool getHasCenter() const {
+		return hasCenter;
+	}
+	/** \brief Returns shape of the neighborhood.
+	*/
+	LtlNeighborhood getNeighborhood() const {
+		return neighborhood;
+	}
+};
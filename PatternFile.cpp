@@ -0,0 +1,382 @@
+#include "PatternFile.h"
+#include "LifeEngine.h"
+#include "LifeRule.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <limits.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+using namespace std;
+/** \file PatternFile.cpp
+	\brief Reading and writing patterns in RLE, Life 1.06 and plaintext(.cells) formats.
+
+	Files are read in 64 KB chunks and parsed one character at a time, every alive cell goes straight to LifeEngine::setCell, so memory does not depend on the size of the file. Writing collects alive cells of the engine, sorts them by rows and writes them through a 64 KB buffer.
+*/
+
+static const size_t CHUNK_SIZE = 1 << 16;
+
+/** \brief File read in fixed size chunks. */
+struct ChunkReader {
+	FILE* file;
+	vector<char> buffer;
+	size_t position, size;
+	long long bytes;
+
+	ChunkReader(FILE* file) : file(file), buffer(CHUNK_SIZE), position(0), size(0), bytes(0) {
+	}
+
+	/** \brief Returns next character, EOF at the end of the file.
+	*/
+	int get() {
+		if (position == size) {
+			size = fread(&buffer[0], 1, buffer.size(), file);
+			position = 0;
+			bytes += size;
+			if (size == 0) return EOF;
+		}
+		return (unsigned char)buffer[position++];
+	}
+
+	/** \brief Skips the rest of the current line.
+	*/
+	void skipLine() {
+		int c = get();
+		while (c != '\n' && c != EOF) c = get();
+	}
+
+	/** \brief Reads the rest of the current line.
+	*/
+	string readLine() {
+		string line;
+		int c = get();
+		while (c != '\n' && c != EOF) {
+			if (c != '\r') line += (char)c;
+			c = get();
+		}
+		return line;
+	}
+};
+
+/** \brief Alive cells read from a file, placed into the engine at an offset.
+*/
+struct PatternTarget {
+	LifeEngine* engine;
+	long long offsetX, offsetY;
+	PatternStats* stats;
+
+	/** \brief Adds alive cell at pattern coordinates.
+	*/
+	void add(long long x, long long y) {
+		if (stats->cells == 0 || x < stats->minX) stats->minX = x;
+		if (stats->cells == 0 || x > stats->maxX) stats->maxX = x;
+		if (stats->cells == 0 || y < stats->minY) stats->minY = y;
+		if (stats->cells == 0 || y > stats->maxY) stats->maxY = y;
+		stats->cells++;
+		long long boardX = x + offsetX;
+		long long boardY = y + offsetY;
+		if (engine != NULL && boardX >= INT_MIN && boardX <= INT_MAX && boardY >= INT_MIN && boardY <= INT_MAX) {
+			engine->setCell((int)boardX, (int)boardY, true);
+		}
+	}
+};
+
+/** \brief Returns format of a pattern file.
+
+Format is taken from the extension(.rle, .lif or .life, .cells), files with other extensions are recognized by their first lines.
+\param path - path to the file
+\return format of the file, PATTERN_UNKNOWN if it can't be opened or recognized
+*/
+PatternFormat patternFormat(const string& path) {
+	size_t dot = path.find_last_of('.');
+	string extension = dot == string::npos ? "" : path.substr(dot + 1);
+	transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return (char)tolower(c); });
+	if (extension == "rle") return PATTERN_RLE;
+	if (extension == "lif" || extension == "life") return PATTERN_LIFE106;
+	if (extension == "cells") return PATTERN_CELLS;
+	FILE* file = fopen(path.c_str(), "rb");
+	if (file == NULL) {
+		return PATTERN_UNKNOWN;
+	}
+	ChunkReader reader(file);
+	PatternFormat format = PATTERN_UNKNOWN;
+	for (int i = 0; i < 100 && format == PATTERN_UNKNOWN; i++) {
+		int c = reader.get();
+		if (c == EOF) break;
+		if (c == '#') {
+			if (reader.readLine().find("Life 1.06") == 0) format = PATTERN_LIFE106;
+		}
+		else if (c == '!' || c == '.' || c == 'O' || c == '*') format = PATTERN_CELLS;
+		else if (c == 'x') format = PATTERN_RLE;
+		else if (c != '\n' && c != '\r') break;
+	}
+	fclose(file);
+	return format;
+}
+
+/** \brief Parses "x = 3, y = 3, rule = B3/S23" line of a RLE file.
+*/
+static void readRleHeader(const string& line, PatternStats* stats) {
+	size_t start = 0;
+	while (start < line.size()) {
+		size_t end = line.find(',', start);
+		if (end == string::npos) end = line.size();
+		string item = line.substr(start, end - start);
+		size_t equals = item.find('=');
+		if (equals != string::npos) {
+			string key = item.substr(0, equals);
+			string value = item.substr(equals + 1);
+			key.erase(remove(key.begin(), key.end(), ' '), key.end());
+			value.erase(remove(value.begin(), value.end(), ' '), value.end());
+			if (key == "rule") stats->hasRule = LifeRule::parse(value, &stats->rule);
+		}
+		start = end + 1;
+	}
+}
+
+/** \brief Reads body of a RLE file.
+
+Every tag can be preceded by a run count, "b" is a dead cell, "$" ends a row and "!" ends the pattern, any other letter is an alive cell.
+*/
+static void readRle(ChunkReader* reader, PatternTarget* target) {
+	long long x = 0, y = 0, run = 0;
+	bool isLineStart = true;
+	int c;
+	while ((c = reader->get()) != EOF) {
+		if (isLineStart && (c == '#' || c == 'x')) {
+			string line = reader->readLine();
+			if (c == 'x') readRleHeader("x" + line, target->stats);
+			continue;
+		}
+		isLineStart = c == '\n';
+		if (c >= '0' && c <= '9') {
+			run = run * 10 + (c - '0');
+			continue;
+		}
+		long long count = run > 0 ? run : 1;
+		if (c == 'b' || c == '.') {
+			x += count;
+		}
+		else if (c == '$') {
+			y += count;
+			x = 0;
+		}
+		else if (c == '!') {
+			break;
+		}
+		else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+			for (long long i = 0; i < count; i++) target->add(x + i, y);
+			x += count;
+		}
+		else {
+			continue;
+		}
+		run = 0;
+	}
+}
+
+/** \brief Reads a Life 1.06 file, one "x y" pair on every line that is not a comment.
+*/
+static void readLife106(ChunkReader* reader, PatternTarget* target) {
+	int c;
+	while ((c = reader->get()) != EOF) {
+		if (c == '#') {
+			reader->skipLine();
+			continue;
+		}
+		long long numbers[2];
+		long long value = 0;
+		int count = 0;
+		bool isNegative = false, hasDigits = false;
+		while (true) {
+			if (c >= '0' && c <= '9') {
+				value = value * 10 + (c - '0');
+				hasDigits = true;
+			}
+			else {
+				if (hasDigits && count < 2) numbers[count++] = isNegative ? -value : value;
+				value = 0;
+				hasDigits = false;
+				isNegative = c == '-';
+			}
+			if (c == '\n' || c == EOF) break;
+			c = reader->get();
+		}
+		if (count == 2) target->add(numbers[0], numbers[1]);
+		if (c == EOF) break;
+	}
+}
+
+/** \brief Reads a plaintext file, "O" or "*" is an alive cell, lines starting with "!" are comments.
+
+Comment "!Rule: B3/S23" written by writePattern sets the rule.
+*/
+static void readCells(ChunkReader* reader, PatternTarget* target) {
+	long long x = 0, y = 0;
+	bool isLineStart = true;
+	int c;
+	while ((c = reader->get()) != EOF) {
+		if (isLineStart && c == '!') {
+			string line = reader->readLine();
+			if (line.find("Rule:") == 0) {
+				string value = line.substr(5);
+				value.erase(remove(value.begin(), value.end(), ' '), value.end());
+				target->stats->hasRule = LifeRule::parse(value, &target->stats->rule);
+			}
+			continue;
+		}
+		isLineStart = false;
+		if (c == '\n') {
+			x = 0;
+			y++;
+			isLineStart = true;
+		}
+		else if (c == 'O' || c == '*') {
+			target->add(x++, y);
+		}
+		else if (c != '\r') {
+			x++;
+		}
+	}
+}
+
+/** \brief Reads a pattern file into an engine.
+
+Alive cells are added to the cells already in the engine, cells outside the board are ignored by the engine. Rule of the file is returned in stats and is not set in the engine.
+\param path - path to the file
+\param engine - engine that gets the cells, NULL only measures the pattern
+\param x - board column of pattern column 0(left column of RLE and plaintext patterns)
+\param y - board row of pattern row 0
+\param stats - size, bounding box, rule and read time of the pattern
+\return true if the file was read, false if it can't be opened or its format is unknown
+*/
+bool readPattern(const string& path, LifeEngine* engine, long long x, long long y, PatternStats* stats) {
+	auto begin = chrono::steady_clock::now();
+	*stats = PatternStats();
+	stats->minX = stats->minY = 0;
+	stats->maxX = stats->maxY = -1;
+	PatternFormat format = patternFormat(path);
+	FILE* file = format == PATTERN_UNKNOWN ? NULL : fopen(path.c_str(), "rb");
+	if (file == NULL) {
+		return false;
+	}
+	ChunkReader reader(file);
+	PatternTarget target = { engine, x, y, stats };
+	if (format == PATTERN_RLE) readRle(&reader, &target);
+	else if (format == PATTERN_LIFE106) readLife106(&reader, &target);
+	else readCells(&reader, &target);
+	fclose(file);
+	stats->bytes = reader.bytes;
+	stats->seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	return true;
+}
+
+/** \brief Buffered output that breaks RLE lines at 70 characters.
+*/
+struct RleWriter {
+	FILE* file;
+	int lineLength;
+
+	/** \brief Writes a tag with its run count.
+	*/
+	void write(long long count, char tag) {
+		char text[24];
+		int length = sizeof(text);
+		text[--length] = tag;
+		if (count > 1) {
+			for (; count > 0; count /= 10) text[--length] = (char)('0' + count % 10);
+		}
+		if (lineLength + (int)sizeof(text) - length > 70) {
+			fputc('\n', file);
+			lineLength = 0;
+		}
+		fwrite(&text[length], 1, sizeof(text) - length, file);
+		lineLength += sizeof(text) - length;
+	}
+};
+
+/** \brief Writes alive cells of an engine to a pattern file.
+
+RLE and plaintext patterns start at the top left corner of the bounding box of alive cells(stats->minX, stats->minY), Life 1.06 keeps board coordinates.
+\param path - path to the file
+\param engine - engine with the pattern
+\param format - format of the file
+\param stats - size, bounding box and write time of the pattern
+\return true if the file was written
+*/
+bool writePattern(const string& path, LifeEngine* engine, PatternFormat format, PatternStats* stats) {
+	auto begin = chrono::steady_clock::now();
+	*stats = PatternStats();
+	stats->minX = stats->minY = 0;
+	stats->maxX = stats->maxY = -1;
+	if (format == PATTERN_UNKNOWN) {
+		return false;
+	}
+	FILE* file = fopen(path.c_str(), "wb");
+	if (file == NULL) {
+		return false;
+	}
+	vector<char> buffer(CHUNK_SIZE);
+	setvbuf(file, &buffer[0], _IOFBF, buffer.size());
+	//cells sorted by row, then by column
+	vector< pair<int, int> > cells;
+	engine->forEachAlive([&](int x, int y) {
+		cells.push_back(make_pair(y, x));
+	});
+	sort(cells.begin(), cells.end());
+	PatternTarget bounds = { NULL, 0, 0, stats };
+	for (unsigned int i = 0; i < cells.size(); i++) {
+		bounds.add(cells[i].second, cells[i].first);
+	}
+	stats->hasRule = true;
+	stats->rule = engine->getRule();
+	if (format == PATTERN_RLE) {
+		fprintf(file, "#C Generation %lld\n", engine->getGeneration());
+		fprintf(file, "x = %lld, y = %lld, rule = %s\n", stats->maxX - stats->minX + 1, stats->maxY - stats->minY + 1, stats->rule.toString().c_str());
+		RleWriter writer = { file, 0 };
+		long long x = stats->minX, y = stats->minY;
+		for (unsigned int i = 0; i < cells.size();) {
+			if (cells[i].first != y) {
+				writer.write(cells[i].first - y, '$');
+				y = cells[i].first;
+				x = stats->minX;
+			}
+			if (cells[i].second > x) writer.write(cells[i].second - x, 'b');
+			unsigned int end = i + 1;
+			while (end < cells.size() && cells[end].first == y && cells[end].second == cells[end - 1].second + 1) end++;
+			writer.write(end - i, 'o');
+			x = cells[end - 1].second + 1;
+			i = end;
+		}
+		writer.write(1, '!');
+		fputc('\n', file);
+	}
+	else if (format == PATTERN_LIFE106) {
+		fputs("#Life 1.06\n", file);
+		for (unsigned int i = 0; i < cells.size(); i++) {
+			fprintf(file, "%d %d\n", cells[i].second, cells[i].first);
+		}
+	}
+	else {
+		fprintf(file, "!Rule: %s\n!Generation: %lld\n", stats->rule.toString().c_str(), engine->getGeneration());
+		long long y = stats->minY;
+		long long x = stats->minX;
+		for (unsigned int i = 0; i < cells.size(); i++) {
+			for (; y < cells[i].first; y++) {
+				fputc('\n', file);
+				x = stats->minX;
+			}
+			for (; x < cells[i].second; x++) fputc('.', file);
+			fputc('O', file);
+			x++;
+		}
+		if (!cells.empty()) fputc('\n', file);
+	}
+	stats->bytes = ftell(file);
+	bool isWritten = ferror(file) == 0;
+	isWritten = fclose(file) == 0 && isWritten;
+	stats->seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	return isWritten;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "LifeEngine.h"
+#include "LifeRule.h"
+#include <string>
+using namespace std;
+
+/** \brief File format of a pattern. */
+enum PatternFormat {
+	PATTERN_UNKNOWN,
+	PATTERN_RLE, /**< Run length encoded rows, "x = 3, y = 3, rule = B3/S23" header and "bo$2bo$3o!" body. */
+	PATTERN_LIFE106, /**< "#Life 1.06" header and one "x y" line for every alive cell. */
+	PATTERN_CELLS /**< Plaintext, "!" comment lines and rows of "." for dead and "O" for alive cells. */
+};
+
+/** \brief Result of reading or writing a pattern file. */
+struct PatternStats {
+	long long bytes; /**< Size of the file. */
+	long long cells; /**< Number of alive cells. */
+	long long minX, minY, maxX, maxY; /**< Bounding box of alive cells in pattern coordinates, empty if minX > maxX. */
+	bool hasRule; /**< True if the file sets a rule. */
+	LifeRule rule;
+	double seconds; /**< Time spent on the file. */
+};
+
+PatternFormat patternFormat(const string&);
+bool readPattern(const string&, LifeEngine*, long long, long long, PatternStats*);
+bool writePattern(const string&, LifeEngine*, PatternFormat, PatternStats*);
@@ -0,0 +1,253 @@
+#include "SimulationThread.h"
+#include "CommandQueue.h"
+#include "CycleDetector.h"
+#include "DenseEngine.h"
+#include "LifeEngine.h"
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+/** \class SimulationThread
+	\brief Computes generations on its own thread and publishes them to the render thread.
+
+	Boards are published through a lock-free TripleBuffer, so the simulation never waits for the screen and the screen always shows the latest completed generation at its own rate.
+	In normal mode every generation is published and generations are paced to the target rate, rate 0 means as fast as possible. In turbo mode the simulation runs uncapped and only every Nth generation is copied and published. A paused simulation computes only the generations asked for by step.
+	The engine belongs to the thread between start and stop, no other thread may use it then. Cells are edited through a lock-free CommandQueue instead, edits are applied between generations and published at once, also while paused or waiting for the next paced generation, so painting shows up within a frame at any speed.
+*/
+
+static const size_t EDIT_QUEUE_SIZE = 65536; /**< Most edits waiting for the simulation thread, further edits are refused. */
+
+/** \brief Class constructor.
+
+\param engine - engine with the seeded board
+\param onGenerations - called on the simulation thread after every computed step, e.g. to write checkpoints, may be empty
+*/
+SimulationThread::SimulationThread(DenseEngine* engine, const function<void(LifeEngine*)>& onGenerations) : edits(EDIT_QUEUE_SIZE) {
+	this->engine = engine;
+	this->onGenerations = onGenerations;
+	this->isPaused = false;
+	this->pendingSteps = 0;
+	this->isTurbo = false;
+	this->turboGenerations = 1;
+	this->targetRate = 0;
+	this->rate = 0;
+	this->isStopping = false;
+}
+
+/** \brief Class destructor, stops the thread.
+*/
+SimulationThread::~SimulationThread() {
+	stop();
+}
+
+/** \brief Publishes the current board and starts computing generations.
+*/
+void SimulationThread::start() {
+	if (worker.joinable()) {
+		return;
+	}
+	isStopping = false;
+	publish();
+	worker = thread(&SimulationThread::workerLoop, this);
+}
+
+/** \brief Stops computing generations and waits for the thread, engine can be used by the caller again.
+*/
+void SimulationThread::stop() {
+	{
+		lock_guard<mutex> guard(lock);
+		isStopping = true;
+	}
+	wake.notify_all();
+	if (worker.joinable()) {
+		worker.join();
+	}
+}
+
+/** \brief Turns turbo mode on or off.
+
+\param isTurbo - true to compute generations uncapped and publish only some of them
+\param generations - number of generations between published boards in turbo mode
+*/
+void SimulationThread::setTurbo(bool isTurbo, int generations) {
+	{
+		lock_guard<mutex> guard(lock);
+		this->turboGenerations = max(generations, 1);
+		this->isTurbo = isTurbo;
+	}
+	wake.notify_all();
+}
+
+/** \brief Sets number of generations per second in normal mode.
+
+\param targetRate - generations per second, 0 for as fast as possible
+*/
+void SimulationThread::setTargetRate(double targetRate) {
+	{
+		lock_guard<mutex> guard(lock);
+		this->targetRate = max(targetRate, 0.0);
+	}
+	wake.notify_all();
+}
+
+/** \brief Stops or resumes computing generations, the thread keeps applying edits while paused.
+
+\param isPaused - true to pause
+*/
+void SimulationThread::setPaused(bool isPaused) {
+	this->isPaused = isPaused;
+	pendingSteps = 0;
+	notifyWorker();
+}
+
+/** \brief Pauses the simulation and computes one more generation.
+*/
+void SimulationThread::step() {
+	isPaused = true;
+	pendingSteps++;
+	notifyWorker();
+}
+
+/** \brief Sends an edit of one cell to the simulation thread, called by the render thread.
+
+The edit is applied before the next generation and the board is published again, cells outside of the board are ignored by the engine.
+\param x - column of the cell
+\param y - row of the cell
+\param isAlive - new state of the cell
+\return false if too many edits are waiting and the edit was dropped
+*/
+bool SimulationThread::editCell(int x, int y, bool isAlive) {
+	CellEdit edit = { x, y, isAlive };
+	if (!edits.push(edit)) {
+		return false;
+	}
+	notifyWorker();
+	return true;
+}
+
+/** \brief Wakes the thread after a change it waits for.
+
+The lock is taken only for a moment between the change and the notification, so the thread can't check for changes and fall asleep in between. The thread doesn't hold it while stepping.
+*/
+void SimulationThread::notifyWorker() {
+	{
+		lock_guard<mutex> guard(lock);
+	}
+	wake.notify_all();
+}
+
+/** \brief Applies all waiting edits to the engine.
+
+An edited board no longer follows the generations seen by the cycle detector of the engine, so the detector starts again from the edited board.
+\return true if any edit was applied
+*/
+bool SimulationThread::applyEdits() {
+	CellEdit edit;
+	bool isEdited = false;
+	while (edits.pop(&edit)) {
+		engine->setCell(edit.x, edit.y, edit.isAlive);
+		isEdited = true;
+	}
+	CycleDetector* cycles = engine->getCycleDetector();
+	if (isEdited && cycles != NULL) {
+		cycles->reset();
+		cycles->observe(engine->getHash(), engine->getCheckHash(), engine->getGeneration());
+	}
+	return isEdited;
+}
+
+/** \brief Copies the board of the engine to the back slot and publishes it.
+*/
+void SimulationThread::publish() {
+	BoardSnapshot& snapshot = snapshots.getBack();
+	snapshot.width = engine->getWidth();
+	snapshot.height = engine->getHeight();
+	snapshot.wordsPerRow = engine->getWordsPerRow();
+	snapshot.generation = engine->getGeneration();
+	snapshot.words.resize((size_t)snapshot.height * snapshot.wordsPerRow);
+	for (int y = 0; y < snapshot.height; y++) {
+		const uint64_t* row = engine->getRow(y);
+		copy(row, row + snapshot.wordsPerRow, &snapshot.words[(size_t)y * snapshot.wordsPerRow]);
+	}
+	snapshots.publish();
+}
+
+/** \brief Main function of the simulation thread.
+
+Paced generations are scheduled from the time the mode or the rate changed, if the thread falls more than a second behind the schedule starts again, so a slow generation isn't followed by a burst of fast ones. Waiting for the next generation or while paused ends early when edits arrive, they are applied and published without a generation.
+*/
+void SimulationThread::workerLoop() {
+	typedef chrono::steady_clock Clock;
+	Clock::time_point scheduleStart = Clock::now();
+	Clock::time_point next = scheduleStart;
+	long long scheduled = 0;
+	double scheduleRate = -1;
+	Clock::time_point rateStart = Clock::now();
+	long long rateGenerations = 0;
+	unique_lock<mutex> guard(lock);
+	while (!isStopping) {
+		guard.unlock();
+		bool isEdited = applyEdits();
+		bool isTurboStep = isTurbo;
+		int generations = 0;
+		if (isPaused) {
+			if (pendingSteps > 0) {
+				pendingSteps--;
+				generations = 1;
+			}
+		}
+		else if (Clock::now() >= next) {
+			generations = isTurboStep ? turboGenerations.load() : 1;
+		}
+		if (generations > 0) {
+			engine->step(generations);
+			if (onGenerations) onGenerations(engine);
+		}
+		if (generations > 0 || isEdited) publish();
+
+		Clock::time_point now = Clock::now();
+		rateGenerations += generations;
+		double rateSeconds = chrono::duration<double>(now - rateStart).count();
+		if (rateSeconds >= 0.5) {
+			rate = rateGenerations / rateSeconds;
+			rateStart = now;
+			rateGenerations = 0;
+		}
+
+		guard.lock();
+		if (isPaused) {
+			//paced generations start again from the time the game is resumed
+			scheduleRate = -1;
+			rate = 0;
+			wake.wait(guard, [&] { return isStopping || !isPaused || pendingSteps > 0 || !edits.isEmpty(); });
+			continue;
+		}
+		double paceRate = isTurboStep ? 0 : targetRate.load();
+		if (paceRate <= 0) {
+			scheduleRate = -1;
+			next = now;
+			continue;
+		}
+		if (paceRate != scheduleRate) {
+			scheduleStart = now;
+			scheduled = 0;
+			scheduleRate = paceRate;
+		}
+		scheduled += generations;
+		next = scheduleStart + chrono::duration_cast<Clock::duration>(chrono::duration<double>(scheduled / paceRate));
+		if (now - next > chrono::seconds(1)) {
+			scheduleStart = now;
+			scheduled = 0;
+			next = now;
+			continue;
+		}
+		//woken early when the mode changes, the thread stops or an edit arrives
+		wake.wait_until(guard, next, [&] { return isStopping || isPaused || isTurbo || targetRate != paceRate || !edits.isEmpty(); });
+	}
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "CommandQueue.h"
+#include "DenseEngine.h"
+#include "LifeEngine.h"
+#include "TripleBuffer.h"
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+/** \brief Board of one generation published by SimulationThread. */
+struct BoardSnapshot {
+	int width, height;
+	int wordsPerRow;
+	long long generation;
+	vector<uint64_t> words; /**< Rows of the board, bit i of word j is the cell in column 64 * j + i. */
+};
+
+/** \brief Change of one cell sent to SimulationThread. */
+struct CellEdit {
+	int x, y;
+	bool isAlive;
+};
+
+class SimulationThread {
+private:
+	DenseEngine* engine;
+	function<void(LifeEngine*)> onGenerations;
+	TripleBuffer<BoardSnapshot> snapshots;
+	CommandQueue<CellEdit> edits; /**< Edits pushed by the render thread and applied between generations. */
+	atomic<bool> isPaused;
+	atomic<long long> pendingSteps; /**< Generations asked for by step while paused. */
+	atomic<bool> isTurbo;
+	atomic<int> turboGenerations;
+	atomic<double> targetRate;
+	atomic<double> rate;
+	bool isStopping;
+	mutex lock;
+	condition_variable wake;
+	thread worker;
+
+	void publish();
+	bool applyEdits();
+	void notifyWorker();
+	void workerLoop();
+
+public:
+	SimulationThread(DenseEngine*, const function<void(LifeEngine*)>&);
+	~SimulationThread();
+	void start();
+	void stop();
+	void setTurbo(bool, int);
+	/** \brief Returns true if turbo mode is on.
+	*/
+	bool getTurbo() {
+		return isTurbo;
+	}
+	void setTargetRate(double);
+	/** \brief Returns target generations per second in normal mode, 0 for as fast as possible.
+	*/
+	double getTargetRate() {
+		return targetRate;
+	}
+	void setPaused(bool);
+	/** \brief Returns true if no generations are computed until setPaused(false).
+	*/
+	bool getPaused() {
+		return isPaused;
+	}
+	void step();
+	bool editCell(int, int, bool);
+	/** \brief Returns measured generations per second.
+	*/
+	double getRate() {
+		return rate;
+	}
+	/** \brief Takes the latest published generation, called by the render thread.
+
+	\return true if a new generation is available from getSnapshot
+	*/
+	bool update() {
+		return snapshots.update();
+	}
+	/** \brief Returns the latest generation taken by update.
+	*/
+	const BoardSnapshot& getSnapshot() {
+		return snapshots.getFront();
+	}
+};
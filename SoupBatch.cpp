@@ -0,0 +1,271 @@
+#include "SoupBatch.h"
+#include "CycleDetector.h"
+#include "DenseEngine.h"
+#include "LifeEngine.h"
+#include "LifeRule.h"
+#include "SoupGenerator.h"
+#include "ThreadPool.h"
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+using namespace std;
+/** \file SoupBatch.cpp
+	\brief Runs many random soups without a display and aggregates their outcomes.
+
+	Every combination of rule, density, size and seed is one soup. Soups are independent, so each one is a single-threaded DenseEngine and the thread pool runs one soup per task, a thread that finishes its soups steals soups of the others. A soup stops when CycleDetector finds that the board repeats or at the generation cap.
+*/
+
+/** \brief Returns the batch run when no option is given: every game variant, a few densities, one size and 100 seeds.
+*/
+SoupBatch defaultSoupBatch() {
+	SoupBatch batch;
+	for (int i = 1; i <= LifeRule::presetCount; i++) {
+		batch.rules.push_back(LifeRule::preset(i));
+	}
+	batch.densities = { 20, 35, 50 };
+	batch.sizes = { 128 };
+	for (unsigned seed = 1; seed <= 100; seed++) {
+		batch.seeds.push_back(seed);
+	}
+	batch.maxGenerations = 10000;
+	batch.maxPeriod = 60;
+	batch.topology = TOPOLOGY_FRAME;
+	return batch;
+}
+
+/** \brief Splits a comma separated list.
+*/
+static vector<string> splitList(const string& list) {
+	vector<string> items;
+	size_t start = 0;
+	while (start <= list.size()) {
+		size_t end = list.find(',', start);
+		if (end == string::npos) end = list.size();
+		if (end > start) items.push_back(list.substr(start, end - start));
+		start = end + 1;
+	}
+	return items;
+}
+
+/** \brief Parses a list of numbers, ranges like 1-100 are expanded.
+
+\return false if an item is not a number or a range
+*/
+static bool parseNumbers(const string& list, long long minimum, long long maximum, vector<long long>* numbers) {
+	numbers->clear();
+	for (const string& item : splitList(list)) {
+		size_t dash = item.find('-', 1);
+		if (item.find_first_not_of("0123456789-") != string::npos) {
+			return false;
+		}
+		long long first, last;
+		try {
+			first = stoll(item.substr(0, dash));
+			last = dash == string::npos ? first : stoll(item.substr(dash + 1));
+		}
+		catch (...) {
+			return false;
+		}
+		if (first < minimum || last > maximum || first > last) {
+			return false;
+		}
+		for (long long number = first; number <= last; number++) {
+			numbers->push_back(number);
+		}
+	}
+	return !numbers->empty();
+}
+
+/** \brief Reads a batch from options like rules=1,B36/S23 densities=20,50 sizes=128 seeds=1-100.
+
+Options not given keep the values of defaultSoupBatch. Recognized options are rules(variant numbers or B/S rules, Generations rules are not supported), densities(percent of alive cells), sizes(board side), seeds, generations(cap of every soup), period(longest period found), edges(1 to 5 like in the game), threads and output(CSV file with one line per soup).
+\param options - options in the form name=value
+\param batch - parsed batch
+\param threads - parsed number of threads, not changed if the option is not given
+\param output - parsed output path, not changed if the option is not given
+\return false if an option is unknown or its value is invalid, the option is printed to the console
+*/
+bool parseSoupBatch(const vector<string>& options, SoupBatch* batch, int* threads, string* output) {
+	*batch = defaultSoupBatch();
+	for (const string& option : options) {
+		size_t equals = option.find('=');
+		string name = option.substr(0, equals);
+		string value = equals == string::npos ? "" : option.substr(equals + 1);
+		vector<long long> numbers;
+		bool isValid = true;
+		if (name == "rules") {
+			batch->rules.clear();
+			for (const string& item : splitList(value)) {
+				LifeRule rule;
+				if (parseNumbers(item, 1, LifeRule::presetCount, &numbers) && numbers.size() == 1) batch->rules.push_back(LifeRule::preset((int)numbers[0]));
+				else if (LifeRule::parse(item, &rule) && rule.getStates() == 2) batch->rules.push_back(rule);
+				else isValid = false;
+			}
+			isValid = isValid && !batch->rules.empty();
+		}
+		else if (name == "densities") {
+			isValid = parseNumbers(value, 1, 100, &numbers);
+			if (isValid) batch->densities.assign(numbers.begin(), numbers.end());
+		}
+		else if (name == "sizes") {
+			isValid = parseNumbers(value, 3, 1 << 16, &numbers);
+			if (isValid) batch->sizes.assign(numbers.begin(), numbers.end());
+		}
+		else if (name == "seeds") {
+			isValid = parseNumbers(value, 0, 0xFFFFFFFFLL, &numbers);
+			if (isValid) batch->seeds.assign(numbers.begin(), numbers.end());
+		}
+		else if (name == "generations") {
+			isValid = parseNumbers(value, 1, 1LL << 40, &numbers) && numbers.size() == 1;
+			if (isValid) batch->maxGenerations = numbers[0];
+		}
+		else if (name == "period") {
+			isValid = parseNumbers(value, 1, 10000, &numbers) && numbers.size() == 1;
+			if (isValid) batch->maxPeriod = (int)numbers[0];
+		}
+		else if (name == "edges") {
+			isValid = parseNumbers(value, 1, 5, &numbers) && numbers.size() == 1;
+			if (isValid) batch->topology = (Topology)(numbers[0] - 1);
+		}
+		else if (name == "threads") {
+			isValid = parseNumbers(value, 1, 4096, &numbers) && numbers.size() == 1;
+			if (isValid) *threads = (int)numbers[0];
+		}
+		else if (name == "output") {
+			isValid = !value.empty();
+			if (isValid) *output = value;
+		}
+		else {
+			isValid = false;
+		}
+		if (!isValid) {
+			cout << "Invalid batch option " << option << endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+/** \brief Lists every soup of the batch, seeds change fastest.
+*/
+vector<SoupConfig> expandSoupBatch(const SoupBatch& batch) {
+	vector<SoupConfig> soups;
+	for (const LifeRule& rule : batch.rules) {
+		for (int size : batch.sizes) {
+			for (int density : batch.densities) {
+				for (unsigned seed : batch.seeds) {
+					SoupConfig soup = { rule, density, size, seed };
+					soups.push_back(soup);
+				}
+			}
+		}
+	}
+	return soups;
+}
+
+/** \brief Computes one soup until it settles or reaches the generation cap.
+
+Board is filled by SoupGenerator, so soups can run on any thread in any order and a seed always gives the same soup. Generations are computed in chunks, CycleDetector is fed by the engine in every generation and the first generation of the cycle doesn't depend on the chunk size.
+\param soup - rule, density, size and seed of the soup
+\param maxGenerations - generation cap
+\param maxPeriod - longest period that counts as settled
+\param topology - board edges
+\return outcome of the soup
+*/
+SoupResult runSoup(const SoupConfig& soup, long long maxGenerations, int maxPeriod, Topology topology) {
+	const int chunk = 64;
+	auto begin = chrono::steady_clock::now();
+	DenseEngine engine(soup.size, soup.size, soup.rule);
+	engine.setTopology(topology);
+	engine.fillSoup(SoupGenerator(soup.seed, soup.density), 0, 0, soup.size, soup.size);
+	CycleDetector cycles(maxPeriod);
+	engine.setCycleDetector(&cycles);
+	cycles.observe(engine.getHash(), engine.getCheckHash(), engine.getGeneration());
+	while (!cycles.hasCycle() && engine.getGeneration() < maxGenerations) {
+		engine.step((int)min((long long)chunk, maxGenerations - engine.getGeneration()));
+	}
+	SoupResult result;
+	result.config = soup;
+	result.isSettled = cycles.hasCycle();
+	result.isDead = cycles.isDead();
+	result.lifespan = result.isSettled ? cycles.getCycleStart() : maxGenerations;
+	result.period = cycles.getPeriod();
+	result.population = engine.population();
+	result.seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	return result;
+}
+
+/** \brief Runs all soups of the batch in parallel.
+
+\param batch - soups to run
+\param threads - number of threads
+\param onResult - called with every finished soup, calls are serialized but come from any thread in any order
+\return outcomes in the order of expandSoupBatch
+*/
+vector<SoupResult> runSoupBatch(const SoupBatch& batch, int threads, const function<void(const SoupResult&)>& onResult) {
+	vector<SoupConfig> soups = expandSoupBatch(batch);
+	vector<SoupResult> results(soups.size());
+	mutex resultLock;
+	ThreadPool pool(threads);
+	pool.parallelFor((int)soups.size(), [&](int i) {
+		results[i] = runSoup(soups[i], batch.maxGenerations, batch.maxPeriod, batch.topology);
+		if (onResult) {
+			lock_guard<mutex> lock(resultLock);
+			onResult(results[i]);
+		}
+	});
+	return results;
+}
+
+/** \brief Aggregates outcomes of soups with the same rule, size and density.
+
+\param results - outcomes of soups
+\return one summary per rule, size and density in the order of the first soup of each
+*/
+vector<SoupSummary> summarizeSoups(const vector<SoupResult>& results) {
+	vector<SoupSummary> summaries;
+	map<tuple<string, int, int>, int> groups;
+	vector< map<long long, int> > periods;
+	for (const SoupResult& result : results) {
+		tuple<string, int, int> key(result.config.rule.toString(), result.config.size, result.config.density);
+		auto group = groups.find(key);
+		if (group == groups.end()) {
+			SoupSummary summary = {};
+			summary.config = result.config;
+			group = groups.insert(make_pair(key, (int)summaries.size())).first;
+			summaries.push_back(summary);
+			periods.push_back(map<long long, int>());
+		}
+		SoupSummary& summary = summaries[group->second];
+		summary.soups++;
+		summary.meanPopulation += result.population;
+		if (result.isSettled) {
+			summary.settled++;
+			summary.meanLifespan += result.lifespan;
+			summary.maxLifespan = max(summary.maxLifespan, result.lifespan);
+			if (result.isDead) summary.dead++;
+			else if (result.period == 1) summary.stillLifes++;
+			else {
+				summary.oscillators++;
+				periods[group->second][result.period]++;
+			}
+		}
+	}
+	for (unsigned int i = 0; i < summaries.size(); i++) {
+		SoupSummary& summary = summaries[i];
+		summary.meanPopulation /= summary.soups;
+		if (summary.settled > 0) summary.meanLifespan /= summary.settled;
+		summary.periods.assign(periods[i].begin(), periods[i].end());
+		stable_sort(summary.periods.begin(), summary.periods.end(), [](const pair<long long, int>& a, const pair<long long, int>& b) {
+			return a.second > b.second;
+		});
+	}
+	return summaries;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+#include "LifeEngine.h"
+#include "LifeRule.h"
+using namespace std;
+
+/** \brief One random soup of a batch. */
+struct SoupConfig {
+	LifeRule rule;
+	int density; /**< Percent of alive cells, 1 to 100. */
+	int size; /**< Width and height of the board. */
+	unsigned seed; /**< Seed of the random generator, soups with the same seed, density and size start from the same board. */
+};
+
+/** \brief Outcome of one soup. */
+struct SoupResult {
+	SoupConfig config;
+	bool isSettled; /**< Board became dead, a still life or an oscillator before the generation cap. */
+	bool isDead;
+	long long lifespan; /**< First generation of the cycle, or the cap if the soup didn't settle. */
+	long long period; /**< 1 for dead boards and still lifes, 0 if the soup didn't settle. */
+	long long population; /**< Alive cells when the soup stopped. */
+	double seconds;
+};
+
+/** \brief Matrix of soups, every combination of rule, density, size and seed is run. */
+struct SoupBatch {
+	vector<LifeRule> rules;
+	vector<int> densities;
+	vector<int> sizes;
+	vector<unsigned> seeds;
+	long long maxGenerations;
+	int maxPeriod; /**< Longest period that counts as settled. */
+	Topology topology;
+};
+
+/** \brief Aggregated outcomes of the soups with the same rule, density and size. */
+struct SoupSummary {
+	SoupConfig config; /**< Seed is not used. */
+	int soups;
+	int settled;
+	int dead;
+	int stillLifes;
+	int oscillators;
+	double meanPopulation;
+	double meanLifespan; /**< Mean first generation of the cycle of the settled soups. */
+	long long maxLifespan;
+	vector< pair<long long, int> > periods; /**< Periods of the oscillators with their counts, most common first. */
+};
+
+SoupBatch defaultSoupBatch();
+bool parseSoupBatch(const vector<string>&, SoupBatch*, int*, string*);
+vector<SoupConfig> expandSoupBatch(const SoupBatch&);
+SoupResult runSoup(const SoupConfig&, long long, int, Topology);
+vector<SoupResult> runSoupBatch(const SoupBatch&, int, const function<void(const SoupResult&)>&);
+vector<SoupSummary> summarizeSoups(const vector<SoupResult>&);
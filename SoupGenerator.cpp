@@ -0,0 +1,117 @@
+#include "SoupGenerator.h"
+#include "DenseEngine.h"
+#include "LifeEngine.h"
+#include "LifeKernel.h"
+#include <stdint.h>
+#include <chrono>
+#include <random>
+#include <vector>
+using namespace std;
+/** \class SoupGenerator
+	\brief Counter-based generator of random soups.
+
+	A word of 64 cells is a pure function of the seed and its coordinates(column of the word and row), nothing is carried from one word to the next. Words can be generated by any number of threads in any order, a tile can be generated again on demand and a seed always gives the same soup on boards of any size.
+	Random words are SplitMix64 outputs of a counter made of the row, the word column and the draw. Cells are alive with probability threshold / 65536: going over the bits of threshold from the lowest one, a random word is ANDed for a 0 bit and ORed for a 1 bit, so a word costs at most 16 draws and any density costs as much as the position of its lowest set bit allows, e.g. 50% is one draw.
+*/
+/** \brief Class constructor.
+
+\param seed - seed of the soup
+\param density - percent of alive cells, from 0 to 100
+*/
+SoupGenerator::SoupGenerator(uint64_t seed, int density) {
+	this->seed = seed;
+	this->density = density < 0 ? 0 : density > 100 ? 100 : density;
+	this->threshold = (uint32_t)((this->density * 65536 + 50) / 100);
+	this->firstDraw = this->threshold == 0 ? 16 : lowestBit(this->threshold);
+}
+
+/** \brief SplitMix64 finalizer, a bijection that spreads every input bit over the whole word.
+*/
+uint64_t SoupGenerator::mix(uint64_t key) {
+	key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9;
+	key = (key ^ (key >> 27)) * 0x94D049BB133111EB;
+	return key ^ (key >> 31);
+}
+
+/** \brief Returns 64 cells of the soup.
+
+\param wordX - column of the word, cells from wordX * 64 to wordX * 64 + 63 with the first one in the lowest bit
+\param y - row of the cells
+\return alive cells of the word
+*/
+uint64_t SoupGenerator::word(int64_t wordX, int64_t y) const {
+	if (threshold >= 65536) {
+		return ~(uint64_t)0;
+	}
+	uint64_t counter = mix(mix(seed ^ (uint64_t)y * 0x9E3779B97F4A7C15) ^ (uint64_t)wordX * 0xD1B54A32D192ED03);
+	uint64_t cells = 0;
+	for (int draw = firstDraw; draw < 16; draw++) {
+		uint64_t random = mix(counter + (uint64_t)(draw + 1) * 0x9E3779B97F4A7C15);
+		cells = (threshold >> draw) & 1 ? cells | random : cells & random;
+	}
+	return cells;
+}
+
+/** \brief Returns consecutive words of a row.
+
+\param y - row of the cells
+\param firstWord - column of the first word
+\param count - number of words
+\param words - array of count words
+*/
+void SoupGenerator::fillRow(int64_t y, int64_t firstWord, int count, uint64_t* words) const {
+	for (int i = 0; i < count; i++) {
+		words[i] = word(firstWord + i, y);
+	}
+}
+
+/** \brief Returns a tile of 64x64 cells, one word per row like the tiles of TileEngine.
+
+\param tileX - column of the tile, cells from tileX * 64
+\param tileY - row of the tile, cells from tileY * 64
+\param rows - array of 64 words
+*/
+void SoupGenerator::fillTile(int64_t tileX, int64_t tileY, uint64_t* rows) const {
+	for (int i = 0; i < TILE_SIZE; i++) {
+		rows[i] = word(tileX, tileY * TILE_SIZE + i);
+	}
+}
+
+/** \brief Sets alive cells of the soup in a rectangle of the board, other cells are not changed.
+
+DenseEngine writes whole words on all its threads, other engines get the alive cells one by one.
+\param engine - simulation engine
+\param generator - soup
+\param x0 - first column of the rectangle
+\param y0 - first row of the rectangle
+\param x1 - column after the rectangle
+\param y1 - row after the rectangle
+*/
+void fillSoup(LifeEngine* engine, const SoupGenerator& generator, int x0, int y0, int x1, int y1) {
+	if (x0 >= x1 || y0 >= y1) {
+		return;
+	}
+	DenseEngine* dense = dynamic_cast<DenseEngine*>(engine);
+	if (dense != NULL) {
+		dense->fillSoup(generator, x0, y0, x1, y1);
+		return;
+	}
+	for (int y = y0; y < y1; y++) {
+		for (int wordX = x0 >> 6; wordX <= (x1 - 1) >> 6; wordX++) {
+			uint64_t cells = generator.word(wordX, y);
+			while (cells) {
+				int x = wordX * 64 + lowestBit(cells);
+				cells &= cells - 1;
+				if (x >= x0 && x < x1) engine->setCell(x, y, true);
+			}
+		}
+	}
+}
+
+/** \brief Returns a seed for a soup that should differ from run to run, print it to let the soup be repeated.
+*/
+uint64_t newSoupSeed() {
+	random_device device;
+	uint64_t seed = ((uint64_t)device() << 32) ^ device();
+	return SoupGenerator::mix(seed ^ (uint64_t)chrono::steady_clock::now().time_since_epoch().count()) >> 16;
+}
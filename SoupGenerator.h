@@ -0,0 +1,34 @@
+#pragma once
+#include <stdint.h>
+#include "LifeEngine.h"
+using namespace std;
+
+class SoupGenerator {
+private:
+	uint64_t seed;
+	int density;
+	uint32_t threshold; /**< Probability of an alive cell in 1/65536. */
+	int firstDraw; /**< Lowest set bit of threshold, draws below it can't change the word. */
+
+public:
+	static const int TILE_SIZE = 64;
+
+	SoupGenerator(uint64_t, int);
+	static uint64_t mix(uint64_t);
+	uint64_t word(int64_t, int64_t) const;
+	void fillRow(int64_t, int64_t, int, uint64_t*) const;
+	void fillTile(int64_t, int64_t, uint64_t*) const;
+	/** \brief Returns seed of the soup.
+	*/
+	uint64_t getSeed() const {
+		return seed;
+	}
+	/** \brief Returns percent of alive cells.
+	*/
+	int getDensity() const {
+		return density;
+	}
+};
+
+void fillSoup(LifeEngine*, const SoupGenerator&, int, int, int, int);
+uint64_t newSoupSeed();
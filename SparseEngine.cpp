@@ -0,0 +1,229 @@
+#include "SparseEngine.h"
+#include "Cell.h"
+#include "ActiveCellSet.h"
+#include "GenerationStats.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <vector>
+using namespace std;
+/** \class SparseEngine
+	\brief Engine that checks only alive Cells and their neighbors.
+
+	This is the original game algorithm without any drawing. Board is a matrix of Cell objects, with positions stored in cell units(scale 1). Every generation only Cells stored in aliveCellArray are checked, Cells that are going to live are collected in aliveCellArrayBuffer together with their neighbors and the two arrays are swapped.
+	Cells on the outermost ring of the board are the dead frame of the board and never change their state. Rules with B0 are not supported, because Cells without alive neighbors are never checked.
+*/
+/** \brief Class default constructor.
+
+	Creates empty engine, board has to be set with resize.
+*/
+SparseEngine::SparseEngine() {
+	this->isEdited = false;
+}
+
+/** \brief Class constructor with board parameters.
+
+\param width - number of columns of the board
+\param height - number of rows of the board
+\param rule - rule of the game
+*/
+SparseEngine::SparseEngine(int width, int height, const LifeRule& rule) {
+	this->isEdited = false;
+	this->rule = rule;
+	this->resize(width, height);
+}
+
+/** \brief Creates a new dead board.
+
+The purpose of this method is to create Cell matrix from vectors. Each vector 'row' is a vector containing Cell objects.
+\param width - number of columns of the board
+\param height - number of rows of the board
+*/
+void SparseEngine::resize(int width, int height) {
+	this->width = width;
+	this->height = height;
+	vector< vector<Cell> >().swap(cellMatrix);
+	for (int i = 0; i < height; i++) {
+		vector<Cell> row;
+		for (int j = 0; j < width; j++) {
+			//insert cells in row
+			row.push_back(Cell(j, i));
+		}
+		//insert row into matrix
+		cellMatrix.push_back(row);
+	}
+	aliveCellArray.resize(width, height, 1);
+	aliveCellArrayBuffer.resize(width, height, 1);
+	editedCellArray.clear();
+	isEdited = false;
+	generation = 0;
+}
+
+/** \brief Kills every Cell on the board.
+
+Only Cells from aliveCellArray are visited, so clearing costs as much as one generation.
+*/
+void SparseEngine::clear() {
+	syncEdits();
+	for (unsigned int i = 0; i < aliveCellArray.size(); i++) {
+		cellMatrix[aliveCellArray[i].getPosY()][aliveCellArray[i].getPosX()].setAlive(false);
+	}
+	aliveCellArray.clear();
+	aliveCellArrayBuffer.clear();
+	generation = 0;
+}
+
+/** \brief Sets state of a single Cell.
+
+Changes are collected and added to aliveCellArray before the next generation, so any number of Cells can be set between generations. Cells outside the board or on its dead frame are ignored.
+\param x - column of the Cell
+\param y - row of the Cell
+\param alive - true if Cell is going to be alive, false if it's dead
+*/
+void SparseEngine::setCell(int x, int y, bool alive) {
+	if (x < 1 || y < 1 || x > width - 2 || y > height - 2) {
+		return;
+	}
+	cellMatrix[y][x].setAlive(alive);
+	if (alive) {
+		editedCellArray.push_back(cellMatrix[y][x]);
+	}
+	isEdited = true;
+}
+
+/** \brief Returns state of a single Cell.
+
+\param x - column of the Cell
+\param y - row of the Cell
+\return true if Cell is alive, false if it's dead or outside the board
+*/
+bool SparseEngine::getCell(int x, int y) {
+	if (x < 0 || y < 0 || x >= width || y >= height) {
+		return false;
+	}
+	return cellMatrix[y][x].getIsAlive();
+}
+
+/** \brief Adds Cells changed by setCell to aliveCellArray.
+
+Cells in aliveCellArray are copies, so their state is refreshed from cellMatrix first. After that every Cell set alive is added to the array together with its neighbors.
+*/
+void SparseEngine::syncEdits() {
+	if (!isEdited) {
+		return;
+	}
+	for (unsigned int i = 0; i < aliveCellArray.size(); i++) {
+		Cell& current = aliveCellArray[i];
+		current.setAlive(cellMatrix[current.getPosY()][current.getPosX()].getIsAlive());
+	}
+	for (unsigned int i = 0; i < editedCellArray.size(); i++) {
+		Cell& current = cellMatrix[editedCellArray[i].getPosY()][editedCellArray[i].getPosX()];
+		if (current.getIsAlive()) current.addToArray(&aliveCellArray);
+	}
+	for (unsigned int i = 0; i < editedCellArray.size(); i++) {
+		Cell& current = cellMatrix[editedCellArray[i].getPosY()][editedCellArray[i].getPosX()];
+		if (current.getIsAlive()) current.addNeighborsToArray(&cellMatrix, &aliveCellArray, 1);
+	}
+	editedCellArray.clear();
+	isEdited = false;
+}
+
+/** \brief Updates alive status of main Cell matrix based on their status in aliveCellArray
+
+The purpose of this method is to go through aliveCellArray, get every Cell posY and posX and update their status in cellMatrix.
+\param stats - gets births, deaths, population and bounding box of the next generation, NULL if statistics are not collected
+*/
+void SparseEngine::updateMainMatrix(GenerationStats* stats) {
+	if (stats != NULL) {
+		for (unsigned int i = 0; i < aliveCellArray.size(); i++) {
+			int posY = aliveCellArray[i].getPosY();
+			int posX = aliveCellArray[i].getPosX();
+			bool wasAlive = cellMatrix[posY][posX].getIsAlive();
+			bool isAlive = aliveCellArray[i].getIsAlive();
+			if (isAlive && !wasAlive) stats->births++;
+			if (wasAlive && !isAlive) stats->deaths++;
+			if (isAlive) {
+				stats->population++;
+				stats->minX = min(stats->minX, posX);
+				stats->minY = min(stats->minY, posY);
+				stats->maxX = max(stats->maxX, posX);
+				stats->maxY = max(stats->maxY, posY);
+			}
+		}
+	}
+	for (unsigned int i = 0; i < aliveCellArray.size(); i++) {
+		int posY = aliveCellArray[i].getPosY();
+		int posX = aliveCellArray[i].getPosX();
+		cellMatrix[posY][posX].setAlive(aliveCellArray[i].getIsAlive());
+	}
+}
+
+/** \brief Computes next generations.
+
+Calls Cell::countAliveNeighbors for every Cell in aliveCellArray, updates cellMatrix, adds neighbors of Cells that are going to live and swaps the arrays. Arrays are cleared instead of freed, so their memory is reused between generations.
+\param generations - number of generations to compute
+*/
+void SparseEngine::step(int generations) {
+	syncEdits();
+	GenerationStats* stats = NULL;
+#ifdef CONWAY_STATS
+	GenerationStats generationStats;
+	chrono::steady_clock::time_point neighborsTime, updateTime, swapTime;
+#endif
+	for (int g = 0; g < generations; g++) {
+#ifdef CONWAY_STATS
+		if (statsWriter != NULL) {
+			stats = &generationStats;
+			resetStats(stats, generation + 1);
+			stats->activeCells = aliveCellArray.size();
+			neighborsTime = chrono::steady_clock::now();
+		}
+#endif
+		for (unsigned int i = 0; i < aliveCellArray.size(); i++) {
+			aliveCellArray[i].countAliveNeighbors(&cellMatrix, &aliveCellArrayBuffer, 1, rule);
+		}
+		STATS(if (stats != NULL) updateTime = chrono::steady_clock::now();)
+		updateMainMatrix(stats);
+		STATS(if (stats != NULL) swapTime = chrono::steady_clock::now();)
+		int size = aliveCellArrayBuffer.size();
+		for (int i = 0; i < size; i++) {
+			Cell current = aliveCellArrayBuffer[i];
+			current.addNeighborsToArray(&cellMatrix, &aliveCellArrayBuffer, 1);
+		}
+		aliveCellArray.swap(aliveCellArrayBuffer);
+		aliveCellArrayBuffer.clear();
+		generation++;
+#ifdef CONWAY_STATS
+		if (stats != NULL) {
+			stats->phaseSeconds[PHASE_NEIGHBORS] = chrono::duration<double>(updateTime - neighborsTime).count();
+			stats->phaseSeconds[PHASE_UPDATE] = chrono::duration<double>(swapTime - updateTime).count();
+			stats->phaseSeconds[PHASE_SWAP] = chrono::duration<double>(chrono::steady_clock::now() - swapTime).count();
+			statsWriter->write(*stats);
+		}
+#endif
+	}
+}
+
+/** \brief Returns number of alive Cells.
+
+\return number of alive Cells on the board
+*/
+long long SparseEngine::population() {
+	syncEdits();
+	long long count = 0;
+	for (unsigned int i = 0; i < aliveCellArray.size(); i++) {
+		if (aliveCellArray[i].getIsAlive()) count++;
+	}
+	return count;
+}
+
+/** \brief Calls a function for every alive Cell.
+
+\param callback - function called with x and y of every alive Cell
+*/
+void SparseEngine::forEachAlive(const function<void(int, int)>& callback) {
+	syncEdits();
+	for (unsigned int i = 0; i < aliveCellArray.size(); i++) {
+		if (aliveCellArray[i].getIsAlive()) callback(aliveCellArray[i].getPosX(), aliveCellArray[i].getPosY());
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "LifeEngine.h"
+#include "Cell.h"
+#include "ActiveCellSet.h"
+#include <functional>
+#include <vector>
+using namespace std;
+
+struct GenerationStats;
+
+class SparseEngine : public LifeEngine {
+private:
+	vector< vector<Cell> > cellMatrix;
+	ActiveCellSet aliveCellArray; /**< Alive Cells and their neighbors, the only Cells checked in the next generation. */
+	ActiveCellSet aliveCellArrayBuffer;
+	vector<Cell> editedCellArray; /**< Cells set alive by setCell since the last generation. */
+	bool isEdited;
+
+	void syncEdits();
+	void updateMainMatrix(GenerationStats*);
+
+public:
+	SparseEngine();
+	SparseEngine(int, int, const LifeRule&);
+	void resize(int, int);
+	void clear();
+	void setCell(int, int, bool);
+	bool getCell(int, int);
+	void step(int);
+	long long population();
+	void forEachAlive(const function<void(int, int)>&);
+	/** \brief Returns number of Cells checked in the next generation.
+
+	\return size of aliveCellArray(alive Cells and their neighbors)
+	*/
+	long long activeCells() {
+		syncEdits();
+		return aliveCellArray.size();
+	}
+};
@@ -0,0 +1,180 @@
+#include "StepKernels.h"
+#include "LifeKernel.h"
+#include <stdint.h>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+using namespace std;
+/** \file StepKernels.cpp
+	\brief Portable step kernel and choice of the kernel for the current CPU.
+
+	Vector kernels are in StepKernelsAvx2.cpp, StepKernelsAvx512.cpp and StepKernelsNeon.cpp. Each of them is compiled for its instruction set regardless of compiler flags, so the program runs on any CPU and the best kernel is picked when the program starts.
+*/
+
+/** \brief Computes a band of rows one 64-bit word at a time.
+
+This kernel works on every CPU and is the reference for the vector kernels.
+\param args - band of rows
+*/
+void stepRowsScalar(const StepRowsArgs& args) {
+	stepRowsWith<uint64_t, 1>(args);
+}
+
+/** \brief Computes a band of rows of a non-totalistic rule one 64-bit word at a time, looking up cells with a partial count.
+
+Used instead of the terms of IsotropicRule for rules with too many of them(IsotropicRule::isTableFaster). Counts where every neighborhood gives the same next state are applied to the whole word by maskRule like in stepRowsScalar. Only cells with a count from the partial masks are looked up in the neighborhood table. Their index is made of row triples, 3 bits of the rows above, of the cell and below: every row is shifted one column east with the last bit of the previous word, so bits b to b + 2 are the triple of cell b, cells 62 and 63 take theirs from the next word.
+\param args - band of rows with isotropicRule set
+*/
+void stepRowsIsotropicTable(const StepRowsArgs& args) {
+	const uint64_t* neighborhoods = args.isotropicRule->neighborhoods;
+	for (int y = args.firstRow; y < args.lastRow; y++) {
+		const uint64_t* above = &args.board[(y - 1) * args.stride + 1];
+		const uint64_t* row = &args.board[y * args.stride + 1];
+		const uint64_t* below = &args.board[(y + 1) * args.stride + 1];
+		uint64_t* next = &args.boardBuffer[y * args.stride + 1];
+		for (int i = 0; i < args.wordsPerRow; i++) {
+			NeighborCount count;
+			countNeighbors(above + i, row + i, below + i, &count);
+			uint64_t result = args.maskRule->apply(count, row[i]);
+			uint64_t lookup = args.isotropicRule->partialRule.apply(count, row[i]);
+			if (lookup != 0) {
+				uint64_t aboveWest = (above[i] << 1) | (above[i - 1] >> 63);
+				uint64_t west = (row[i] << 1) | (row[i - 1] >> 63);
+				uint64_t belowWest = (below[i] << 1) | (below[i - 1] >> 63);
+				if (lookup >> 62) {
+					//triples of cells 62 and 63 start at bit 0 of these
+					uint64_t aboveEast = (above[i] >> 61) | (above[i + 1] << 3);
+					uint64_t east = (row[i] >> 61) | (row[i + 1] << 3);
+					uint64_t belowEast = (below[i] >> 61) | (below[i + 1] << 3);
+					for (int bit = 62; bit < 64; bit++) {
+						if (((lookup >> bit) & 1) == 0) continue;
+						int shift = bit - 62;
+						unsigned neighborhood = (unsigned)(((aboveEast >> shift) & 7) | (((east >> shift) & 7) << 3) | (((belowEast >> shift) & 7) << 6));
+						result |= ((neighborhoods[neighborhood >> 6] >> (neighborhood & 63)) & 1) << bit;
+					}
+					lookup &= ~((uint64_t)3 << 62);
+				}
+				for (; lookup; lookup &= lookup - 1) {
+					int bit = lowestBit(lookup);
+					unsigned neighborhood = (unsigned)(((aboveWest >> bit) & 7) | (((west >> bit) & 7) << 3) | (((belowWest >> bit) & 7) << 6));
+					result |= ((neighborhoods[neighborhood >> 6] >> (neighborhood & 63)) & 1) << bit;
+				}
+			}
+			next[i] = result;
+		}
+	}
+}
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+/** \brief Checks if the CPU and the operating system support AVX2.
+*/
+static bool cpuHasAvx2() {
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+}
+
+/** \brief Checks if the CPU and the operating system support AVX-512F.
+*/
+static bool cpuHasAvx512() {
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx512f");
+}
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+/** \brief Checks if the operating system saves the given register state(XCR0 bits).
+*/
+static bool osSavesRegisters(unsigned long long mask) {
+	int info[4];
+	__cpuid(info, 1);
+	bool hasXsave = (info[2] & (1 << 27)) != 0;
+	return hasXsave && (_xgetbv(0) & mask) == mask;
+}
+
+/** \brief Checks if the CPU and the operating system support AVX2.
+*/
+static bool cpuHasAvx2() {
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0 && osSavesRegisters(0x6);
+}
+
+/** \brief Checks if the CPU and the operating system support AVX-512F.
+*/
+static bool cpuHasAvx512() {
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 16)) != 0 && osSavesRegisters(0xE6);
+}
+#else
+static bool cpuHasAvx2() {
+	return false;
+}
+
+static bool cpuHasAvx512() {
+	return false;
+}
+#endif
+
+/** \brief Checks if a kernel can run on this CPU.
+
+\param isa - instruction set of the kernel
+*/
+bool isKernelSupported(KernelIsa isa) {
+	switch (isa) {
+	case KERNEL_SCALAR: return true;
+#if defined(__x86_64__) || defined(_M_X64)
+	case KERNEL_AVX2: return cpuHasAvx2();
+	case KERNEL_AVX512: return cpuHasAvx512();
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+	case KERNEL_NEON: return true;
+#endif
+	default: return false;
+	}
+}
+
+/** \brief Returns the fastest kernel supported by this CPU.
+
+Result is computed once, on the first call.
+*/
+KernelIsa bestKernel() {
+	static KernelIsa best = isKernelSupported(KERNEL_AVX512) ? KERNEL_AVX512
+		: isKernelSupported(KERNEL_AVX2) ? KERNEL_AVX2
+		: isKernelSupported(KERNEL_NEON) ? KERNEL_NEON
+		: KERNEL_SCALAR;
+	return best;
+}
+
+/** \brief Returns kernel function of an instruction set.
+
+\param isa - instruction set of the kernel
+\return kernel function, portable kernel if isa is not available in this build
+*/
+StepRowsKernel getStepKernel(KernelIsa isa) {
+	switch (isa) {
+#if defined(__x86_64__) || defined(_M_X64)
+	case KERNEL_AVX2: return stepRowsAvx2;
+	case KERNEL_AVX512: return stepRowsAvx512;
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+	case KERNEL_NEON: return stepRowsNeon;
+#endif
+	default: return stepRowsScalar;
+	}
+}
+
+/** \brief Returns name of an instruction set.
+
+\param isa - instruction set of the kernel
+*/
+const char* kernelName(KernelIsa isa) {
+	switch (isa) {
+	case KERNEL_AVX2: return "avx2";
+	case KERNEL_AVX512: return "avx512";
+	case KERNEL_NEON: return "neon";
+	default: return "scalar";
+	}
+}
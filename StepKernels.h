@@ -0,0 +1,114 @@
+#pragma once
+#include "LifeKernel.h"
+#include <stdint.h>
+using namespace std;
+
+/** \brief Instruction set used by a step kernel. */
+enum KernelIsa {
+	KERNEL_SCALAR,
+	KERNEL_AVX2,
+	KERNEL_AVX512,
+	KERNEL_NEON,
+	KERNEL_COUNT
+};
+
+/** \brief Band of board rows computed by one call of a step kernel.
+
+Rows are indexes in the board buffers(board row + 1), every row has stride words with one empty word on both sides of wordsPerRow board words.
+*/
+struct StepRowsArgs {
+	const uint64_t* board;
+	uint64_t* boardBuffer;
+	int stride, wordsPerRow;
+	int firstRow, lastRow;
+	int preset; /**< Number of the game variant(LifeRule::presetIndex), 0 for any other rule. */
+	const MaskRule* maskRule; /**< Rule used when preset is 0, for a non-totalistic rule the counts where every shape has the same next state. */
+	const IsotropicRule* isotropicRule; /**< Partial counts of a non-totalistic rule, NULL for a totalistic rule. */
+};
+
+typedef void (*StepRowsKernel)(const StepRowsArgs&);
+
+void stepRowsScalar(const StepRowsArgs&);
+void stepRowsIsotropicTable(const StepRowsArgs&);
+#if defined(__x86_64__) || defined(_M_X64)
+void stepRowsAvx2(const StepRowsArgs&);
+void stepRowsAvx512(const StepRowsArgs&);
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+void stepRowsNeon(const StepRowsArgs&);
+#endif
+
+bool isKernelSupported(KernelIsa);
+KernelIsa bestKernel();
+StepRowsKernel getStepKernel(KernelIsa);
+const char* kernelName(KernelIsa);
+
+/** \brief Computes a band of rows with a vector type and a rule kernel.
+
+Word is a type holding Lanes board words. The last vector of a row is moved back so it ends on the last board word, some words are computed twice instead of writing past the row, so rows have to be at least Lanes words wide.
+\param args - band of rows
+\param rule - FixedRule or MaskRule
+*/
+template <class Word, int Lanes, class Rule>
+inline void stepRowsWithRule(const StepRowsArgs& args, const Rule& rule) {
+	for (int y = args.firstRow; y < args.lastRow; y++) {
+		const uint64_t* above = &args.board[(y - 1) * args.stride + 1];
+		const uint64_t* row = &args.board[y * args.stride + 1];
+		const uint64_t* below = &args.board[(y + 1) * args.stride + 1];
+		uint64_t* next = &args.boardBuffer[y * args.stride + 1];
+		for (int i = 0; i < args.wordsPerRow; i += Lanes) {
+			if (i + Lanes > args.wordsPerRow) i = args.wordsPerRow - Lanes;
+			BitCount<Word> count;
+			countNeighbors(above + i, row + i, below + i, &count);
+			storeWords(next + i, rule.apply(count, loadWords<Word>(row + i)));
+		}
+	}
+}
+
+/** \brief Computes a band of rows of a non-totalistic rule with a vector type.
+
+Counts where every shape has the same next state are computed by maskRule, the other ones by isotropicRule from the same neighbor planes.
+\param args - band of rows with isotropicRule set
+*/
+template <class Word, int Lanes>
+inline void stepRowsIsotropicWith(const StepRowsArgs& args) {
+	for (int y = args.firstRow; y < args.lastRow; y++) {
+		const uint64_t* above = &args.board[(y - 1) * args.stride + 1];
+		const uint64_t* row = &args.board[y * args.stride + 1];
+		const uint64_t* below = &args.board[(y + 1) * args.stride + 1];
+		uint64_t* next = &args.boardBuffer[y * args.stride + 1];
+		for (int i = 0; i < args.wordsPerRow; i += Lanes) {
+			if (i + Lanes > args.wordsPerRow) i = args.wordsPerRow - Lanes;
+			Neighborhood<Word> cells;
+			loadNeighborhood(above + i, row + i, below + i, &cells);
+			BitCount<Word> count;
+			countNeighbors(cells, &count);
+			storeWords(next + i, args.maskRule->apply(count, cells.center) | args.isotropicRule->apply(cells, count));
+		}
+	}
+}
+
+/** \brief Computes a band of rows with a vector type.
+
+Picks a FixedRule kernel for the game variants, any other rule uses MaskRule, non-totalistic rules add IsotropicRule or, with too many terms for Lanes words, stepRowsIsotropicTable.
+\param args - band of rows
+*/
+template <class Word, int Lanes>
+inline void stepRowsWith(const StepRowsArgs& args) {
+	if (args.isotropicRule != NULL) {
+		if (args.isotropicRule->isTableFaster(Lanes)) stepRowsIsotropicTable(args);
+		else stepRowsIsotropicWith<Word, Lanes>(args);
+		return;
+	}
+	switch (args.preset) {
+	case 1: stepRowsWithRule<Word, Lanes>(args, FixedRule<0x008, 0x00C>()); break; //B3/S23
+	case 2: stepRowsWithRule<Word, Lanes>(args, FixedRule<0x018, 0x018>()); break; //B34/S34
+	case 3: stepRowsWithRule<Word, Lanes>(args, FixedRule<0x148, 0x034>()); break; //B368/S245
+	case 4: stepRowsWithRule<Word, Lanes>(args, FixedRule<0x0A8, 0x10C>()); break; //B357/S238
+	case 5: stepRowsWithRule<Word, Lanes>(args, FixedRule<0x048, 0x026>()); break; //B36/S125
+	case 6: stepRowsWithRule<Word, Lanes>(args, FixedRule<0x038, 0x020>()); break; //B345/S5
+	case 7: stepRowsWithRule<Word, Lanes>(args, FixedRule<0x1C8, 0x1FF>()); break; //B3678/S012345678
+	case 8: stepRowsWithRule<Word, Lanes>(args, FixedRule<0x002, 0x1FE>()); break; //B1/S12345678
+	default: stepRowsWithRule<Word, Lanes>(args, *args.maskRule); break;
+	}
+}
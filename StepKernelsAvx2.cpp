@@ -0,0 +1,74 @@
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#include <stdint.h>
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+#include "StepKernels.h"
+using namespace std;
+/** \file StepKernelsAvx2.cpp
+	\brief Step kernel computing 4 board words(256 cells) at once with AVX2.
+
+	Whole file is compiled for AVX2, getStepKernel returns this kernel only if the CPU supports it. Only the vector type may be used here, so no function compiled for AVX2 is shared with the rest of the program.
+*/
+
+/** \brief Four board words in one AVX2 register. */
+struct Avx2Word {
+	__m256i v;
+};
+
+inline Avx2Word operator&(Avx2Word a, Avx2Word b) {
+	return Avx2Word{ _mm256_and_si256(a.v, b.v) };
+}
+
+inline Avx2Word operator|(Avx2Word a, Avx2Word b) {
+	return Avx2Word{ _mm256_or_si256(a.v, b.v) };
+}
+
+inline Avx2Word operator^(Avx2Word a, Avx2Word b) {
+	return Avx2Word{ _mm256_xor_si256(a.v, b.v) };
+}
+
+inline Avx2Word operator~(Avx2Word a) {
+	return Avx2Word{ _mm256_xor_si256(a.v, _mm256_set1_epi64x(-1)) };
+}
+
+inline Avx2Word operator<<(Avx2Word a, int bits) {
+	return Avx2Word{ _mm256_sll_epi64(a.v, _mm_cvtsi32_si128(bits)) };
+}
+
+inline Avx2Word operator>>(Avx2Word a, int bits) {
+	return Avx2Word{ _mm256_srl_epi64(a.v, _mm_cvtsi32_si128(bits)) };
+}
+
+template <>
+inline Avx2Word loadWords<Avx2Word>(const uint64_t* words) {
+	return Avx2Word{ _mm256_loadu_si256((const __m256i*)words) };
+}
+
+inline void storeWords(uint64_t* words, Avx2Word value) {
+	_mm256_storeu_si256((__m256i*)words, value.v);
+}
+
+/** \brief Computes a band of rows 4 words at a time.
+
+Boards narrower than 4 words use the portable kernel.
+\param args - band of rows
+*/
+void stepRowsAvx2(const StepRowsArgs& args) {
+	if (args.wordsPerRow < 4) {
+		stepRowsScalar(args);
+		return;
+	}
+	stepRowsWith<Avx2Word, 4>(args);
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+#endif
@@ -0,0 +1,75 @@
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#include <stdint.h>
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+#include "StepKernels.h"
+using namespace std;
+/** \file StepKernelsAvx512.cpp
+	\brief Step kernel computing 8 board words(512 cells) at once with AVX-512F.
+
+	Whole file is compiled for AVX-512F, getStepKernel returns this kernel only if the CPU supports it. Only the vector type may be used here, so no function compiled for AVX-512 is shared with the rest of the program.
+*/
+
+/** \brief Eight board words in one AVX-512 register. */
+struct Avx512Word {
+	__m512i v;
+};
+
+inline Avx512Word operator&(Avx512Word a, Avx512Word b) {
+	return Avx512Word{ _mm512_and_si512(a.v, b.v) };
+}
+
+inline Avx512Word operator|(Avx512Word a, Avx512Word b) {
+	return Avx512Word{ _mm512_or_si512(a.v, b.v) };
+}
+
+inline Avx512Word operator^(Avx512Word a, Avx512Word b) {
+	return Avx512Word{ _mm512_xor_si512(a.v, b.v) };
+}
+
+inline Avx512Word operator~(Avx512Word a) {
+	return Avx512Word{ _mm512_ternarylogic_epi64(a.v, a.v, a.v, 0x55) };
+}
+
+//shifts use the zero-masking form, the unmasked one starts from an undefined register and gives uninitialized warnings in some GCC versions
+inline Avx512Word operator<<(Avx512Word a, int bits) {
+	return Avx512Word{ _mm512_maskz_sllv_epi64((__mmask8)0xFF, a.v, _mm512_set1_epi64(bits)) };
+}
+
+inline Avx512Word operator>>(Avx512Word a, int bits) {
+	return Avx512Word{ _mm512_maskz_srlv_epi64((__mmask8)0xFF, a.v, _mm512_set1_epi64(bits)) };
+}
+
+template <>
+inline Avx512Word loadWords<Avx512Word>(const uint64_t* words) {
+	return Avx512Word{ _mm512_loadu_si512((const void*)words) };
+}
+
+inline void storeWords(uint64_t* words, Avx512Word value) {
+	_mm512_storeu_si512((void*)words, value.v);
+}
+
+/** \brief Computes a band of rows 8 words at a time.
+
+Boards narrower than 8 words use the portable kernel.
+\param args - band of rows
+*/
+void stepRowsAvx512(const StepRowsArgs& args) {
+	if (args.wordsPerRow < 8) {
+		stepRowsScalar(args);
+		return;
+	}
+	stepRowsWith<Avx512Word, 8>(args);
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+#endif
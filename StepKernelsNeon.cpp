@@ -0,0 +1,62 @@
+#if defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#include <stdint.h>
+#include "StepKernels.h"
+using namespace std;
+/** \file StepKernelsNeon.cpp
+	\brief Step kernel computing 2 board words(128 cells) at once with NEON.
+
+	NEON is part of every AArch64 CPU, so this kernel is always available there.
+*/
+
+/** \brief Two board words in one NEON register. */
+struct NeonWord {
+	uint64x2_t v;
+};
+
+inline NeonWord operator&(NeonWord a, NeonWord b) {
+	return NeonWord{ vandq_u64(a.v, b.v) };
+}
+
+inline NeonWord operator|(NeonWord a, NeonWord b) {
+	return NeonWord{ vorrq_u64(a.v, b.v) };
+}
+
+inline NeonWord operator^(NeonWord a, NeonWord b) {
+	return NeonWord{ veorq_u64(a.v, b.v) };
+}
+
+inline NeonWord operator~(NeonWord a) {
+	return NeonWord{ vreinterpretq_u64_u32(vmvnq_u32(vreinterpretq_u32_u64(a.v))) };
+}
+
+inline NeonWord operator<<(NeonWord a, int bits) {
+	return NeonWord{ vshlq_u64(a.v, vdupq_n_s64(bits)) };
+}
+
+inline NeonWord operator>>(NeonWord a, int bits) {
+	return NeonWord{ vshlq_u64(a.v, vdupq_n_s64(-bits)) };
+}
+
+template <>
+inline NeonWord loadWords<NeonWord>(const uint64_t* words) {
+	return NeonWord{ vld1q_u64(words) };
+}
+
+inline void storeWords(uint64_t* words, NeonWord value) {
+	vst1q_u64(words, value.v);
+}
+
+/** \brief Computes a band of rows 2 words at a time.
+
+Boards narrower than 2 words use the portable kernel.
+\param args - band of rows
+*/
+void stepRowsNeon(const StepRowsArgs& args) {
+	if (args.wordsPerRow < 2) {
+		stepRowsScalar(args);
+		return;
+	}
+	stepRowsWith<NeonWord, 2>(args);
+}
+#endif
@@ -0,0 +1,140 @@
+#include "ThreadPool.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+/** \class ThreadPool
+	\brief Persistent pool of threads with work stealing.
+
+	Threads are created once and sleep between jobs. A job is a number of tasks given to parallelFor, tasks are spread over per-thread queues. Every thread takes tasks from the front of its own queue and when it's empty steals from the back of other queues, so threads that finish early help the slow ones.
+	parallelFor returns after all tasks are done, which makes it a barrier between generations. The calling thread works on the job as well.
+*/
+/** \brief Class constructor.
+
+\param threadCount - number of threads that run tasks, including the thread calling parallelFor
+*/
+ThreadPool::ThreadPool(int threadCount) {
+	if (threadCount < 1) threadCount = 1;
+	this->job = NULL;
+	this->remaining = 0;
+	this->batch = 0;
+	this->isStopping = false;
+	for (int i = 0; i < threadCount; i++) {
+		queues.push_back(unique_ptr<TaskQueue>(new TaskQueue()));
+	}
+	for (int i = 1; i < threadCount; i++) {
+		threads.push_back(thread(&ThreadPool::workerLoop, this, i));
+	}
+}
+
+/** \brief Class destructor.
+
+Wakes all threads and waits until they quit.
+*/
+ThreadPool::~ThreadPool() {
+	{
+		lock_guard<mutex> guard(stateLock);
+		isStopping = true;
+	}
+	wake.notify_all();
+	for (unsigned int i = 0; i < threads.size(); i++) {
+		threads[i].join();
+	}
+}
+
+/** \brief Returns number of hardware threads, at least 1.
+*/
+int ThreadPool::defaultThreadCount() {
+	int count = (int)thread::hardware_concurrency();
+	return count > 0 ? count : 1;
+}
+
+/** \brief Takes one task and runs it.
+
+Own queue is checked first, after that other queues are checked starting from the next one.
+\param index - index of the thread
+\return true if a task was run, false if all queues are empty
+*/
+bool ThreadPool::runTask(int index) {
+	int count = (int)queues.size();
+	for (int i = 0; i < count; i++) {
+		TaskQueue& queue = *queues[(index + i) % count];
+		int task;
+		{
+			lock_guard<mutex> guard(queue.lock);
+			if (queue.tasks.empty()) continue;
+			if (i == 0) {
+				task = queue.tasks.front();
+				queue.tasks.pop_front();
+			}
+			else {
+				task = queue.tasks.back();
+				queue.tasks.pop_back();
+			}
+		}
+		(*job)(task);
+		if (remaining.fetch_sub(1) == 1) {
+			lock_guard<mutex> guard(stateLock);
+			finished.notify_all();
+		}
+		return true;
+	}
+	return false;
+}
+
+/** \brief Main function of a pool thread.
+
+Sleeps until a new job is started, runs tasks until there are none left and goes back to sleep.
+\param index - index of the thread
+*/
+void ThreadPool::workerLoop(int index) {
+	unsigned long long seenBatch = 0;
+	while (true) {
+		{
+			unique_lock<mutex> guard(stateLock);
+			wake.wait(guard, [&] { return isStopping || batch != seenBatch; });
+			if (isStopping) return;
+			seenBatch = batch;
+		}
+		while (runTask(index)) {
+		}
+	}
+}
+
+/** \brief Runs task(i) for every i from 0 to count - 1 and waits until all are done.
+
+Tasks are given to the queues in contiguous blocks, so neighboring tasks(e.g. neighboring row bands) start on the same thread.
+\param count - number of tasks
+\param task - function called with index of the task
+*/
+void ThreadPool::parallelFor(int count, const function<void(int)>& task) {
+	if (count <= 0) return;
+	if (queues.size() == 1) {
+		for (int i = 0; i < count; i++) task(i);
+		return;
+	}
+	int threadCount = (int)queues.size();
+	job = &task;
+	remaining = count;
+	for (int t = 0; t < threadCount; t++) {
+		lock_guard<mutex> guard(queues[t]->lock);
+		for (int i = count * t / threadCount; i < count * (t + 1) / threadCount; i++) {
+			queues[t]->tasks.push_back(i);
+		}
+	}
+	{
+		lock_guard<mutex> guard(stateLock);
+		batch++;
+	}
+	wake.notify_all();
+	while (runTask(0)) {
+	}
+	unique_lock<mutex> guard(stateLock);
+	finished.wait(guard, [&] { return remaining.load() == 0; });
+	job = NULL;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+class ThreadPool {
+private:
+	/** \brief Task queue of one thread, other threads steal from its back. */
+	struct TaskQueue {
+		deque<int> tasks;
+		mutex lock;
+	};
+	vector<thread> threads;
+	vector< unique_ptr<TaskQueue> > queues;
+	const function<void(int)>* job;
+	atomic<int> remaining;
+	mutex stateLock;
+	condition_variable wake;
+	condition_variable finished;
+	unsigned long long batch;
+	bool isStopping;
+
+	bool runTask(int);
+	void workerLoop(int);
+
+public:
+	ThreadPool(int);
+	~ThreadPool();
+	void parallelFor(int, const function<void(int)>&);
+	/** \brief Returns number of threads that run tasks, including the calling thread.
+	*/
+	int getThreadCount() {
+		return (int)queues.size();
+	}
+	static int defaultThreadCount();
+};
@@ -0,0 +1,264 @@
+#include "TileEngine.h"
+#include "LifeKernel.h"
+#include "StepKernels.h"
+#include <stdint.h>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+/** \class TileEngine
+	\brief Engine on an unbounded plane that stores only occupied 64x64 tiles.
+
+	Tiles are kept in a hash map keyed by tile coordinates, every tile is 64 bit-packed rows like a piece of DenseEngine board. Before a generation empty tiles are added next to every tile with alive cells on the shared edge, so patterns can grow in any direction, after the generation tiles that became empty are freed. Memory depends on the area covered by alive cells, not on their bounding box, so gliders flying away cost a few tiles each.
+	Every tile is computed by the portable step kernel on a copy of its rows with one row and one word of its neighbors on every side.
+	Plane has no border and no dead frame, width and height only set the window reported by forEachAlive.
+	Rules with birth on 0 neighbors(B0) are not supported, because the plane outside the tiles is never computed and would stay dead, setRule refuses them.
+*/
+/** \brief Class default constructor.
+
+	Creates empty plane with a window of size 0.
+*/
+TileEngine::TileEngine() {
+}
+
+/** \brief Class constructor with window parameters.
+
+\param width - number of columns of the window
+\param height - number of rows of the window
+\param rule - rule of the game, a B0 rule is refused and the basic Conway rules are kept(see setRule)
+*/
+TileEngine::TileEngine(int width, int height, const LifeRule& rule) {
+	this->setRule(rule);
+	this->resize(width, height);
+}
+
+/** \brief Sets rule of the game unless it gives birth on 0 neighbors(B0).
+
+\param rule - one of the variants(LifeRule::preset) or any B/S rule
+\return true if rule was set, false for a B0 rule
+*/
+bool TileEngine::setRule(const LifeRule& rule) {
+	if (rule.nextStateOf(0)) {
+		return false;
+	}
+	this->rule = rule;
+	return true;
+}
+
+/** \brief Sets size of the window and kills every cell.
+
+\param width - number of columns of the window
+\param height - number of rows of the window
+*/
+void TileEngine::resize(int width, int height) {
+	this->width = width;
+	this->height = height;
+	clear();
+}
+
+/** \brief Kills every cell and frees all tiles.
+*/
+void TileEngine::clear() {
+	tiles.clear();
+	generation = 0;
+}
+
+/** \brief Returns key of a tile in the hash map.
+
+\param tileX - column of the tile(cell column / 64, rounded down)
+\param tileY - row of the tile
+*/
+uint64_t TileEngine::tileKey(int tileX, int tileY) {
+	return ((uint64_t)(uint32_t)tileX << 32) | (uint32_t)tileY;
+}
+
+/** \brief Returns a tile if it's allocated.
+
+\param tileX - column of the tile
+\param tileY - row of the tile
+\return pointer to the tile, NULL if it's not allocated
+*/
+TileEngine::Tile* TileEngine::findTile(int tileX, int tileY) {
+	unordered_map<uint64_t, Tile>::iterator found = tiles.find(tileKey(tileX, tileY));
+	return found == tiles.end() ? NULL : &found->second;
+}
+
+/** \brief Returns a tile, an empty one is allocated if it does not exist.
+
+\param tileX - column of the tile
+\param tileY - row of the tile
+*/
+TileEngine::Tile* TileEngine::getTile(int tileX, int tileY) {
+	unordered_map<uint64_t, Tile>::iterator found = tiles.find(tileKey(tileX, tileY));
+	if (found != tiles.end()) {
+		return &found->second;
+	}
+	Tile& tile = tiles[tileKey(tileX, tileY)];
+	fill(tile.rows, tile.rows + TILE_SIZE, 0);
+	return &tile;
+}
+
+/** \brief Sets state of a single cell.
+
+Plane is unbounded, cells outside the window are set as well.
+\param x - column of the cell
+\param y - row of the cell
+\param alive - true if cell is going to be alive, false if it's dead
+*/
+void TileEngine::setCell(int x, int y, bool alive) {
+	Tile* tile = alive ? getTile(x >> 6, y >> 6) : findTile(x >> 6, y >> 6);
+	if (tile == NULL) {
+		return;
+	}
+	uint64_t bit = (uint64_t)1 << (x & 63);
+	if (alive) tile->rows[y & 63] |= bit;
+	else tile->rows[y & 63] &= ~bit;
+}
+
+/** \brief Returns state of a single cell.
+
+\param x - column of the cell
+\param y - row of the cell
+\return true if cell is alive, false if it's dead
+*/
+bool TileEngine::getCell(int x, int y) {
+	Tile* tile = findTile(x >> 6, y >> 6);
+	return tile != NULL && ((tile->rows[y & 63] >> (x & 63)) & 1);
+}
+
+/** \brief Allocates empty tiles next to tiles with alive cells on their edges.
+
+Only neighbors that can get a new cell in the next generation are added, keys are collected first because inserting into the map invalidates its iterators.
+*/
+void TileEngine::addNeighborTiles() {
+	vector< pair<int, int> > missing;
+	for (unordered_map<uint64_t, Tile>::iterator it = tiles.begin(); it != tiles.end(); ++it) {
+		int tileX = (int)(uint32_t)(it->first >> 32);
+		int tileY = (int)(uint32_t)it->first;
+		const uint64_t* rows = it->second.rows;
+		uint64_t columns = 0;
+		for (int y = 0; y < TILE_SIZE; y++) columns |= rows[y];
+		if (columns == 0) continue;
+		bool edges[3][3] = {
+			{ (rows[0] & 1) != 0, rows[0] != 0, (rows[0] >> 63) != 0 },
+			{ (columns & 1) != 0, false, (columns >> 63) != 0 },
+			{ (rows[TILE_SIZE - 1] & 1) != 0, rows[TILE_SIZE - 1] != 0, (rows[TILE_SIZE - 1] >> 63) != 0 }
+		};
+		for (int dy = -1; dy <= 1; dy++) {
+			for (int dx = -1; dx <= 1; dx++) {
+				if (edges[dy + 1][dx + 1] && tiles.find(tileKey(tileX + dx, tileY + dy)) == tiles.end()) {
+					missing.push_back(make_pair(tileX + dx, tileY + dy));
+				}
+			}
+		}
+	}
+	for (unsigned int i = 0; i < missing.size(); i++) {
+		getTile(missing[i].first, missing[i].second);
+	}
+}
+
+/** \brief Computes next generation of a tile.
+
+Rows of the tile and edges of its eight neighbors are copied to a 66 x 3 word board, so the step kernel sees the same layout as in DenseEngine.
+\param tileX - column of the tile
+\param tileY - row of the tile
+\param tile - the tile, result is written to tile->next
+\param board - 66 x 3 word board read by the step kernel
+\param args - rule of the step kernel, board and its buffer
+*/
+void TileEngine::stepTile(int tileX, int tileY, Tile* tile, uint64_t* board, const StepRowsArgs& args) {
+	for (int dx = -1; dx <= 1; dx++) {
+		Tile* above = findTile(tileX + dx, tileY - 1);
+		Tile* side = dx == 0 ? tile : findTile(tileX + dx, tileY);
+		Tile* below = findTile(tileX + dx, tileY + 1);
+		board[dx + 1] = above ? above->rows[TILE_SIZE - 1] : 0;
+		for (int y = 0; y < TILE_SIZE; y++) {
+			board[(y + 1) * 3 + dx + 1] = side ? side->rows[y] : 0;
+		}
+		board[(TILE_SIZE + 1) * 3 + dx + 1] = below ? below->rows[0] : 0;
+	}
+	stepRowsScalar(args);
+	for (int y = 0; y < TILE_SIZE; y++) {
+		tile->next[y] = args.boardBuffer[(y + 1) * 3 + 1];
+	}
+}
+
+/** \brief Moves next generation to the rows of every tile and frees empty tiles.
+*/
+void TileEngine::removeEmptyTiles() {
+	for (unordered_map<uint64_t, Tile>::iterator it = tiles.begin(); it != tiles.end();) {
+		uint64_t columns = 0;
+		for (int y = 0; y < TILE_SIZE; y++) {
+			it->second.rows[y] = it->second.next[y];
+			columns |= it->second.next[y];
+		}
+		if (columns == 0) it = tiles.erase(it);
+		else ++it;
+	}
+}
+
+/** \brief Computes next generations.
+
+\param generations - number of generations to compute
+*/
+void TileEngine::step(int generations) {
+	MaskRule maskRule(rule.getBirth(), rule.getSurvival());
+	IsotropicRule isotropicRule(rule.getNeighborhoods(), rule.getPartialBirth(), rule.getPartialSurvival());
+	vector<uint64_t> board((TILE_SIZE + 2) * 3, 0);
+	vector<uint64_t> boardBuffer((TILE_SIZE + 2) * 3, 0);
+	StepRowsArgs args;
+	args.board = &board[0];
+	args.boardBuffer = &boardBuffer[0];
+	args.stride = 3;
+	args.wordsPerRow = 1;
+	args.firstRow = 1;
+	args.lastRow = TILE_SIZE + 1;
+	args.preset = rule.presetIndex();
+	args.maskRule = &maskRule;
+	args.isotropicRule = rule.getIsTotalistic() ? NULL : &isotropicRule;
+	for (int g = 0; g < generations; g++) {
+		addNeighborTiles();
+		for (unordered_map<uint64_t, Tile>::iterator it = tiles.begin(); it != tiles.end(); ++it) {
+			stepTile((int)(uint32_t)(it->first >> 32), (int)(uint32_t)it->first, &it->second, &board[0], args);
+		}
+		removeEmptyTiles();
+		generation++;
+	}
+}
+
+/** \brief Returns number of alive cells on the whole plane.
+*/
+long long TileEngine::population() {
+	long long count = 0;
+	for (unordered_map<uint64_t, Tile>::iterator it = tiles.begin(); it != tiles.end(); ++it) {
+		for (int y = 0; y < TILE_SIZE; y++) {
+			count += popCount(it->second.rows[y]);
+		}
+	}
+	return count;
+}
+
+/** \brief Calls a function for every alive cell inside the window.
+
+Tiles are visited in the order of the hash map, tiles outside the window are skipped.
+\param callback - function called with x and y of every alive cell
+*/
+void TileEngine::forEachAlive(const function<void(int, int)>& callback) {
+	for (unordered_map<uint64_t, Tile>::iterator it = tiles.begin(); it != tiles.end(); ++it) {
+		long long left = (long long)(int)(uint32_t)(it->first >> 32) * TILE_SIZE;
+		long long top = (long long)(int)(uint32_t)it->first * TILE_SIZE;
+		if (left >= width || top >= height || left + TILE_SIZE <= 0 || top + TILE_SIZE <= 0) {
+			continue;
+		}
+		for (int y = 0; y < TILE_SIZE; y++) {
+			uint64_t word = it->second.rows[y];
+			if (top + y < 0 || top + y >= height) continue;
+			while (word) {
+				long long x = left + lowestBit(word);
+				if (x >= 0 && x < width) callback((int)x, (int)(top + y));
+				word &= word - 1;
+			}
+		}
+	}
+}
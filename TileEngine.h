@@ -0,0 +1,44 @@
+#pragma once
+#include "LifeEngine.h"
+#include "StepKernels.h"
+#include <stdint.h>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+class TileEngine : public LifeEngine {
+private:
+	static const int TILE_SIZE = 64;
+
+	/** \brief Square of 64x64 cells, bit i of rows[y] is the cell in column i of row y. */
+	struct Tile {
+		uint64_t rows[TILE_SIZE];
+		uint64_t next[TILE_SIZE]; /**< Rows of the next generation. */
+	};
+	unordered_map<uint64_t, Tile> tiles; /**< Occupied tiles and their neighbors, keyed by tileKey. */
+
+	static uint64_t tileKey(int, int);
+	Tile* findTile(int, int);
+	Tile* getTile(int, int);
+	void addNeighborTiles();
+	void stepTile(int, int, Tile*, uint64_t*, const StepRowsArgs&);
+	void removeEmptyTiles();
+
+public:
+	TileEngine();
+	TileEngine(int, int, const LifeRule&);
+	void resize(int, int);
+	void clear();
+	void setCell(int, int, bool);
+	bool getCell(int, int);
+	void step(int);
+	long long population();
+	void forEachAlive(const function<void(int, int)>&);
+	bool setRule(const LifeRule&);
+	/** \brief Returns number of allocated tiles.
+	*/
+	long long tileCount() {
+		return (long long)tiles.size();
+	}
+};
@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+using namespace std;
+
+/** \brief Lock-free triple buffer, one thread publishes values and another one reads the latest of them.
+
+Writer fills the back slot and publishes it by swapping it with the middle slot, reader takes the middle slot when it holds a value it hasn't seen. Neither thread ever waits for the other, the writer can publish faster than the reader reads and values in between are skipped. Slots are reused, so a value keeps its allocated memory and filling it again doesn't allocate.
+*/
+template <class T>
+class TripleBuffer {
+private:
+	static const unsigned FRESH = 4; /**< Set in middle when the middle slot was published and not read yet. */
+
+	T slots[3];
+	atomic<unsigned> middle; /**< Index of the middle slot and the FRESH bit. */
+	unsigned back; /**< Slot filled by the writer. */
+	unsigned front; /**< Slot read by the reader. */
+
+public:
+	TripleBuffer() : middle(1), back(0), front(2) {
+	}
+	/** \brief Returns slot the writer fills before publish, only the writer thread may use it.
+	*/
+	T& getBack() {
+		return slots[back];
+	}
+	/** \brief Makes the back slot the latest value, the writer gets another slot to fill.
+	*/
+	void publish() {
+		back = middle.exchange(back | FRESH, memory_order_acq_rel) & ~FRESH;
+	}
+	/** \brief Takes the latest published value if the reader hasn't seen it yet.
+
+	\return true if getFront has changed
+	*/
+	bool update() {
+		if (!(middle.load(memory_order_relaxed) & FRESH)) {
+			return false;
+		}
+		front = middle.exchange(front, memory_order_acq_rel) & ~FRESH;
+		return true;
+	}
+	/** \brief Returns the latest value taken by update, only the reader thread may use it.
+	*/
+	T& getFront() {
+		return slots[front];
+	}
+};
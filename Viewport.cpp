@@ -0,0 +1,223 @@
+#include "Viewport.h"
+#include "DensityPyramid.h"
+#include "FrameBuffer.h"
+#include <stdint.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+using namespace std;
+/** \class Viewport
+	\brief Part of the board shown on the screen, with pan and zoom.
+
+	From 1 to MAX_SCALE pixels per cell every pixel is drawn from the bit of its cell, cells have an outline only from FrameBuffer::GRID_MIN_SCALE pixels up. Zoomed out below 1 pixel per cell every pixel shows the density of a block of cells from DensityPyramid, brighter for more alive cells and never as dark as an empty block if any cell is alive.
+	Every render costs the number of screen pixels plus the update of the pyramid, which recomputes only tiles that changed since the last zoomed out render. Nothing depends on SDL.
+*/
+
+static const uint32_t BACKGROUND = 0xFF202020; /**< Pixels outside of the board. */
+
+/** \brief Mixes two colors.
+
+\param weight - share of the second color from 0 to 1
+*/
+static uint32_t mixColors(uint32_t first, uint32_t second, double weight) {
+	uint32_t color = 0xFF000000;
+	for (int shift = 0; shift < 24; shift += 8) {
+		double channel = ((first >> shift) & 0xFF) * (1 - weight) + ((second >> shift) & 0xFF) * weight;
+		color |= (uint32_t)(channel + 0.5) << shift;
+	}
+	return color;
+}
+
+/** \brief Class constructor, the view starts at the whole board.
+
+\param screenWidth - width of the screen in pixels
+\param screenHeight - height of the screen in pixels
+\param boardWidth - number of board columns
+\param boardHeight - number of board rows
+\param scale - pixels per cell of the starting view
+*/
+Viewport::Viewport(int screenWidth, int screenHeight, int boardWidth, int boardHeight, int scale) {
+	this->screenWidth = screenWidth;
+	this->screenHeight = screenHeight;
+	this->homeScale = max(1, min(MAX_SCALE, scale));
+	this->pixels.assign((size_t)screenWidth * screenHeight, BACKGROUND);
+	for (int density = 0; density < 256; density++) {
+		densityColors[density] = density == 0 ? FrameBuffer::DEAD_FILL : mixColors(FrameBuffer::DEAD_FILL, FrameBuffer::ALIVE_OUTLINE, 0.25 + 0.75 * sqrt(density / 255.0));
+	}
+	this->setBoardSize(boardWidth, boardHeight);
+}
+
+/** \brief Changes size of the board and goes back to the starting view.
+
+\param boardWidth - number of board columns
+\param boardHeight - number of board rows
+*/
+void Viewport::setBoardSize(int boardWidth, int boardHeight) {
+	this->boardWidth = boardWidth;
+	this->boardHeight = boardHeight;
+	int level = 1;
+	while (level < 30 && ((long long)1 << level) < max(boardWidth, boardHeight)) level++;
+	this->minZoom = 1 - level;
+	reset();
+}
+
+/** \brief Goes back to the whole board at the starting scale.
+*/
+void Viewport::reset() {
+	zoom = homeScale;
+	originX = 0;
+	originY = 0;
+}
+
+/** \brief Keeps the center of the screen on the board.
+*/
+void Viewport::clampOrigin() {
+	double pixelsPerCell = getPixelsPerCell();
+	double halfWidth = screenWidth / pixelsPerCell / 2;
+	double halfHeight = screenHeight / pixelsPerCell / 2;
+	originX = min(max(originX + halfWidth, 0.0), (double)boardWidth) - halfWidth;
+	originY = min(max(originY + halfHeight, 0.0), (double)boardHeight) - halfHeight;
+}
+
+/** \brief Zooms in or out keeping the cell under a point of the screen in place.
+
+Steps above 1 pixel per cell grow by a quarter of the scale, at least one pixel, below 1 pixel per cell every step halves or doubles the block size.
+\param x - column of the point on the screen
+\param y - row of the point on the screen
+\param steps - positive to zoom in, negative to zoom out
+*/
+void Viewport::zoomAt(int x, int y, int steps) {
+	double cellX = originX + x / getPixelsPerCell();
+	double cellY = originY + y / getPixelsPerCell();
+	for (; steps > 0 && zoom < MAX_SCALE; steps--) {
+		zoom = zoom >= 1 ? min(MAX_SCALE, max(zoom + 1, zoom * 5 / 4)) : zoom + 1;
+	}
+	for (; steps < 0 && zoom > minZoom; steps++) {
+		zoom = zoom > 1 ? max(1, min(zoom - 1, zoom * 4 / 5)) : zoom - 1;
+	}
+	originX = cellX - x / getPixelsPerCell();
+	originY = cellY - y / getPixelsPerCell();
+	clampOrigin();
+}
+
+/** \brief Moves the board on the screen.
+
+\param dx - pixels to move the board right, negative to the left
+\param dy - pixels to move the board down, negative up
+*/
+void Viewport::pan(int dx, int dy) {
+	originX -= dx / getPixelsPerCell();
+	originY -= dy / getPixelsPerCell();
+	clampOrigin();
+}
+
+/** \brief Finds the cell under a point of the screen, the same cell render draws there.
+
+Zoomed out below 1 pixel per cell it is the top left cell of the block of the pixel.
+\param x - column of the point on the screen
+\param y - row of the point on the screen
+\param cellX - column of the cell
+\param cellY - row of the cell
+\return false if the point is outside of the board
+*/
+bool Viewport::cellAt(int x, int y, int* cellX, int* cellY) {
+	long long cell[2];
+	double origins[2] = { originX, originY };
+	int pixels[2] = { x, y };
+	for (int axis = 0; axis < 2; axis++) {
+		if (zoom >= 1) {
+			long long pixel = (long long)floor(origins[axis] * zoom + 1e-6) + pixels[axis];
+			cell[axis] = pixel >= 0 ? pixel / zoom : (pixel - zoom + 1) / zoom;
+		}
+		else {
+			long long block = (long long)1 << (1 - zoom);
+			cell[axis] = ((long long)floor(origins[axis] / block) + pixels[axis]) * block;
+		}
+	}
+	if (cell[0] < 0 || cell[0] >= boardWidth || cell[1] < 0 || cell[1] >= boardHeight) {
+		return false;
+	}
+	*cellX = (int)cell[0];
+	*cellY = (int)cell[1];
+	return true;
+}
+
+/** \brief Finds the cell or block shown in every column or row of the screen.
+
+\param origin - board position of the first pixel in cells
+\param pixelCount - width or height of the screen
+\param cellCount - width or height of the board
+\param cells - cell or block of every pixel, -1 outside of the board
+\param edges - pixels on the outline of a cell
+*/
+void Viewport::mapAxis(double origin, int pixelCount, int cellCount, vector<int>* cells, vector<unsigned char>* edges) {
+	cells->resize(pixelCount);
+	edges->assign(pixelCount, 0);
+	if (zoom >= 1) {
+		long long offset = (long long)floor(origin * zoom + 1e-6); //origin moved by whole pixels must not round down
+		bool hasGrid = zoom >= FrameBuffer::GRID_MIN_SCALE;
+		for (int i = 0; i < pixelCount; i++) {
+			long long pixel = offset + i;
+			long long cell = pixel >= 0 ? pixel / zoom : (pixel - zoom + 1) / zoom;
+			int within = (int)(pixel - cell * zoom);
+			(*cells)[i] = cell >= 0 && cell < cellCount ? (int)cell : -1;
+			(*edges)[i] = hasGrid && (within == 0 || within == zoom - 1);
+		}
+		return;
+	}
+	int level = 1 - zoom;
+	long long first = (long long)floor(origin / ((long long)1 << level));
+	long long blocks = ((long long)cellCount + ((long long)1 << level) - 1) >> level;
+	for (int i = 0; i < pixelCount; i++) {
+		long long block = first + i;
+		(*cells)[i] = block >= 0 && block < blocks ? (int)block : -1;
+	}
+}
+
+/** \brief Draws the visible part of a board into the pixels.
+
+\param words - rows of the board, bit i of word j is the cell in column 64 * j + i
+\param width - number of board columns
+\param height - number of board rows
+\param wordsPerRow - words in one row of words
+*/
+void Viewport::render(const uint64_t* words, int width, int height, int wordsPerRow) {
+	if (width != boardWidth || height != boardHeight) {
+		setBoardSize(width, height);
+	}
+	mapAxis(originX, screenWidth, boardWidth, &columnCells, &columnEdges);
+	mapAxis(originY, screenHeight, boardHeight, &rowCells, &rowEdges);
+	if (zoom >= 1) {
+		const uint32_t colors[4] = { FrameBuffer::DEAD_FILL, FrameBuffer::DEAD_OUTLINE, FrameBuffer::ALIVE_FILL, FrameBuffer::ALIVE_OUTLINE };
+		for (int y = 0; y < screenHeight; y++) {
+			uint32_t* out = &pixels[(size_t)y * screenWidth];
+			if (rowCells[y] < 0) {
+				fill(out, out + screenWidth, BACKGROUND);
+				continue;
+			}
+			const uint64_t* row = &words[(size_t)rowCells[y] * wordsPerRow];
+			for (int x = 0; x < screenWidth; x++) {
+				int cell = columnCells[x];
+				if (cell < 0) {
+					out[x] = BACKGROUND;
+					continue;
+				}
+				int isAlive = (row[cell >> 6] >> (cell & 63)) & 1;
+				out[x] = colors[isAlive * 2 + (rowEdges[y] | columnEdges[x])];
+			}
+		}
+		return;
+	}
+	int level = 1 - zoom;
+	pyramid.update(words, width, height, wordsPerRow);
+	for (int y = 0; y < screenHeight; y++) {
+		uint32_t* out = &pixels[(size_t)y * screenWidth];
+		if (rowCells[y] < 0) {
+			fill(out, out + screenWidth, BACKGROUND);
+			continue;
+		}
+		for (int x = 0; x < screenWidth; x++) {
+			out[x] = columnCells[x] < 0 ? BACKGROUND : densityColors[pyramid.density(level, columnCells[x], rowCells[y])];
+		}
+	}
+}
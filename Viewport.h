@@ -0,0 +1,59 @@
+#pragma once
+#include "DensityPyramid.h"
+#include <stdint.h>
+#include <vector>
+using namespace std;
+
+class Viewport {
+private:
+	static const int MAX_SCALE = 32;
+
+	int screenWidth, screenHeight;
+	int boardWidth, boardHeight;
+	int homeScale; /**< Pixels per cell of the view of the whole board the game starts with. */
+	int zoom; /**< Pixels per cell if at least 1, otherwise every pixel shows a block of DensityPyramid level 1 - zoom. */
+	int minZoom; /**< Zoom of the level whose single block covers the board. */
+	double originX, originY; /**< Board position of the top left corner of the screen in cells. */
+	vector<uint32_t> pixels; /**< ARGB8888 pixels of the screen. */
+	vector<int> columnCells, rowCells; /**< Cell or block shown in every column and row of the screen, -1 outside of the board. */
+	vector<unsigned char> columnEdges, rowEdges; /**< Columns and rows of the screen on the outline of a cell. */
+	uint32_t densityColors[256];
+	DensityPyramid pyramid;
+
+	void clampOrigin();
+	void mapAxis(double, int, int, vector<int>*, vector<unsigned char>*);
+
+public:
+	Viewport(int, int, int, int, int);
+	void setBoardSize(int, int);
+	void reset();
+	void zoomAt(int, int, int);
+	void pan(int, int);
+	bool cellAt(int, int, int*, int*);
+	void render(const uint64_t*, int, int, int);
+	/** \brief Returns true if the view shows the whole board at the starting scale, like the game before any zoom or pan.
+	*/
+	bool isHome() {
+		return zoom == homeScale && originX == 0 && originY == 0;
+	}
+	/** \brief Returns pixels per cell, below 1 when zoomed out.
+	*/
+	double getPixelsPerCell() {
+		return zoom >= 1 ? zoom : 1.0 / ((long long)1 << (1 - zoom));
+	}
+	/** \brief Returns pixels of the last render, row after row.
+	*/
+	const uint32_t* getPixels() {
+		return pixels.data();
+	}
+	/** \brief Returns bytes between the starts of two pixel rows.
+	*/
+	int getPitch() {
+		return screenWidth * (int)sizeof(uint32_t);
+	}
+	/** \brief Returns pyramid of the board used when zoomed out.
+	*/
+	DensityPyramid& getPyramid() {
+		return pyramid;
+	}
+};
@@ -0,0 +1,845 @@
+#include "SparseEngine.h"
+#include "DenseEngine.h"
+#include "DomainDecomposition.h"
+#include "GenerationsEngine.h"
+#include "LargerThanLifeEngine.h"
+#include "HashLifeEngine.h"
+#include "TileEngine.h"
+#include "PatternFile.h"
+#include "Checkpoint.h"
+#include "FrameBuffer.h"
+#include "FrameExporter.h"
+#include "Viewport.h"
+#include "CycleDetector.h"
+#include "GenerationStats.h"
+#include "SoupGenerator.h"
+#include "StepKernels.h"
+#include "SimulationThread.h"
+#include "ThreadPool.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+using namespace std;
+/** \brief Fills the board inside the outermost ring with random alive cells.
+
+Soup seed is always 1, so every run measures the same boards.
+\param engine - simulation engine
+\param seed - percent of alive cells
+*/
+void fillRandom(LifeEngine* engine, int seed) {
+	fillSoup(engine, SoupGenerator(1, seed), 1, 1, engine->getWidth() - 1, engine->getHeight() - 1);
+}
+
+/** \brief Measures cost of one SparseEngine generation for growing soups.
+
+For every board size a random soup is created and a few generations are timed. Time divided by the number of active cells(alive cells and their neighbors) stays flat when one generation costs linear time.
+*/
+void benchmarkActiveSet() {
+	const int seed = 20;
+	const int generations = 10;
+	cout << "SparseEngine active set scaling, seed " << seed << endl;
+	cout << setw(10) << "board" << setw(14) << "active cells" << setw(16) << "ms/generation" << setw(18) << "ns/active cell" << endl;
+	for (int size = 64; size <= 2048; size *= 2) {
+		SparseEngine engine(size, size, LifeRule::preset(1));
+		fillRandom(&engine, seed);
+		long long active = 0;
+		auto begin = chrono::steady_clock::now();
+		for (int g = 0; g < generations; g++) {
+			active += engine.activeCells();
+			engine.step(1);
+		}
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		cout << setw(10) << size << setw(14) << active / generations << setw(16) << fixed << setprecision(3) << seconds * 1000 / generations
+			<< setw(18) << setprecision(1) << seconds * 1e9 / active << endl;
+	}
+}
+
+/** \brief Measures DenseEngine speed for 1 to maxThreads threads.
+
+The same soup is computed with every thread count, speedup is relative to one thread. Final populations are compared, because results have to be identical for any number of threads.
+\param maxThreads - largest number of threads
+*/
+void benchmarkThreads(int maxThreads) {
+	const int size = 4096;
+	const int generations = 50;
+	cout << "DenseEngine thread scaling, board " << size << "x" << size << ", " << generations << " generations" << endl;
+	cout << setw(10) << "threads" << setw(16) << "generations/s" << setw(18) << "cell updates/s" << setw(10) << "speedup" << setw(14) << "population" << endl;
+	double oneThreadSeconds = 0;
+	for (int threads = 1; threads <= maxThreads; threads++) {
+		DenseEngine engine(size, size, LifeRule::preset(1));
+		engine.setThreadCount(threads);
+		fillRandom(&engine, 20);
+		auto begin = chrono::steady_clock::now();
+		engine.step(generations);
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		if (threads == 1) oneThreadSeconds = seconds;
+		cout << setw(10) << threads << setw(16) << fixed << setprecision(1) << generations / seconds
+			<< setw(18) << scientific << setprecision(3) << (double)size * size * generations / seconds
+			<< setw(10) << fixed << setprecision(2) << oneThreadSeconds / seconds << setw(14) << engine.population() << endl;
+	}
+}
+
+/** \brief Measures DenseEngine speed of every step kernel for every game variant.
+
+Kernels not supported by the CPU are skipped. Populations of one variant have to be equal for all kernels.
+*/
+void benchmarkKernels() {
+	const int size = 2048;
+	const int generations = 50;
+	cout << "DenseEngine step kernels, board " << size << "x" << size << ", " << generations << " generations, 1 thread, best kernel " << kernelName(bestKernel()) << endl;
+	cout << setw(10) << "kernel" << setw(10) << "variant" << setw(16) << "generations/s" << setw(18) << "cell updates/s" << setw(14) << "population" << endl;
+	for (int isa = 0; isa < KERNEL_COUNT; isa++) {
+		if (!isKernelSupported((KernelIsa)isa)) continue;
+		for (int variant = 1; variant <= LifeRule::presetCount; variant++) {
+			DenseEngine engine(size, size, LifeRule::preset(variant));
+			engine.setKernel((KernelIsa)isa);
+			fillRandom(&engine, 20);
+			auto begin = chrono::steady_clock::now();
+			engine.step(generations);
+			double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+			cout << setw(10) << kernelName((KernelIsa)isa) << setw(10) << variant << setw(16) << fixed << setprecision(1) << generations / seconds
+				<< setw(18) << scientific << setprecision(3) << (double)size * size * generations / seconds << setw(14) << engine.population() << endl;
+		}
+	}
+}
+
+/** \brief Measures DenseEngine on isotropic non-totalistic rules next to totalistic rules on the scalar and the best kernel.
+*/
+void benchmarkIsotropic() {
+	const int size = 2048;
+	const int generations = 50;
+	const char* rules[] = { "B3/S23", "B36/S23", "B2n3/S23-q", "B2e3/S23", "B2-a3/S12-e3", "B2ci3ai4c8/S02ae3eijkq4iz5ar6i7e" };
+	cout << "Isotropic non-totalistic rules, board " << size << "x" << size << ", " << generations << " generations, 1 thread" << endl;
+	cout << setw(34) << "rule" << setw(12) << "kernel" << setw(16) << "generations/s" << setw(18) << "cell updates/s" << setw(14) << "population" << endl;
+	for (const char* text : rules) {
+		LifeRule rule;
+		LifeRule::parse(text, &rule);
+		KernelIsa kernels[] = { KERNEL_SCALAR, bestKernel() };
+		for (int k = 0; k < 2; k++) {
+			DenseEngine engine(size, size, rule);
+			engine.setKernel(kernels[k]);
+			fillRandom(&engine, 35);
+			auto begin = chrono::steady_clock::now();
+			engine.step(generations);
+			double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+			cout << setw(34) << rule.toString() << setw(12) << kernelName(kernels[k]) << setw(16) << fixed << setprecision(1) << generations / seconds
+				<< setw(18) << scientific << setprecision(3) << (double)size * size * generations / seconds << setw(14) << engine.population() << endl;
+		}
+	}
+}
+
+/** \brief Measures time HashLifeEngine needs to reach generation 10^6.
+
+Patterns are the R-pentomino, the acorn and a random soup on a window of the size of a full HD screen.
+*/
+void benchmarkHashLife() {
+	const long long generations = 1000000;
+	cout << "HashLifeEngine, " << generations << " generations" << endl;
+	cout << setw(10) << "pattern" << setw(14) << "population" << setw(10) << "seconds" << setw(12) << "nodes" << setw(14) << "collections" << endl;
+	for (int pattern = 0; pattern < 3; pattern++) {
+		HashLifeEngine engine(960, 540, LifeRule::preset(1));
+		const char* name;
+		if (pattern == 0) {
+			name = "rpentomino";
+			engine.load({ { 481, 270 }, { 482, 270 }, { 480, 271 }, { 481, 271 }, { 481, 272 } });
+		}
+		else if (pattern == 1) {
+			name = "acorn";
+			engine.load({ { 481, 270 }, { 483, 271 }, { 480, 272 }, { 481, 272 }, { 484, 272 }, { 485, 272 }, { 486, 272 } });
+		}
+		else {
+			name = "soup";
+			fillRandom(&engine, 20);
+		}
+		auto begin = chrono::steady_clock::now();
+		engine.advance(generations);
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		cout << setw(10) << name << setw(14) << engine.population() << setw(10) << fixed << setprecision(3) << seconds
+			<< setw(12) << engine.getNodeCount() << setw(14) << engine.getCollections() << endl;
+	}
+}
+
+/** \brief Measures TileEngine on the acorn, a methuselah that grows far outside any screen.
+
+Number of tiles is printed every 1000 generations, after the pattern settles it only grows with the escaping gliders.
+*/
+void benchmarkTiles() {
+	const int generations = 10000;
+	const int interval = 1000;
+	cout << "TileEngine, acorn, " << generations << " generations" << endl;
+	cout << setw(12) << "generation" << setw(14) << "population" << setw(10) << "tiles" << setw(16) << "ms/generation" << endl;
+	TileEngine engine(960, 540, LifeRule::preset(1));
+	engine.load({ { 481, 270 }, { 483, 271 }, { 480, 272 }, { 481, 272 }, { 484, 272 }, { 485, 272 }, { 486, 272 } });
+	for (int g = 0; g < generations; g += interval) {
+		auto begin = chrono::steady_clock::now();
+		engine.step(interval);
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		cout << setw(12) << engine.getGeneration() << setw(14) << engine.population() << setw(10) << engine.tileCount()
+			<< setw(16) << fixed << setprecision(3) << seconds * 1000 / interval << endl;
+	}
+}
+
+/** \brief Measures write and read speed of the pattern formats.
+
+A random soup is written in every format and read back into an empty engine, populations of both engines have to be equal.
+\param directory - directory for the temporary files
+*/
+void benchmarkPatterns(const string& directory) {
+	const int size = 4096;
+	cout << "Pattern files, soup " << size << "x" << size << endl;
+	cout << setw(10) << "format" << setw(12) << "MB" << setw(14) << "write MB/s" << setw(14) << "read MB/s" << setw(14) << "population" << setw(10) << "equal" << endl;
+	DenseEngine engine(size, size, LifeRule::preset(1));
+	fillRandom(&engine, 20);
+	const char* names[] = { "rle", "lif", "cells" };
+	for (int format = PATTERN_RLE; format <= PATTERN_CELLS; format++) {
+		string path = directory + "/benchmark." + names[format - 1];
+		PatternStats written, read;
+		writePattern(path, &engine, (PatternFormat)format, &written);
+		DenseEngine copy(size, size, LifeRule::preset(1));
+		//RLE and plaintext patterns start at the bounding box, Life 1.06 keeps board coordinates
+		long long offsetX = format == PATTERN_LIFE106 ? 0 : written.minX;
+		long long offsetY = format == PATTERN_LIFE106 ? 0 : written.minY;
+		readPattern(path, &copy, offsetX, offsetY, &read);
+		remove(path.c_str());
+		cout << setw(10) << names[format - 1] << setw(12) << fixed << setprecision(1) << written.bytes / 1e6
+			<< setw(14) << written.bytes / 1e6 / written.seconds << setw(14) << read.bytes / 1e6 / read.seconds
+			<< setw(14) << copy.population() << setw(10) << (copy.population() == engine.population() ? "yes" : "no") << endl;
+	}
+}
+
+/** \brief Runs benchmarks.
+
+Without arguments all benchmarks are run, otherwise the first argument picks one of them: activeset, threads [max threads], kernels, hashlife, tiles or patterns [directory].
+*/
+/** \brief Measures checkpoint writing and loading.
+
+Time the game waits for a background checkpoint(copy of the board) is compared with writing it on the calling thread.
+\param directory - directory for the checkpoint
+*/
+void benchmarkCheckpoint(const string& directory) {
+	const int size = 8192;
+	const int repeats = 5;
+	cout << "Checkpoint, soup " << size << "x" << size << ", " << repeats << " repeats" << endl;
+	DenseEngine engine(size, size, LifeRule::preset(1));
+	fillRandom(&engine, 20);
+	string path = directory + "/benchmark.ckpt";
+	double saveSeconds = 0, requestSeconds = 0, loadSeconds = 0;
+	bool isEqual = true;
+	for (int i = 0; i < repeats; i++) {
+		auto begin = chrono::steady_clock::now();
+		saveCheckpoint(path, &engine);
+		saveSeconds += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		{
+			CheckpointWriter writer(path);
+			begin = chrono::steady_clock::now();
+			writer.request(&engine);
+			requestSeconds += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		}
+		DenseEngine copy(1, 1, LifeRule::preset(2));
+		begin = chrono::steady_clock::now();
+		isEqual = loadCheckpoint(path, &copy) && isEqual;
+		loadSeconds += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		isEqual = isEqual && copy.population() == engine.population() && copy.getRule().toString() == engine.getRule().toString();
+	}
+	remove(path.c_str());
+	double megabytes = (double)size * size / 8 / 1e6;
+	cout << setw(12) << "MB" << setw(16) << "save ms" << setw(16) << "request ms" << setw(16) << "load ms" << setw(10) << "equal" << endl;
+	cout << setw(12) << fixed << setprecision(1) << megabytes << setw(16) << setprecision(3) << saveSeconds * 1000 / repeats
+		<< setw(16) << requestSeconds * 1000 / repeats << setw(16) << loadSeconds * 1000 / repeats << setw(10) << (isEqual ? "yes" : "no") << endl;
+}
+
+/** \brief Measures FrameBuffer updates on a full HD window with cells of 2 pixels.
+
+For every frame number of redrawn cells, uploaded rectangles and pixels is compared with the draw calls of drawing every alive cell(4 SDL calls for a cell drawn alive and 4 for erasing it).
+*/
+void benchmarkRender() {
+	const int width = 960;
+	const int height = 510;
+	const int scale = 2;
+	const int frames = 200;
+	cout << "FrameBuffer, board " << width << "x" << height << ", scale " << scale << ", " << frames << " frames" << endl;
+	cout << setw(10) << "seed" << setw(14) << "ms/frame" << setw(16) << "changed cells" << setw(10) << "rects" << setw(16) << "uploaded %" << setw(16) << "draw calls" << endl;
+	const int seeds[] = { 7, 20, 50 };
+	for (int seed : seeds) {
+		DenseEngine engine(width, height, LifeRule::preset(1));
+		fillRandom(&engine, seed);
+		FrameBuffer frame(width, height, scale);
+		frame.update(&engine);
+		double seconds = 0;
+		long long changed = 0, rects = 0, uploaded = 0, drawCalls = 0, lastPopulation = engine.population();
+		for (int f = 0; f < frames; f++) {
+			engine.step(1);
+			auto begin = chrono::steady_clock::now();
+			const vector<FrameRect>& dirty = frame.update(&engine);
+			seconds += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+			changed += frame.getChangedCells();
+			rects += dirty.size();
+			for (const FrameRect& rect : dirty) uploaded += (long long)rect.w * rect.h;
+			long long population = engine.population();
+			drawCalls += 4 * (population + lastPopulation);
+			lastPopulation = population;
+		}
+		cout << setw(10) << seed << setw(14) << fixed << setprecision(3) << seconds * 1000 / frames << setw(16) << changed / frames << setw(10) << rects / frames
+			<< setw(16) << setprecision(1) << 100.0 * uploaded / frames / ((double)frame.getPixelWidth() * frame.getPixelHeight()) << setw(16) << drawCalls / frames << endl;
+	}
+}
+
+/** \brief Measures cost of incremental board hashing and finds when soups stop changing.
+
+First the same soup is computed with and without hashing. Then soups of several seed values run until the CycleDetector finds a repeating board, dead frame kills gliders so every soup settles.
+*/
+void benchmarkCycles() {
+	const int size = 2048;
+	const int generations = 200;
+	cout << "DenseEngine hashing, board " << size << "x" << size << ", " << generations << " generations" << endl;
+	cout << setw(10) << "hashing" << setw(16) << "generations/s" << setw(22) << "hash" << endl;
+	for (int isHashing = 0; isHashing <= 1; isHashing++) {
+		DenseEngine engine(size, size, LifeRule::preset(1));
+		fillRandom(&engine, 20);
+		engine.setHashing(isHashing == 1);
+		auto begin = chrono::steady_clock::now();
+		engine.step(generations);
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		cout << setw(10) << (isHashing ? "yes" : "no") << setw(16) << fixed << setprecision(1) << generations / seconds << setw(22) << engine.getHash() << endl;
+	}
+	const int soupSize = 256;
+	const long long maxGenerations = 100000;
+	cout << "Soups " << soupSize << "x" << soupSize << " until the board repeats" << endl;
+	cout << setw(10) << "seed" << setw(14) << "generation" << setw(10) << "period" << setw(14) << "population" << setw(10) << "ms" << endl;
+	const int seeds[] = { 7, 20, 35, 50 };
+	for (int seed : seeds) {
+		DenseEngine engine(soupSize, soupSize, LifeRule::preset(1));
+		fillRandom(&engine, seed);
+		CycleDetector cycles(60);
+		engine.setCycleDetector(&cycles);
+		cycles.observe(engine.getHash(), engine.getCheckHash(), engine.getGeneration());
+		auto begin = chrono::steady_clock::now();
+		while (!cycles.hasCycle() && engine.getGeneration() < maxGenerations) engine.step(1);
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		cout << setw(10) << seed << setw(14) << cycles.getCycleStart() << setw(10) << cycles.getPeriod() << setw(14) << engine.population()
+			<< setw(10) << fixed << setprecision(1) << seconds * 1000 << endl;
+	}
+}
+
+/** \brief Measures cost of collecting per-generation statistics.
+
+The same soup is computed without a StatsWriter and with writers of both formats, files are written to the directory. Without CONWAY_STATS engines ignore the writer and nothing is written.
+\param directory - directory for the statistics files
+*/
+void benchmarkStats(const string& directory) {
+	const int size = 512;
+	const int generations = 200;
+#ifndef CONWAY_STATS
+	cout << "Compiled without -DCONWAY_STATS, engines don't collect statistics" << endl;
+#endif
+	cout << "Statistics, board " << size << "x" << size << ", " << generations << " generations" << endl;
+	cout << setw(10) << "engine" << setw(10) << "output" << setw(16) << "generations/s" << setw(10) << "records" << endl;
+	const char* outputs[] = { "", "stats.csv", "stats.jsonl" };
+	for (int isSparse = 0; isSparse <= 1; isSparse++) {
+		for (const char* output : outputs) {
+			DenseEngine dense(size, size, LifeRule::preset(1));
+			SparseEngine sparse(size, size, LifeRule::preset(1));
+			LifeEngine* engine = isSparse ? (LifeEngine*)&sparse : (LifeEngine*)&dense;
+			fillRandom(engine, 20);
+			StatsWriter stats;
+			if (*output != 0 && stats.open(directory + "/" + output)) engine->setStatsWriter(&stats);
+			auto begin = chrono::steady_clock::now();
+			engine->step(generations);
+			stats.close();
+			double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+			cout << setw(10) << (isSparse ? "sparse" : "dense") << setw(10) << (*output != 0 ? output + 6 : "none") << setw(16) << fixed << setprecision(1) << generations / seconds
+				<< setw(10) << stats.getRecordCount() << endl;
+		}
+	}
+}
+
+/** \brief Measures the cost of exporting every generation as a frame.
+
+The same soup is computed without an exporter and with an exporter of every format on all cores with a queue of 16 frames, simulation waits only when the encoders fall behind. Files are written to the directory and removed.
+\param directory - directory for the frames
+*/
+void benchmarkExport(const string& directory) {
+	const int size = 512;
+	const int scale = 2;
+	const int generations = 100;
+	cout << "Export, board " << size << "x" << size << " with cells of " << scale << " pixels, " << generations + 1 << " frames on " << ThreadPool::defaultThreadCount() << " threads" << endl;
+	cout << setw(10) << "format" << setw(16) << "generations/s" << setw(12) << "MB/frame" << setw(12) << "waits" << setw(12) << "wait ms" << setw(10) << "written" << endl;
+	const char* names[] = { "none", "y4m", "png", "gif" };
+	for (int format = EXPORT_UNKNOWN; format <= EXPORT_GIF; format++) {
+		DenseEngine engine(size, size, LifeRule::preset(1));
+		fillRandom(&engine, 35);
+		string path = directory + "/benchmark." + names[format];
+		unique_ptr<FrameExporter> exporter;
+		if (format != EXPORT_UNKNOWN) exporter.reset(new FrameExporter(path, (ExportFormat)format, scale, 30, ThreadPool::defaultThreadCount(), 16));
+		auto begin = chrono::steady_clock::now();
+		for (int g = 0; g <= generations; g++) {
+			if (exporter) exporter->addFrame(&engine);
+			if (g < generations) engine.step(1);
+		}
+		if (exporter) exporter->finish();
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		long long bytes = 0;
+		for (int frame = 0; frame <= generations && format != EXPORT_UNKNOWN; frame++) {
+			char framePath[32];
+			snprintf(framePath, sizeof(framePath), "_%06d.png", frame);
+			string file = format == EXPORT_PNG ? directory + "/benchmark" + framePath : path;
+			FILE* output = fopen(file.c_str(), "rb");
+			if (output != NULL) {
+				fseek(output, 0, SEEK_END);
+				bytes += ftell(output);
+				fclose(output);
+				remove(file.c_str());
+			}
+		}
+		cout << setw(10) << names[format] << setw(16) << fixed << setprecision(1) << generations / seconds << setw(12) << setprecision(3) << bytes / 1e6 / (generations + 1)
+			<< setw(12) << (exporter ? exporter->getStallCount() : 0) << setw(12) << setprecision(1) << (exporter ? exporter->getStallSeconds() * 1000 : 0)
+			<< setw(10) << (exporter ? exporter->getWrittenCount() : 0) << endl;
+	}
+}
+
+/** \brief Measures Viewport frames of a full HD screen on a board much bigger than the screen.
+
+For every zoom the pyramid is brought up to date after one generation (only tiles that changed are recomputed) and the frame is drawn, then drawn again from the same board to show the cost of the pixels alone. Zoomed out frames are compared with counting the alive cells of every pixel.
+*/
+void benchmarkViewport() {
+	const int size = 8192;
+	const int screenWidth = 1920, screenHeight = 1080;
+	const int repeats = 5;
+	cout << "Viewport, soup " << size << "x" << size << " on " << screenWidth << "x" << screenHeight << " pixels" << endl;
+	cout << setw(10) << "zoom" << setw(14) << "frame ms" << setw(16) << "changed tiles" << setw(14) << "still ms" << setw(14) << "count ms" << endl;
+	DenseEngine engine(size, size, LifeRule::preset(1));
+	fillRandom(&engine, 20);
+	engine.step(100);
+	int wordsPerRow = engine.getWordsPerRow();
+	vector<uint64_t> words((size_t)size * wordsPerRow);
+	Viewport viewport(screenWidth, screenHeight, size, size, 1);
+	for (int zoom = 4; zoom >= -5; zoom--) {
+		viewport.reset();
+		viewport.zoomAt(0, 0, zoom - 1);
+		double frameSeconds = 0, stillSeconds = 0;
+		long long changedTiles = 0;
+		for (int i = 0; i < repeats; i++) {
+			engine.step(1);
+			for (int y = 0; y < size; y++) {
+				copy(engine.getRow(y), engine.getRow(y) + wordsPerRow, &words[(size_t)y * wordsPerRow]);
+			}
+			long long before = 0;
+			auto begin = chrono::steady_clock::now();
+			if (zoom < 1) before = viewport.getPyramid().update(words.data(), size, size, wordsPerRow);
+			viewport.render(words.data(), size, size, wordsPerRow);
+			frameSeconds += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+			changedTiles += before;
+			//same board again, only the pixels are drawn
+			begin = chrono::steady_clock::now();
+			viewport.render(words.data(), size, size, wordsPerRow);
+			stillSeconds += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		}
+		double pixelsPerCell = viewport.getPixelsPerCell();
+		cout << setw(10) << (pixelsPerCell >= 1 ? to_string((int)pixelsPerCell) : "1/" + to_string((int)(1 / pixelsPerCell)))
+			<< setw(14) << fixed << setprecision(2) << frameSeconds * 1000 / repeats << setw(16) << changedTiles / repeats << setw(14) << stillSeconds * 1000 / repeats;
+		if (pixelsPerCell < 1) {
+			//every pixel counts the cells of its block
+			int block = (int)(1 / pixelsPerCell);
+			auto begin = chrono::steady_clock::now();
+			long long total = 0;
+			for (int py = 0; py < screenHeight && py * block < size; py++) {
+				for (int px = 0; px < screenWidth && px * block < size; px++) {
+					for (int y = py * block; y < (py + 1) * block && y < size; y++) {
+						const uint64_t* row = &words[(size_t)y * wordsPerRow];
+						for (int x = px * block; x < (px + 1) * block && x < size; x++) total += (row[x >> 6] >> (x & 63)) & 1;
+					}
+				}
+			}
+			double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+			cout << setw(14) << seconds * 1000 << (total < 0 ? " " : "");
+		}
+		cout << endl;
+	}
+}
+
+/** \brief Measures how long an edit sent to a running SimulationThread takes to reach a published board, and generations per second while edits keep coming.
+
+The soup fills the left half of the board, every edit draws a block(2x2 still life) in the empty right half, so it stays on the board after the generations that follow it.
+*/
+void benchmarkEdits() {
+	const int size = 2048;
+	const int trials = 20;
+	const double rates[] = { 2, 60, 0 };
+	cout << "Edits, soup " << size / 2 << "x" << size << " on a " << size << "x" << size << " board, " << trials << " edits" << endl;
+	cout << setw(10) << "rate" << setw(16) << "median edit ms" << setw(14) << "max edit ms" << setw(16) << "generations/s" << setw(20) << "with edits gen/s" << endl;
+	for (double targetRate : rates) {
+		DenseEngine engine(size, size, LifeRule::preset(1));
+		fillSoup(&engine, SoupGenerator(1, 20), 1, 1, size / 2, size - 1);
+		SimulationThread simulation(&engine, function<void(LifeEngine*)>());
+		simulation.setTargetRate(targetRate);
+		simulation.start();
+		vector<double> latencies;
+		for (int i = 0; i < trials; i++) {
+			int x = size / 2 + 64 + i * 8, y = size / 2;
+			auto begin = chrono::steady_clock::now();
+			simulation.editCell(x, y, true);
+			simulation.editCell(x + 1, y, true);
+			simulation.editCell(x, y + 1, true);
+			simulation.editCell(x + 1, y + 1, true);
+			while (true) {
+				if (simulation.update()) {
+					const BoardSnapshot& snapshot = simulation.getSnapshot();
+					if ((snapshot.words[(size_t)(y + 1) * snapshot.wordsPerRow + (x + 1) / 64] >> ((x + 1) % 64)) & 1) break;
+				}
+				this_thread::yield();
+			}
+			latencies.push_back(chrono::duration<double>(chrono::steady_clock::now() - begin).count());
+		}
+		sort(latencies.begin(), latencies.end());
+		//one second without edits, one second with a stroke of 64 cells every millisecond
+		double generationRates[2];
+		for (int isEditing = 0; isEditing < 2; isEditing++) {
+			simulation.update();
+			long long firstGeneration = simulation.getSnapshot().generation;
+			auto begin = chrono::steady_clock::now();
+			int stroke = 0;
+			while (chrono::steady_clock::now() - begin < chrono::seconds(1)) {
+				if (isEditing) {
+					for (int i = 0; i < 64; i++) simulation.editCell(size / 2 + 32 + i, 32 + stroke % (size - 64), stroke % 2 == 0);
+					stroke++;
+				}
+				this_thread::sleep_for(chrono::milliseconds(1));
+			}
+			simulation.update();
+			generationRates[isEditing] = (simulation.getSnapshot().generation - firstGeneration) / chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		}
+		simulation.stop();
+		cout << setw(10) << (targetRate > 0 ? to_string((int)targetRate) : "max") << setw(16) << fixed << setprecision(3) << latencies[trials / 2] * 1000
+			<< setw(14) << latencies.back() * 1000 << setw(16) << setprecision(1) << generationRates[0] << setw(20) << generationRates[1] << endl;
+	}
+}
+
+/** \brief Measures a soup computed by several processes over every transport next to one process, and checks that the boards are the same.
+*/
+void benchmarkDomains() {
+	const int size = 4096;
+	const int generations = 200;
+	const int workerCounts[] = { 1, 2, 4 };
+	DomainConfig config;
+	config.width = size;
+	config.height = size;
+	config.rule = LifeRule::preset(1);
+	config.topology = TOPOLOGY_TORUS;
+	config.threads = 1;
+	config.generations = generations;
+	config.soupSeed = 1;
+	config.density = 30;
+	cout << "Domains, torus soup " << size << "x" << size << ", " << generations << " generations" << endl;
+	DenseEngine single(size, size, config.rule);
+	single.setTopology(config.topology);
+	seedDomain(config, &single, 0);
+	auto begin = chrono::steady_clock::now();
+	single.step(generations);
+	double singleSeconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	cout << "one process " << fixed << setprecision(1) << generations / singleSeconds << " generations/s" << endl;
+	cout << setw(10) << "transport" << setw(9) << "workers" << setw(16) << "generations/s" << setw(12) << "halo wait" << setw(10) << "same" << endl;
+	for (int transport = 0; transport < TRANSPORT_COUNT; transport++) {
+		for (int workers : workerCounts) {
+			config.transport = (HaloTransport)transport;
+			config.workers = workers;
+			DenseEngine board;
+			DomainResult result;
+			if (!runDomains(config, &board, &result)) {
+				cout << setw(10) << transportName(config.transport) << setw(9) << workers << "  failed" << endl;
+				continue;
+			}
+			bool isSame = true;
+			for (int y = 0; y < size && isSame; y++) {
+				isSame = equal(single.getRow(y), single.getRow(y) + single.getWordsPerRow(), board.getRow(y));
+			}
+			cout << setw(10) << transportName(config.transport) << setw(9) << workers << setw(16) << setprecision(1) << generations / result.seconds
+				<< setw(11) << result.haloSeconds * 100 / result.seconds << "%" << setw(10) << (isSame ? "yes" : "NO") << endl;
+		}
+	}
+}
+
+/** \brief Measures GenerationsEngine on Generations rules next to DenseEngine on the same B/S rules without dying states.
+*/
+void benchmarkGenerations() {
+	const int size = 2048;
+	const int generations = 200;
+	const char* rules[] = { "B2/S/C3", "B2/S345/C4", "B2/S13/C10" };
+	cout << "Generations rules, board " << size << "x" << size << ", " << generations << " generations" << endl;
+	cout << setw(14) << "rule" << setw(20) << "engine" << setw(10) << "bits" << setw(16) << "generations/s" << setw(14) << "population" << endl;
+	for (const char* text : rules) {
+		LifeRule rule;
+		LifeRule::parse(text, &rule);
+		GenerationsEngine generationsEngine(size, size, rule);
+		DenseEngine denseEngine(size, size, LifeRule(rule.getBirth(), rule.getSurvival()));
+		LifeEngine* engines[] = { &generationsEngine, &denseEngine };
+		for (LifeEngine* engine : engines) {
+			fillRandom(engine, 30);
+			auto begin = chrono::steady_clock::now();
+			engine->step(generations);
+			double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+			bool isGenerations = engine == &generationsEngine;
+			cout << setw(14) << engine->getRule().toString() << setw(20) << (isGenerations ? "GenerationsEngine" : "DenseEngine") << setw(10) << (isGenerations ? generationsEngine.getBitsPerCell() : 1)
+				<< setw(16) << fixed << setprecision(1) << generations / seconds << setw(14) << engine->population() << endl;
+		}
+	}
+}
+
+/** \brief Steps a Larger than Life board by counting every cell of every neighborhood, for comparison with the running sums.
+
+\param cells - board with one byte per cell, cells outside are dead
+\param size - width and height of the board
+\param rule - Larger than Life rule
+\return next generation
+*/
+vector<uint8_t> stepLargerThanLifeNaive(const vector<uint8_t>& cells, int size, const LtlRule& rule) {
+	vector<uint8_t> next(cells.size());
+	int range = rule.getRange();
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			int count = 0;
+			for (int dy = -range; dy <= range; dy++) {
+				int halfWidth = rule.halfWidth(dy);
+				for (int dx = -halfWidth; dx <= halfWidth; dx++) {
+					if (x + dx >= 0 && x + dx < size && y + dy >= 0 && y + dy < size && (dx != 0 || dy != 0 || rule.getHasCenter())) count += cells[(y + dy) * size + x + dx];
+				}
+			}
+			next[y * size + x] = rule.nextState(cells[y * size + x] != 0, count);
+		}
+	}
+	return next;
+}
+
+/** \brief Measures LargerThanLifeEngine on Moore, von Neumann and circular rules next to counting every neighbor.
+*/
+void benchmarkLargerThanLife() {
+	const int size = 1024;
+	const int generations = 20;
+	const int naiveSize = 256;
+	const char* rules[] = { "R5,C0,M1,S34..58,B34..45,NM", "R10,C0,M1,S120..220,B100..170,NM", "R7,C0,M1,S40..90,B35..60,NN", "R10,C0,M0,S120..200,B100..150,NC" };
+	cout << "Larger than Life, board " << size << "x" << size << ", " << generations << " generations, naive counting on " << naiveSize << "x" << naiveSize << endl;
+	cout << setw(36) << "rule" << setw(16) << "generations/s" << setw(18) << "Mcells/s sums" << setw(18) << "Mcells/s naive" << setw(10) << "speedup" << endl;
+	for (const char* text : rules) {
+		LtlRule rule;
+		LtlRule::parse(text, &rule);
+		LargerThanLifeEngine engine(size, size, rule);
+		engine.setTopology(TOPOLOGY_DEAD);
+		fillRandom(&engine, 50);
+		auto begin = chrono::steady_clock::now();
+		engine.step(generations);
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		vector<uint8_t> cells((size_t)naiveSize * naiveSize);
+		for (int y = 0; y < naiveSize; y++) {
+			for (int x = 0; x < naiveSize; x++) cells[y * naiveSize + x] = engine.getCell(x, y) ? 1 : 0;
+		}
+		begin = chrono::steady_clock::now();
+		cells = stepLargerThanLifeNaive(cells, naiveSize, rule);
+		double naiveSeconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		double cellsPerSecond = (double)size * size * generations / seconds;
+		double naiveCellsPerSecond = (double)naiveSize * naiveSize / naiveSeconds;
+		cout << setw(36) << rule.toString() << setw(16) << fixed << setprecision(1) << generations / seconds << setw(18) << cellsPerSecond / 1e6
+			<< setw(18) << naiveCellsPerSecond / 1e6 << setw(10) << cellsPerSecond / naiveCellsPerSecond << endl;
+	}
+}
+
+/** \brief Returns peak resident memory of the process in bytes.
+
+On Linux the peak can be reset by resetPeakMemory, elsewhere it's the peak since the program started.
+*/
+long long peakMemory() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+	return (long long)counters.PeakWorkingSetSize;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+	return (long long)usage.ru_maxrss;
+#else
+	return (long long)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+/** \brief Resets peak resident memory to the current resident memory, so the peak of one benchmark case can be measured.
+
+\return true if the peak was reset
+*/
+bool resetPeakMemory() {
+#ifdef __linux__
+	FILE* file = fopen("/proc/self/clear_refs", "w");
+	if (file == NULL) return false;
+	bool isReset = fputs("5", file) >= 0;
+	return fclose(file) == 0 && isReset;
+#else
+	return false;
+#endif
+}
+
+/** \brief Workload of the benchmark suite. */
+struct SuiteCase {
+	string workload; /**< "soup" or name of a pattern. */
+	int density; /**< Percent of alive cells of a soup, as the seed of the game. */
+	int variant;
+	int size;
+	vector< pair<int, int> > pattern; /**< Cells of the pattern, empty for a soup. */
+};
+
+/** \brief Measurements of one suite case. */
+struct SuiteResult {
+	vector<double> seconds; /**< Stepping time of every repeat. */
+	double seedSeconds;
+	double edgeSeconds;
+	double kernelSeconds;
+	double populationSeconds;
+	long long population;
+	long long peakMemory;
+};
+
+/** \brief Runs one case of the benchmark suite.
+
+Every run seeds the board again with the same random cells, warm-up runs are not measured. Phase times are averaged over the measured runs.
+\param engine - engine with the board of the case size
+\param suiteCase - workload
+\param generations - generations of one run
+\param warmup - number of runs before the measured ones
+\param repeats - number of measured runs
+*/
+SuiteResult runSuiteCase(DenseEngine* engine, const SuiteCase& suiteCase, int generations, int warmup, int repeats) {
+	SuiteResult result = {};
+	resetPeakMemory();
+	for (int run = 0; run < warmup + repeats; run++) {
+		bool isMeasured = run >= warmup;
+		auto begin = chrono::steady_clock::now();
+		if (suiteCase.pattern.empty()) {
+			engine->clear();
+			fillRandom(engine, suiteCase.density);
+		}
+		else {
+			engine->load(suiteCase.pattern);
+		}
+		engine->setGeneration(0);
+		auto seeded = chrono::steady_clock::now();
+		engine->setPhaseTiming(true);
+		engine->step(generations);
+		auto stepped = chrono::steady_clock::now();
+		result.population = engine->population();
+		auto counted = chrono::steady_clock::now();
+		if (!isMeasured) continue;
+		result.seconds.push_back(chrono::duration<double>(stepped - seeded).count());
+		result.seedSeconds += chrono::duration<double>(seeded - begin).count() / repeats;
+		result.edgeSeconds += engine->getPhaseTimes().edgeSeconds / repeats;
+		result.kernelSeconds += engine->getPhaseTimes().kernelSeconds / repeats;
+		result.populationSeconds += chrono::duration<double>(counted - stepped).count() / repeats;
+	}
+	engine->setPhaseTiming(false);
+	result.peakMemory = peakMemory();
+	return result;
+}
+
+/** \brief Runs the standard workloads and prints results as JSON.
+
+Workloads are random soups at several seed values, every game variant and the R-pentomino, acorn and Gosper glider gun, each on square boards of several sizes. Generations/s and cell updates/s come from the median run.
+\param generations - generations of one run
+\param warmup - number of runs before the measured ones
+\param repeats - number of measured runs
+\param threads - number of DenseEngine threads
+*/
+void benchmarkSuite(int generations, int warmup, int repeats, int threads) {
+	const int sizes[] = { 256, 1024, 4096 };
+	const int densities[] = { 1, 7, 20, 50, 100 };
+	const int variantDensity = 20;
+	const vector< pair<int, int> > rpentomino = { { 1, 0 }, { 2, 0 }, { 0, 1 }, { 1, 1 }, { 1, 2 } };
+	const vector< pair<int, int> > acorn = { { 1, 0 }, { 3, 1 }, { 0, 2 }, { 1, 2 }, { 4, 2 }, { 5, 2 }, { 6, 2 } };
+	const vector< pair<int, int> > gliderGun = { { 24, 0 }, { 22, 1 }, { 24, 1 }, { 12, 2 }, { 13, 2 }, { 20, 2 }, { 21, 2 }, { 34, 2 }, { 35, 2 },
+		{ 11, 3 }, { 15, 3 }, { 20, 3 }, { 21, 3 }, { 34, 3 }, { 35, 3 }, { 0, 4 }, { 1, 4 }, { 10, 4 }, { 16, 4 }, { 20, 4 }, { 21, 4 },
+		{ 0, 5 }, { 1, 5 }, { 10, 5 }, { 14, 5 }, { 16, 5 }, { 17, 5 }, { 22, 5 }, { 24, 5 }, { 10, 6 }, { 16, 6 }, { 24, 6 },
+		{ 11, 7 }, { 15, 7 }, { 12, 8 }, { 13, 8 } };
+	if (warmup < 0) warmup = 0;
+	if (repeats < 1) repeats = 1;
+	if (generations < 1) generations = 1;
+	vector<SuiteCase> cases;
+	for (int size : sizes) {
+		for (int density : densities) cases.push_back({ "soup", density, 1, size, {} });
+		for (int variant = 2; variant <= LifeRule::presetCount; variant++) cases.push_back({ "soup", variantDensity, variant, size, {} });
+		const char* names[] = { "rpentomino", "acorn", "glidergun" };
+		const vector< pair<int, int> >* patterns[] = { &rpentomino, &acorn, &gliderGun };
+		for (int i = 0; i < 3; i++) {
+			SuiteCase patternCase = { names[i], 0, 1, size, {} };
+			//pattern is placed in the middle of the board
+			for (const pair<int, int>& cell : *patterns[i]) patternCase.pattern.push_back(make_pair(cell.first + size / 2 - 18, cell.second + size / 2 - 4));
+			cases.push_back(patternCase);
+		}
+	}
+	cout << "{" << endl;
+	cout << "  \"engine\": \"DenseEngine\", \"kernel\": \"" << kernelName(bestKernel()) << "\", \"threads\": " << threads
+		<< ", \"generations\": " << generations << ", \"warmup\": " << warmup << ", \"repeats\": " << repeats << "," << endl;
+	cout << "  \"cases\": [" << endl;
+	int lastSize = 0;
+	unique_ptr<DenseEngine> engine;
+	for (size_t i = 0; i < cases.size(); i++) {
+		const SuiteCase& suiteCase = cases[i];
+		if (suiteCase.size != lastSize) {
+			engine.reset();
+			engine.reset(new DenseEngine(suiteCase.size, suiteCase.size, LifeRule::preset(1)));
+			engine->setThreadCount(threads);
+			lastSize = suiteCase.size;
+		}
+		engine->setRule(LifeRule::preset(suiteCase.variant));
+		SuiteResult result = runSuiteCase(engine.get(), suiteCase, generations, warmup, repeats);
+		vector<double> sorted = result.seconds;
+		sort(sorted.begin(), sorted.end());
+		double median = sorted[sorted.size() / 2];
+		if (sorted.size() % 2 == 0) median = (median + sorted[sorted.size() / 2 - 1]) / 2;
+		double mean = 0;
+		for (double seconds : sorted) mean += seconds / sorted.size();
+		double cells = (double)suiteCase.size * suiteCase.size;
+		cout << "    { \"workload\": \"" << suiteCase.workload << "\", \"density\": " << suiteCase.density << ", \"variant\": " << suiteCase.variant
+			<< ", \"rule\": \"" << LifeRule::preset(suiteCase.variant).toString() << "\", \"width\": " << suiteCase.size << ", \"height\": " << suiteCase.size
+			<< "," << endl << "      \"seconds\": { \"min\": " << scientific << setprecision(6) << sorted.front() << ", \"median\": " << median
+			<< ", \"mean\": " << mean << ", \"max\": " << sorted.back() << " }," << endl
+			<< "      \"generationsPerSecond\": " << generations / median << ", \"cellUpdatesPerSecond\": " << cells * generations / median
+			<< ", \"population\": " << result.population << ", \"peakRssBytes\": " << result.peakMemory << "," << endl
+			<< "      \"phases\": { \"seed\": " << result.seedSeconds << ", \"edges\": " << result.edgeSeconds << ", \"kernel\": " << result.kernelSeconds
+			<< ", \"population\": " << result.populationSeconds << " } }" << (i + 1 < cases.size() ? "," : "") << endl;
+	}
+	cout << "  ]" << endl << "}" << endl;
+}
+
+int main(int argc, char *argsp[]) {
+	string name = argc > 1 ? argsp[1] : "all";
+	if (name == "all" || name == "activeset") benchmarkActiveSet();
+	if (name == "all" || name == "threads") benchmarkThreads(argc > 2 ? stoi(argsp[2]) : ThreadPool::defaultThreadCount());
+	if (name == "all" || name == "kernels") benchmarkKernels();
+	if (name == "all" || name == "isotropic") benchmarkIsotropic();
+	if (name == "all" || name == "hashlife") benchmarkHashLife();
+	if (name == "all" || name == "tiles") benchmarkTiles();
+	if (name == "all" || name == "patterns") benchmarkPatterns(argc > 2 ? argsp[2] : ".");
+	if (name == "all" || name == "checkpoint") benchmarkCheckpoint(argc > 2 ? argsp[2] : ".");
+	if (name == "all" || name == "render") benchmarkRender();
+	if (name == "all" || name == "viewport") benchmarkViewport();
+	if (name == "all" || name == "edits") benchmarkEdits();
+	if (name == "all" || name == "domains") benchmarkDomains();
+	if (name == "all" || name == "cycles") benchmarkCycles();
+	if (name == "all" || name == "generations") benchmarkGenerations();
+	if (name == "all" || name == "ltl") benchmarkLargerThanLife();
+	if (name == "all" || name == "stats") benchmarkStats(argc > 2 ? argsp[2] : ".");
+	if (name == "all" || name == "export") benchmarkExport(argc > 2 ? argsp[2] : ".");
+	//JSON output is not mixed with the tables of "all"
+	if (name == "suite") benchmarkSuite(argc > 2 ? stoi(argsp[2]) : 100, argc > 3 ? stoi(argsp[3]) : 1, argc > 4 ? stoi(argsp[4]) : 5,
+		argc > 5 ? stoi(argsp[5]) : ThreadPool::defaultThreadCount());
+	return 0;
+}
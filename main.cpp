@@ -1,16 +1,34 @@
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
 #include <string>
+#include <vector>
 #include <SDL.h> //graphics library
 #include "Cell.h"
 #include "screen.h"
+#include "LifeEngine.h"
+#include "LifeRule.h"
+#include "PatternFile.h"
+#include "Checkpoint.h"
+#include "DenseEngine.h"
+#include "DomainDecomposition.h"
+#include "FrameExporter.h"
+#include "SoupBatch.h"
+#include "SoupGenerator.h"
+#include "ThreadPool.h"
 using namespace std;
 
 /** \brief Opens the console and takes initial input from user and sets parameters for cell size, delay, seed and game variant.
 *
 *	Size takes values from 2 to 10 and it means that side of one cell is 2-10 pixels.
-*	Speed sets the delay between two states.
-*	Seed sets how many cells are alive at runtime.
-*	Variant takes values from 1 to 7 and it sets the rules that apply to the game.
+*	Speed sets the delay between two states, generations are computed on their own thread at this rate while the screen is redrawn at display rate. While the game runs [ and ] change it, Space pauses the game and N computes one generation.
+*	Turbo makes the game run as fast as possible and show only every Nth generation, it can be turned on and off with the T key.
+*	Seed sets how many cells are alive at runtime, a path to a RLE, Life 1.06 or .cells pattern file can be entered instead, or a checkpoint(conway.ckpt) to resume a saved game.
+*	Soup seed picks the random cells, the same soup seed and seed give the same soup, 0 gives a new soup and its soup seed is printed.
+*	Variant takes values from 1 to 8 and it sets the rules that apply to the game, any rule in B/S notation(e.g. B36/S23, or B2n3/S23-q in Hensel notation) can be entered as well.
+*	Edges set what cells on the edge of the board see outside of it.
 */
 void takeInput() {
 	cout << "Conway's Game of Life settings:" << endl << endl;
@@ -27,35 +45,330 @@ void takeInput() {
 		cin >> input;
 		speed = 2000 - stoi(input);
 	} while (speed < 0 || speed > 2000);
-	int seed;
-	cout << "Set seed (enter value from 1 to 100): ";
+	int turbo;
+	do {
+		cout << "Set turbo (enter 1 to show every generation or N from 2 to 100000 to show every Nth generation at full speed): ";
+		cin >> input;
+		turbo = stoi(input);
+	} while (turbo < 1 || turbo > 100000);
+	int seed = 0;
+	string patternPath;
+	cout << "Set seed (enter value from 1 to 100, path to a pattern file or conway.ckpt to resume): ";
 	cin >> input;
-	seed = stoi(input);
-	if (seed < 1 || seed > 100) {
+	if (input.find_first_not_of("0123456789") != string::npos && (patternFormat(input) != PATTERN_UNKNOWN || isCheckpoint(input))) {
+		patternPath = input;
+	}
+	else if (input.find_first_not_of("0123456789") == string::npos) {
+		seed = stoi(input);
+	}
+	if (patternPath.empty() && (seed < 1 || seed > 100)) {
 		cout << "Set to default seed value 7." << endl;
 		seed = 7;
 	}
-	int variant;
+	uint64_t soupSeed = 0;
+	if (patternPath.empty()) {
+		cout << "Set soup seed (enter 0 for a new soup or the soup seed printed by an earlier game to repeat it): ";
+		cin >> input;
+		if (input.find_first_not_of("0123456789") == string::npos && input.size() <= 19) soupSeed = stoull(input);
+		else cout << "Set to a new soup." << endl;
+	}
+	LifeRule rule;
 	cout << "List of variants: " << endl;
-	cout << "1. 23/3 - Basic Conway rules." << endl;
-	cout << "2. 34/34 - Many small oscilators and ships." << endl;
-	cout << "3. 245/368 - Cells die fast, some small oscilators and ships." << endl;
-	cout << "4. 238/357 - Similar to basic Conway." << endl;
-	cout << "5. 125/36 - Many oscilators and ships" << endl;
-	cout << "6. 5/345 - Oscilators." << endl;
-	cout << "7. 235678/3678 - Growing spots, cells never die." << endl;
-	cout << "8. 245/368 - Cells create square-like shapes, cells never die." << endl;
-	cout << "Set variant (enter value from 1 to 8): ";
+	for (int i = 1; i <= LifeRule::presetCount; i++) {
+		cout << i << ". " << LifeRule::preset(i).toString() << " - " << LifeRule::presetDescription(i) << endl;
+	}
+	cout << "Set variant (enter value from 1 to 8 or rule like B36/S23 or B2n3/S23-q): ";
+	cin >> input;
+	if (input.find_first_of("BbSs/") != string::npos) {
+		if (!LifeRule::parse(input, &rule)) {
+			cout << "Set to default variant 1." << endl;
+			rule = LifeRule::preset(1);
+		}
+		else if (rule.getStates() > 2) {
+			cout << "Generations rules run only in GenerationsEngine, the game shows alive and dead cells. Set to default variant 1." << endl;
+			rule = LifeRule::preset(1);
+		}
+	}
+	else {
+		int variant = stoi(input);
+		if (variant < 1 || variant > 8) {
+			cout << "Set to default variant 1." << endl;
+			variant = 1;
+		}
+		rule = LifeRule::preset(variant);
+	}
+	cout << "List of edges: " << endl;
+	cout << "1. Dead frame - outermost cells are always dead" << endl;
+	cout << "2. Dead - cells outside the board are dead" << endl;
+	cout << "3. Torus - opposite edges are joined" << endl;
+	cout << "4. Klein bottle - like torus, but top and bottom are joined with left and right swapped" << endl;
+	cout << "5. Mirror - edges reflect the board" << endl;
+	cout << "Set edges (enter value from 1 to 5): ";
 	cin >> input;
-	variant = stoi(input);
-	if (variant < 1 || variant > 8) {
-		cout << "Set to default variant 1." << endl;
-		variant = 1;
+	int edges = stoi(input);
+	if (edges < 1 || edges > 5) {
+		cout << "Set to default edges 1." << endl;
+		edges = 1;
+	}
+	setWindow(scale, speed, turbo, seed, soupSeed, patternPath, rule, (Topology)(edges - 1));
+}
+
+/** \brief Runs random soups without a window and prints their aggregated outcomes.
+*
+*	Started with "batch" as the first argument, the other arguments are options of parseSoupBatch, e.g. batch rules=1,2 densities=20,50 sizes=128,256 seeds=1-1000 generations=20000 output=soups.csv.
+*	Soups run in parallel on all cores, progress is printed every 10 percent. Summary has one line per rule, size and density with the number of soups that died, became still lifes, oscillated or reached the generation cap, mean final population, mean and longest lifespan of the settled soups and the most common periods.
+\return 0 if the batch was run, 1 if an option is invalid or the output file can't be created
+*/
+int runBatch(int argc, char *argsp[]) {
+	SoupBatch batch;
+	int threads = ThreadPool::defaultThreadCount();
+	string outputPath;
+	if (!parseSoupBatch(vector<string>(argsp + 2, argsp + argc), &batch, &threads, &outputPath)) {
+		return 1;
+	}
+	ofstream output;
+	if (!outputPath.empty()) {
+		output.open(outputPath);
+		if (!output) {
+			cout << "File " << outputPath << " could not be created." << endl;
+			return 1;
+		}
+		output << "rule,size,density,seed,settled,dead,lifespan,period,population,seconds" << endl;
+	}
+	long long total = (long long)batch.rules.size() * batch.sizes.size() * batch.densities.size() * batch.seeds.size();
+	cout << "Running " << total << " soups on " << threads << " threads, cap " << batch.maxGenerations << " generations" << endl;
+	long long finished = 0;
+	vector<SoupResult> results = runSoupBatch(batch, threads, [&](const SoupResult& result) {
+		if (output.is_open()) {
+			output << result.config.rule.toString() << "," << result.config.size << "," << result.config.density << "," << result.config.seed << ","
+				<< result.isSettled << "," << result.isDead << "," << result.lifespan << "," << result.period << "," << result.population << "," << result.seconds << "\n";
+		}
+		finished++;
+		if (finished * 10 / total != (finished - 1) * 10 / total) cout << finished * 100 / total << "% done" << endl;
+	});
+	cout << setw(14) << "rule" << setw(7) << "size" << setw(9) << "density" << setw(7) << "soups" << setw(7) << "dead" << setw(7) << "still" << setw(7) << "osc"
+		<< setw(7) << "cap" << setw(12) << "population" << setw(10) << "lifespan" << setw(10) << "longest" << "  periods" << endl;
+	for (const SoupSummary& summary : summarizeSoups(results)) {
+		cout << setw(14) << summary.config.rule.toString() << setw(7) << summary.config.size << setw(9) << summary.config.density << setw(7) << summary.soups
+			<< setw(7) << summary.dead << setw(7) << summary.stillLifes << setw(7) << summary.oscillators << setw(7) << summary.soups - summary.settled
+			<< setw(12) << fixed << setprecision(1) << summary.meanPopulation << setw(10) << summary.meanLifespan << setw(10) << summary.maxLifespan << " ";
+		for (unsigned int i = 0; i < summary.periods.size() && i < 5; i++) {
+			cout << " p" << summary.periods[i].first << "x" << summary.periods[i].second;
+		}
+		cout << endl;
+	}
+	return 0;
+}
+
+/** \brief Parses a number of an export option.
+
+\return false if the value is not a number from minimum to maximum
+*/
+static bool parseExportNumber(const string& value, long long minimum, long long maximum, long long* number) {
+	if (value.empty() || value.find_first_not_of("0123456789") != string::npos || value.size() > 18) {
+		return false;
 	}
-	setWindow(scale, speed, seed, variant);
+	*number = stoll(value);
+	return *number >= minimum && *number <= maximum;
+}
+
+/** \brief Records a game into a video or PNG frames without a window.
+*
+*	Started with "export" as the first argument, the other arguments are options like output=soup.gif size=512x256 rule=B36/S23 seed=35 generations=1000 every=2 scale=3.
+*	Output is a .y4m video, a .gif animation or .png frames(FrameExporter.h). Board is a random soup of seed percent alive cells(soupseed repeats a soup) or a pattern file or checkpoint given by pattern. A frame is taken every every generations from generation 0 to generations, the board is computed on all cores while frames are encoded on threads threads behind a queue of queue frames. Other options are fps, edges(1 to 5 like in the game) and scale(cell side in pixels).
+\return 0 if every frame was written, 1 if an option is invalid or the output can't be written
+*/
+int runExport(int argc, char *argsp[]) {
+	string outputPath, patternPath;
+	LifeRule rule = LifeRule::preset(1);
+	long long width = 256, height = 256, seed = 7, soupSeed = 0, generations = 1000, every = 1, scale = 2, fps = 30, edges = 1, queue = 16;
+	long long threads = ThreadPool::defaultThreadCount();
+	for (int i = 2; i < argc; i++) {
+		string option = argsp[i];
+		size_t equals = option.find('=');
+		string name = option.substr(0, equals);
+		string value = equals == string::npos ? "" : option.substr(equals + 1);
+		bool isValid = true;
+		if (name == "output") {
+			outputPath = value;
+			isValid = exportFormat(value) != EXPORT_UNKNOWN;
+		}
+		else if (name == "size") {
+			size_t x = value.find('x');
+			isValid = parseExportNumber(value.substr(0, x), 3, 1 << 16, &width);
+			isValid = isValid && parseExportNumber(x == string::npos ? value : value.substr(x + 1), 3, 1 << 16, &height);
+		}
+		else if (name == "rule") {
+			long long variant;
+			if (parseExportNumber(value, 1, LifeRule::presetCount, &variant)) rule = LifeRule::preset((int)variant);
+			else isValid = LifeRule::parse(value, &rule) && rule.getStates() == 2;
+		}
+		else if (name == "seed") isValid = parseExportNumber(value, 1, 100, &seed);
+		else if (name == "soupseed") isValid = parseExportNumber(value, 0, 999999999999999999LL, &soupSeed);
+		else if (name == "pattern") {
+			patternPath = value;
+			isValid = patternFormat(value) != PATTERN_UNKNOWN || isCheckpoint(value);
+		}
+		else if (name == "generations") isValid = parseExportNumber(value, 0, 1LL << 40, &generations);
+		else if (name == "every") isValid = parseExportNumber(value, 1, 1 << 30, &every);
+		else if (name == "scale") isValid = parseExportNumber(value, 1, 16, &scale);
+		else if (name == "fps") isValid = parseExportNumber(value, 1, 100, &fps);
+		else if (name == "edges") isValid = parseExportNumber(value, 1, 5, &edges);
+		else if (name == "threads") isValid = parseExportNumber(value, 1, 4096, &threads);
+		else if (name == "queue") isValid = parseExportNumber(value, 1, 4096, &queue);
+		else isValid = false;
+		if (!isValid) {
+			cout << "Invalid export option " << option << endl;
+			return 1;
+		}
+	}
+	if (outputPath.empty()) {
+		cout << "Export needs output=path with .y4m, .gif or .png extension" << endl;
+		return 1;
+	}
+	DenseEngine engine((int)width, (int)height, rule);
+	engine.setTopology((Topology)(edges - 1));
+	engine.setThreadCount(ThreadPool::defaultThreadCount());
+	if (isCheckpoint(patternPath)) {
+		if (!loadCheckpoint(patternPath, &engine)) {
+			cout << "Checkpoint " << patternPath << " could not be loaded." << endl;
+			return 1;
+		}
+	}
+	else if (!patternPath.empty()) {
+		PatternStats stats;
+		if (!readPattern(patternPath, NULL, 0, 0, &stats)) {
+			cout << "Pattern " << patternPath << " could not be read." << endl;
+			return 1;
+		}
+		readPattern(patternPath, &engine, width / 2 - (stats.minX + stats.maxX) / 2, height / 2 - (stats.minY + stats.maxY) / 2, &stats);
+	}
+	else {
+		if (soupSeed == 0) soupSeed = newSoupSeed();
+		cout << "Soup seed " << soupSeed << endl;
+		fillSoup(&engine, SoupGenerator(soupSeed, (int)seed), 0, 0, (int)width, (int)height);
+	}
+	FrameExporter exporter(outputPath, exportFormat(outputPath), (int)scale, (int)fps, (int)threads, (int)queue);
+	auto begin = chrono::steady_clock::now();
+	long long frames = 0;
+	for (long long g = 0; g <= generations; g += every) {
+		if (!exporter.addFrame(&engine)) break;
+		frames++;
+		if (g + every <= generations) engine.step((int)every);
+	}
+	bool isWritten = exporter.finish() && exporter.getWrittenCount() == frames;
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	cout << exporter.getWrittenCount() << " frames of " << engine.getWidth() * scale << "x" << engine.getHeight() * scale << " pixels written to " << outputPath
+		<< " in " << fixed << setprecision(2) << seconds << " s, simulation waited " << exporter.getStallSeconds() << " s for a full queue " << exporter.getStallCount() << " times" << endl;
+	if (!isWritten) cout << "Output " << outputPath << " could not be written." << endl;
+	return isWritten ? 0 : 1;
+}
+
+/** \brief Computes a board split between several processes without a window.
+*
+*	Started with "domains" as the first argument, the other arguments are options like workers=4 transport=shm size=4096x4096 rule=B3/S23 seed=20 generations=1000.
+*	Every worker process computes a band of rows and exchanges its edge rows with its neighbors over tcp(loopback), unix(socket pairs) or shm(shared memory) transport(DomainDecomposition.h). Board is a random soup of seed percent alive cells(soupseed repeats a soup) or a pattern file given by pattern, other options are edges(1 to 5 like in the game) and threads(threads of every worker). With verify=1 the same board is also computed by one process and the boards are compared.
+\return 0 if the board was computed(and is the same as in one process if verified), 1 if an option is invalid or the run failed
+*/
+int runDomainsCommand(int argc, char *argsp[]) {
+	DomainConfig config;
+	config.width = 1024;
+	config.height = 1024;
+	config.rule = LifeRule::preset(1);
+	config.transport = TRANSPORT_SHARED;
+	long long workers = 4, seed = 20, soupSeed = 0, generations = 1000, edges = 1, threads = 1, verify = 0;
+	for (int i = 2; i < argc; i++) {
+		string option = argsp[i];
+		size_t equals = option.find('=');
+		string name = option.substr(0, equals);
+		string value = equals == string::npos ? "" : option.substr(equals + 1);
+		bool isValid = true;
+		long long width = config.width, height = config.height;
+		if (name == "size") {
+			size_t x = value.find('x');
+			isValid = parseExportNumber(value.substr(0, x), 3, 1 << 20, &width);
+			isValid = isValid && parseExportNumber(x == string::npos ? value : value.substr(x + 1), 3, 1 << 20, &height);
+			config.width = (int)width;
+			config.height = (int)height;
+		}
+		else if (name == "rule") {
+			long long variant;
+			if (parseExportNumber(value, 1, LifeRule::presetCount, &variant)) config.rule = LifeRule::preset((int)variant);
+			else isValid = LifeRule::parse(value, &config.rule) && config.rule.getStates() == 2;
+		}
+		else if (name == "workers") isValid = parseExportNumber(value, 1, 1024, &workers);
+		else if (name == "transport") isValid = parseTransport(value, &config.transport);
+		else if (name == "seed") isValid = parseExportNumber(value, 1, 100, &seed);
+		else if (name == "soupseed") isValid = parseExportNumber(value, 0, 999999999999999999LL, &soupSeed);
+		else if (name == "pattern") {
+			config.patternPath = value;
+			isValid = patternFormat(value) != PATTERN_UNKNOWN;
+		}
+		else if (name == "generations") isValid = parseExportNumber(value, 0, 1 << 30, &generations);
+		else if (name == "edges") isValid = parseExportNumber(value, 1, 5, &edges);
+		else if (name == "threads") isValid = parseExportNumber(value, 1, 4096, &threads);
+		else if (name == "verify") isValid = parseExportNumber(value, 0, 1, &verify);
+		else isValid = false;
+		if (!isValid) {
+			cout << "Invalid domains option " << option << endl;
+			return 1;
+		}
+	}
+	if (workers > config.height) {
+		cout << "Board of " << config.height << " rows can't be split between " << workers << " workers." << endl;
+		return 1;
+	}
+	config.workers = (int)workers;
+	config.topology = (Topology)(edges - 1);
+	config.threads = (int)threads;
+	config.generations = generations;
+	config.density = (int)seed;
+	config.soupSeed = soupSeed != 0 ? soupSeed : newSoupSeed();
+	if (config.patternPath.empty()) cout << "Soup seed " << config.soupSeed << endl;
+	DenseEngine board;
+	DomainResult result;
+	auto begin = chrono::steady_clock::now();
+	if (!runDomains(config, &board, &result)) {
+		cout << "Board could not be computed by " << workers << " workers." << endl;
+		return 1;
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	cout << generations << " generations of " << config.width << "x" << config.height << " by " << workers << " workers over " << transportName(config.transport)
+		<< " in " << fixed << setprecision(3) << seconds << " s(" << result.seconds << " s stepping, " << result.haloSeconds << " s waiting for halo rows), "
+		<< setprecision(1) << generations / max(result.seconds, 1e-9) << " generations/s, population " << board.population() << endl;
+	if (!verify) {
+		return 0;
+	}
+	DenseEngine single(config.width, config.height, config.rule);
+	single.setTopology(config.topology);
+	single.setThreadCount((int)threads);
+	if (!seedDomain(config, &single, 0)) {
+		cout << "Pattern " << config.patternPath << " could not be read." << endl;
+		return 1;
+	}
+	begin = chrono::steady_clock::now();
+	single.step((int)generations);
+	seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	for (int y = 0; y < config.height; y++) {
+		if (!equal(single.getRow(y), single.getRow(y) + single.getWordsPerRow(), board.getRow(y))) {
+			cout << "One process gives another board, first different row " << y << "." << endl;
+			return 1;
+		}
+	}
+	cout << "One process gives the same board in " << setprecision(3) << seconds << " s, " << setprecision(1) << generations / max(seconds, 1e-9) << " generations/s" << endl;
+	return 0;
 }
 
 int main(int argc, char *argsp[]) {
+	if (argc > 1 && string(argsp[1]) == "batch") {
+		return runBatch(argc, argsp);
+	}
+	if (argc > 1 && string(argsp[1]) == "export") {
+		return runExport(argc, argsp);
+	}
+	if (argc > 1 && string(argsp[1]) == "domains") {
+		return runDomainsCommand(argc, argsp);
+	}
 	takeInput();
 	return 0;
 }
\ No newline at end of file
@@ -1,9 +1,32 @@
 #include "Cell.h"
+#include "LifeEngine.h"
+#include "PatternFile.h"
+#include "Checkpoint.h"
+#include "FrameBuffer.h"
+#include "Viewport.h"
+#include "SimulationThread.h"
+#include "CycleDetector.h"
+#include "SoupGenerator.h"
+#include "GenerationStats.h"
+#include "DenseEngine.h"
+#include "ThreadPool.h"
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <vector>
-#include <time.h> //for random seed
-#include <Windows.h> //GetAsyncKeyState
+#include <SDL.h> //graphics library
 using namespace std;
+
+static const char* CHECKPOINT_PATH = "conway.ckpt"; /**< Checkpoint written by the game, can be entered as the seed to resume it. */
+static const Uint32 CHECKPOINT_INTERVAL = 60000; /**< Miliseconds between checkpoints. */
+static const int CYCLE_MAX_PERIOD = 60; /**< Longest period of a repeating board that is reported. */
+static const double MIN_RATE = 0.5; /**< Slowest paced generations per second, the delay of speed 0. */
+static const double MAX_RATE = 1024; /**< Fastest paced generations per second, faster runs as fast as possible. */
+static const Uint32 FRAME_INTERVAL = 16; /**< Shortest time of a frame in miliseconds, used when the renderer doesn't wait for vertical sync. */
+STATS(static const char* STATS_PATH = "conway-stats.csv"; /**< Per-generation statistics written by the game if compiled with CONWAY_STATS. */)
+
 /** \brief Function that prints to the console all Cell objects that are currently stored in a vector.
 
 	It's used for debugging.
@@ -15,44 +38,95 @@ void printArray(vector<Cell> vector) {
 	}
 }
 
+/** \brief Draws cell on screen.
+
+Based on isAlive value function draws appropriate Cell on screen window, with an outline from FrameBuffer::GRID_MIN_SCALE pixels up.
+\param SDL_Renderer - 2D rendering context for a window from SDL library
+\param posX - vertical position relative to the screen
+\param posY - horizontal position relative to the screen
+\param scale - size of Cell side
+\param isAlive - true if alive Cell is drawn, false if dead Cell is drawn
+*/
+void drawCell(SDL_Renderer** renderer, int posX, int posY, int scale, bool isAlive) {
+	SDL_Rect fillRect = { posX + 1, posY + 1, scale - 2, scale - 2 };
+	SDL_Rect outline = { posX, posY, scale, scale };
+
+	//cells smaller than FrameBuffer::GRID_MIN_SCALE have no outline
+	if (scale < FrameBuffer::GRID_MIN_SCALE) {
+		if (isAlive) SDL_SetRenderDrawColor(*renderer, 0xAA, 0xAA, 0xAA, 0xFF);
+		else SDL_SetRenderDrawColor(*renderer, 0x55, 0x55, 0x55, 0xFF);
+		SDL_RenderFillRect(*renderer, &outline);
+	}
+	else if (isAlive) {
+		SDL_SetRenderDrawColor(*renderer, 0xAA, 0xAA, 0xAA, 0xFF);
+		SDL_RenderFillRect(*renderer, &fillRect);
+		SDL_SetRenderDrawColor(*renderer, 0xDB, 0xDB, 0x93, 0xFF);
+		SDL_RenderDrawRect(*renderer, &outline);
+	}
+	else {
+		SDL_SetRenderDrawColor(*renderer, 0x55, 0x55, 0x55, 0xFF);
+		SDL_RenderFillRect(*renderer, &fillRect);
+		SDL_SetRenderDrawColor(*renderer, 0x44, 0x44, 0x44, 0xFF);
+		SDL_RenderDrawRect(*renderer, &outline);
+	}
+}
+
+/** \brief Sets a cell alive in the engine and draws it.
+
+\param SDL_Renderer - 2D rendering context for a window from SDL library
+\param engine - simulation engine
+\param x - column of the cell
+\param y - row of the cell
+\param scale - size of Cell side
+*/
+void createAliveCell(SDL_Renderer** renderer, LifeEngine* engine, int x, int y, int scale) {
+	engine->setCell(x, y, true);
+	drawCell(renderer, x * scale, y * scale, scale, true);
+}
+
 /** \brief Updates the screen for the next game state.
 
-	The purpose of this function is to go through aliveCellArray and update the screen using Cell::createRectangle, method that draws 'alive' or 'dead' rectangles(Cells).
+	Cells that changed are redrawn in the frame buffer, only the changed rectangles are uploaded to the streaming texture and the whole board is presented with a single copy. Cost of a frame follows the number of changed cells, not the number of alive cells.
 		\param SDL_Window - window object from SDL library
 		\param SDL_Renderer - 2D rendering context for a window from SDL library
-		\param aliveCellArrayPointer - pointer to aliveCellArray(array that stores only alive Cells and their neighbors)
-		\param scale - size of Cell side
-		\param speed - delay between game states
+		\param SDL_Texture - streaming texture of the size of the frame buffer
+		\param snapshot - board of the shown generation
+		\param frame - image of the board
 */
-void updateScreen(SDL_Window** window, SDL_Renderer** renderer, vector<Cell>* aliveCellArrayPointer, int scale, int speed) {
-
-	for (unsigned int i = 0; i < (*aliveCellArrayPointer).size(); i++) {
-		(*aliveCellArrayPointer).at(i).createRectangle(window, renderer, scale);
+void updateScreen(SDL_Window** window, SDL_Renderer** renderer, SDL_Texture** texture, const BoardSnapshot* snapshot, FrameBuffer* frame) {
+	const vector<FrameRect>& rects = frame->update(snapshot->words.data(), snapshot->width, snapshot->height);
+	for (unsigned int i = 0; i < rects.size(); i++) {
+		SDL_Rect rect = { rects[i].x, rects[i].y, rects[i].w, rects[i].h };
+		SDL_UpdateTexture(*texture, &rect, frame->getPixels() + (size_t)rect.y * frame->getPixelWidth() + rect.x, frame->getPitch());
 	}
-	//Set delay between screen updates
-	SDL_Delay(2000 - speed);
 	//Update screen
+	SDL_Rect target = { 0, 0, frame->getPixelWidth(), frame->getPixelHeight() };
+	SDL_SetRenderDrawColor(*renderer, 0x55, 0x55, 0x55, 0xFF);
+	SDL_RenderClear(*renderer);
+	SDL_RenderCopy(*renderer, *texture, NULL, &target);
 	SDL_RenderPresent(*renderer);
 }
 
-/** \brief Updates alive status of main Cell matrix based on their status in aliveCellArray
+/** \brief Draws the board of a zoomed or moved view.
 
-The purpose of this function is to go through aliveCellArray, get every Cell posY and posX and update their status in cellMatrix.
-\param cellMatrixPointer - pointer to cellMatrix(matrix that stores all Cells)
-\param fromArray - pointer to aliveCellArray(array that stores only alive Cells and their neighbors)
-\param size - size of Cell side
+	Viewport draws every pixel of the window from the cells or, zoomed out, from the density pyramid, and the whole window is uploaded to a streaming texture of its size. Cost of a frame follows the number of pixels, not the number of cells.
+		\param SDL_Window - window object from SDL library
+		\param SDL_Renderer - 2D rendering context for a window from SDL library
+		\param SDL_Texture - streaming texture of the size of the window
+		\param snapshot - board of the shown generation
+		\param viewport - shown part of the board
 */
-void updateMainMatrix(vector< vector<Cell> >* cellMatrixPointer, vector<Cell>* fromArray, int scale) {
-	for (unsigned int i = 0; i < (*fromArray).size(); i++) {
-		int posY = (*fromArray)[i].getPosY() / scale;
-		int posX = (*fromArray)[i].getPosX() / scale;
-		(*cellMatrixPointer)[posY][posX].setAlive((*fromArray)[i].getIsAlive());
-	}
+void updateViewport(SDL_Window** window, SDL_Renderer** renderer, SDL_Texture** texture, const BoardSnapshot* snapshot, Viewport* viewport) {
+	viewport->render(snapshot->words.data(), snapshot->width, snapshot->height, snapshot->wordsPerRow);
+	SDL_UpdateTexture(*texture, NULL, viewport->getPixels(), viewport->getPitch());
+	SDL_RenderClear(*renderer);
+	SDL_RenderCopy(*renderer, *texture, NULL, NULL);
+	SDL_RenderPresent(*renderer);
 }
 
 /** \brief Creates graphical grid on window.
 
-The purpose of this function is to draw vertical and horizontal lines based on window width, window height and scale(based on Cell size).
+The purpose of this function is to draw vertical and horizontal lines based on window width, window height and scale(based on Cell size). Cells smaller than FrameBuffer::GRID_MIN_SCALE get no grid, the window is only filled.
 \param SDL_Window - window object from SDL library
 \param SDL_Renderer - 2D rendering context for a window from SDL library
 \param windowWidth - window width based on current screen resolution
@@ -65,6 +139,10 @@ void createGrid(SDL_Window** window, SDL_Renderer** renderer, int windowWidth, i
 	SDL_SetRenderDrawColor(*renderer, 0x55, 0x55, 0x55, 0xFF);
 	SDL_RenderFillRect(*renderer, &fillRect);
 
+	if (scale < FrameBuffer::GRID_MIN_SCALE) {
+		SDL_RenderPresent(*renderer);
+		return;
+	}
 	//Draw horizontal lines
 	SDL_SetRenderDrawColor(*renderer, 0x44, 0x44, 0x44, 0xFF);
 	for (int i = 0; i < windowHeight; i += scale) {
@@ -100,163 +178,167 @@ void getScreenResolution(int* windowWidth, int* windowHeight) {
 The purpose of this function is to create a loading screen which displays 'CONWAY' sign from alive cells. It's showed during the intial creation of objects in the main cell matrix.
 \param SDL_Window - window object from SDL library
 \param SDL_Renderer - 2D rendering context for a window from SDL library
-\param cellMatrixPointer - pointer to cellMatrix(matrix that stores all Cells)
-\param aliveCellArrayPointer - pointer to aliveCellArray(array that stores only alive Cells and their neighbors)
+\param engine - simulation engine
 \param windowWidth - window width based on current screen resolution
 \param windowHeight - window height based on current screen resolution
 \param scale - size of Cell side
 */
-void createLoadingScreen(SDL_Window** window, SDL_Renderer** renderer, vector< vector<Cell> >* cellMatrixPointer, vector<Cell>* aliveCellArrayPointer, int windowWidth, int windowHeight, int scale) {
+void createLoadingScreen(SDL_Window** window, SDL_Renderer** renderer, LifeEngine* engine, int windowWidth, int windowHeight, int scale) {
 	int beginingX = windowWidth / scale / 2 - 15;
 	int beginingY = windowHeight / scale / 2 - 3;
 
 	//C
-	(*cellMatrixPointer)[beginingY][beginingX].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY][beginingX + 1].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY][beginingX + 2].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY][beginingX + 3].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 1][beginingX].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 2][beginingX].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 3][beginingX].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 4][beginingX].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 4][beginingX + 1].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 4][beginingX + 2].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 4][beginingX + 3].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
+	createAliveCell(renderer, engine, beginingX, beginingY, scale);
+	createAliveCell(renderer, engine, beginingX + 1, beginingY, scale);
+	createAliveCell(renderer, engine, beginingX + 2, beginingY, scale);
+	createAliveCell(renderer, engine, beginingX + 3, beginingY, scale);
+	createAliveCell(renderer, engine, beginingX, beginingY + 1, scale);
+	createAliveCell(renderer, engine, beginingX, beginingY + 2, scale);
+	createAliveCell(renderer, engine, beginingX, beginingY + 3, scale);
+	createAliveCell(renderer, engine, beginingX, beginingY + 4, scale);
+	createAliveCell(renderer, engine, beginingX + 1, beginingY + 4, scale);
+	createAliveCell(renderer, engine, beginingX + 2, beginingY + 4, scale);
+	createAliveCell(renderer, engine, beginingX + 3, beginingY + 4, scale);
 
 	//O
-	(*cellMatrixPointer)[beginingY][beginingX + 5].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY][beginingX + 6].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY][beginingX + 7].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY][beginingX + 8].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 1][beginingX + 5].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 2][beginingX + 5].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 3][beginingX + 5].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 4][beginingX + 5].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 1][beginingX + 8].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 2][beginingX + 8].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 3][beginingX + 8].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 4][beginingX + 8].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 4][beginingX + 6].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 4][beginingX + 7].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
+	createAliveCell(renderer, engine, beginingX + 5, beginingY, scale);
+	createAliveCell(renderer, engine, beginingX + 6, beginingY, scale);
+	createAliveCell(renderer, engine, beginingX + 7, beginingY, scale);
+	createAliveCell(renderer, engine, beginingX + 8, beginingY, scale);
+	createAliveCell(renderer, engine, beginingX + 5, beginingY + 1, scale);
+	createAliveCell(renderer, engine, beginingX + 5, beginingY + 2, scale);
+	createAliveCell(renderer, engine, beginingX + 5, beginingY + 3, scale);
+	createAliveCell(renderer, engine, beginingX + 5, beginingY + 4, scale);
+	createAliveCell(renderer, engine, beginingX + 8, beginingY + 1, scale);
+	createAliveCell(renderer, engine, beginingX + 8, beginingY + 2, scale);
+	createAliveCell(renderer, engine, beginingX + 8, beginingY + 3, scale);
+	createAliveCell(renderer, engine, beginingX + 8, beginingY + 4, scale);
+	createAliveCell(renderer, engine, beginingX + 6, beginingY + 4, scale);
+	createAliveCell(renderer, engine, beginingX + 7, beginingY + 4, scale);
 
 	//N
-	(*cellMatrixPointer)[beginingY][beginingX + 10].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 1][beginingX + 10].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 2][beginingX + 10].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 3][beginingX + 10].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 4][beginingX + 10].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY][beginingX + 13].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 1][beginingX + 13].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 2][beginingX + 13].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 3][beginingX + 13].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 4][beginingX + 13].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 2][beginingX + 11].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 3][beginingX + 12].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
+	createAliveCell(renderer, engine, beginingX + 10, beginingY, scale);
+	createAliveCell(renderer, engine, beginingX + 10, beginingY + 1, scale);
+	createAliveCell(renderer, engine, beginingX + 10, beginingY + 2, scale);
+	createAliveCell(renderer, engine, beginingX + 10, beginingY + 3, scale);
+	createAliveCell(renderer, engine, beginingX + 10, beginingY + 4, scale);
+	createAliveCell(renderer, engine, beginingX + 13, beginingY, scale);
+	createAliveCell(renderer, engine, beginingX + 13, beginingY + 1, scale);
+	createAliveCell(renderer, engine, beginingX + 13, beginingY + 2, scale);
+	createAliveCell(renderer, engine, beginingX + 13, beginingY + 3, scale);
+	createAliveCell(renderer, engine, beginingX + 13, beginingY + 4, scale);
+	createAliveCell(renderer, engine, beginingX + 11, beginingY + 2, scale);
+	createAliveCell(renderer, engine, beginingX + 12, beginingY + 3, scale);
 
 	//W
-	(*cellMatrixPointer)[beginingY][beginingX + 15].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 1][beginingX + 15].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 2][beginingX + 15].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 3][beginingX + 15].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 4][beginingX + 15].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY][beginingX + 19].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 1][beginingX + 19].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 2][beginingX + 19].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 3][beginingX + 19].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 4][beginingX + 19].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 3][beginingX + 18].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 2][beginingX + 17].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 3][beginingX + 16].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
+	createAliveCell(renderer, engine, beginingX + 15, beginingY, scale);
+	createAliveCell(renderer, engine, beginingX + 15, beginingY + 1, scale);
+	createAliveCell(renderer, engine, beginingX + 15, beginingY + 2, scale);
+	createAliveCell(renderer, engine, beginingX + 15, beginingY + 3, scale);
+	createAliveCell(renderer, engine, beginingX + 15, beginingY + 4, scale);
+	createAliveCell(renderer, engine, beginingX + 19, beginingY, scale);
+	createAliveCell(renderer, engine, beginingX + 19, beginingY + 1, scale);
+	createAliveCell(renderer, engine, beginingX + 19, beginingY + 2, scale);
+	createAliveCell(renderer, engine, beginingX + 19, beginingY + 3, scale);
+	createAliveCell(renderer, engine, beginingX + 19, beginingY + 4, scale);
+	createAliveCell(renderer, engine, beginingX + 18, beginingY + 3, scale);
+	createAliveCell(renderer, engine, beginingX + 17, beginingY + 2, scale);
+	createAliveCell(renderer, engine, beginingX + 16, beginingY + 3, scale);
 
 	//A
-	(*cellMatrixPointer)[beginingY][beginingX + 21].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 1][beginingX + 21].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 2][beginingX + 21].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 3][beginingX + 21].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 4][beginingX + 21].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY][beginingX + 24].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 1][beginingX + 24].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 2][beginingX + 24].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 3][beginingX + 24].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 4][beginingX + 24].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY][beginingX + 22].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY][beginingX + 23].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 3][beginingX + 22].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 3][beginingX + 23].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
+	createAliveCell(renderer, engine, beginingX + 21, beginingY, scale);
+	createAliveCell(renderer, engine, beginingX + 21, beginingY + 1, scale);
+	createAliveCell(renderer, engine, beginingX + 21, beginingY + 2, scale);
+	createAliveCell(renderer, engine, beginingX + 21, beginingY + 3, scale);
+	createAliveCell(renderer, engine, beginingX + 21, beginingY + 4, scale);
+	createAliveCell(renderer, engine, beginingX + 24, beginingY, scale);
+	createAliveCell(renderer, engine, beginingX + 24, beginingY + 1, scale);
+	createAliveCell(renderer, engine, beginingX + 24, beginingY + 2, scale);
+	createAliveCell(renderer, engine, beginingX + 24, beginingY + 3, scale);
+	createAliveCell(renderer, engine, beginingX + 24, beginingY + 4, scale);
+	createAliveCell(renderer, engine, beginingX + 22, beginingY, scale);
+	createAliveCell(renderer, engine, beginingX + 23, beginingY, scale);
+	createAliveCell(renderer, engine, beginingX + 22, beginingY + 3, scale);
+	createAliveCell(renderer, engine, beginingX + 23, beginingY + 3, scale);
 
 	//Y
-	(*cellMatrixPointer)[beginingY][beginingX + 30].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 1][beginingX + 29].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY][beginingX + 26].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 1][beginingX + 27].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 2][beginingX + 28].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 3][beginingX + 28].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-	(*cellMatrixPointer)[beginingY + 4][beginingX + 28].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
+	createAliveCell(renderer, engine, beginingX + 30, beginingY, scale);
+	createAliveCell(renderer, engine, beginingX + 29, beginingY + 1, scale);
+	createAliveCell(renderer, engine, beginingX + 26, beginingY, scale);
+	createAliveCell(renderer, engine, beginingX + 27, beginingY + 1, scale);
+	createAliveCell(renderer, engine, beginingX + 28, beginingY + 2, scale);
+	createAliveCell(renderer, engine, beginingX + 28, beginingY + 3, scale);
+	createAliveCell(renderer, engine, beginingX + 28, beginingY + 4, scale);
 
 	//Update screen
 	SDL_RenderPresent(*renderer);
-	for (unsigned int i = beginingY; i < (*cellMatrixPointer).size() - 1; i++) {
-		for (unsigned int j = beginingX; j < (*cellMatrixPointer)[0].size() - 1; j++) {
-			if ((*cellMatrixPointer)[i][j].getIsAlive()) (*cellMatrixPointer)[i][j].killCell(window, renderer, scale);
-		}
-	}
-	vector<Cell>().swap(*aliveCellArrayPointer);
+	engine->forEachAlive([&](int x, int y) {
+		drawCell(renderer, x * scale, y * scale, scale, false);
+	});
+	engine->clear();
 }
 
 /** \brief Creates random seed generator.
 
-The purpose of this function is to create random alive cells based on set seed.
+The purpose of this function is to create random alive cells based on set seed. Cells are drawn by SoupGenerator a word at a time on all threads of the engine and shown with the first frame, soup seed is printed to the console so the soup can be repeated.
 \param SDL_Window - window object from SDL library
 \param SDL_Renderer - 2D rendering context for a window from SDL library
-\param cellMatrixPointer - pointer to cellMatrix(matrix that stores all Cells)
-\param aliveCellArrayPointer - pointer to aliveCellArray(array that stores only alive Cells and their neighbors)
-\param windowWidth - window width based on current screen resolution
-\param windowHeight - window height based on current screen resolution
+\param engine - simulation engine
 \param scale - size of Cell side
 \param seed - seed variable determines how many alive Cells are going to be created
+\param soupSeed - seed of SoupGenerator, the same seed and seed variable always give the same soup
 */
-void createRandomGenerator(SDL_Window** window, SDL_Renderer** renderer, vector< vector<Cell> >* cellMatrixPointer, vector<Cell>* aliveCellArrayPointer, int windowWidth, int windowHeight, int scale, int seed) {
-	int random;
-	vector<int> iContainer;
-	vector<int> jContainer;
-
-	for (int i = 200 / scale; (unsigned)i < (*cellMatrixPointer).size() - 200 / scale; i++) {
-		for (int j = 200 / scale; (unsigned)j < (*cellMatrixPointer)[0].size() - 200 / scale; j++) {
-			random = rand() % 100 + 1;
-			if (random <= seed) {
-				(*cellMatrixPointer)[i][j].createAliveCell(window, renderer, cellMatrixPointer, aliveCellArrayPointer, scale);
-				iContainer.push_back(i);
-				jContainer.push_back(j);
-			}
-		}
-	}
-	for (int i = 0; (unsigned)i < iContainer.size(); i++) {
-		(*cellMatrixPointer)[iContainer[i]][jContainer[i]].addNeighborsToArray(cellMatrixPointer, aliveCellArrayPointer, scale);
+void createRandomGenerator(SDL_Window** window, SDL_Renderer** renderer, LifeEngine* engine, int scale, int seed, uint64_t soupSeed) {
+	cout << "Soup seed " << soupSeed << endl;
+	fillSoup(engine, SoupGenerator(soupSeed, seed), 200 / scale, 200 / scale, engine->getWidth() - 200 / scale, engine->getHeight() - 200 / scale);
+}
+
+/** \brief Seeds the board with a pattern file.
+
+Pattern is read twice, first to get its bounding box and then into the engine centered on the board, so the file is never held in memory. Number of cells and read speed are printed to the console.
+\param SDL_Window - window object from SDL library
+\param SDL_Renderer - 2D rendering context for a window from SDL library
+\param engine - simulation engine
+\param path - path to a RLE, Life 1.06 or .cells file
+\param scale - size of Cell side
+\return true if the pattern was loaded
+*/
+bool createPatternSeed(SDL_Window** window, SDL_Renderer** renderer, LifeEngine* engine, const string& path, int scale) {
+	PatternStats stats;
+	if (!readPattern(path, NULL, 0, 0, &stats)) {
+		cout << "Pattern " << path << " could not be read." << endl;
+		return false;
 	}
+	long long offsetX = engine->getWidth() / 2 - (stats.minX + stats.maxX) / 2;
+	long long offsetY = engine->getHeight() / 2 - (stats.minY + stats.maxY) / 2;
+	readPattern(path, engine, offsetX, offsetY, &stats);
+	cout << "Pattern " << path << ": " << stats.cells << " cells, " << stats.bytes / 1e6 / (stats.seconds > 0 ? stats.seconds : 1e-9) << " MB/s" << endl;
+	engine->forEachAlive([&](int x, int y) {
+		drawCell(renderer, x * scale, y * scale, scale, true);
+	});
+	return true;
 }
 
-/** \brief Creates Cell matrix.
+/** \brief Resumes a game from a checkpoint file.
 
-The purpose of this function is to create Cell matrix from vectors. Each vector 'row' is a vector containing Cell objects.
-\param windowWidth - window width based on current screen resolution
-\param windowHeight - window height based on current screen resolution
+Board, rule, topology and generation are taken from the checkpoint, so the board may be bigger or smaller than the window.
+\param SDL_Window - window object from SDL library
+\param SDL_Renderer - 2D rendering context for a window from SDL library
+\param engine - simulation engine
+\param path - path to a checkpoint written by the game
 \param scale - size of Cell side
+\return true if the checkpoint was loaded
 */
-vector< vector<Cell> > createCellMatrix(int windowWidth, int windowHeight, int scale) {
-	const int NumOfColumns = windowWidth / scale;
-	const int NumOfRows = windowHeight / scale;
-	vector<Cell> row;
-	vector< vector<Cell> > cellMatrix;
-	for (int i = 0; i < NumOfRows; i++) {
-		for (int j = 0; j < NumOfColumns; j++) {
-			//insert cells in row
-			row.push_back(Cell(j * scale, i * scale));
-		}
-		//insert row into matrix
-		cellMatrix.push_back(row);
-		vector<Cell>().swap(row);
+bool createCheckpointSeed(SDL_Window** window, SDL_Renderer** renderer, LifeEngine* engine, const string& path, int scale) {
+	if (!loadCheckpoint(path, engine)) {
+		cout << "Checkpoint " << path << " could not be loaded." << endl;
+		return false;
 	}
-	return cellMatrix;
+	cout << "Checkpoint " << path << ": generation " << engine->getGeneration() << ", " << engine->population() << " cells" << endl;
+	engine->forEachAlive([&](int x, int y) {
+		drawCell(renderer, x * scale, y * scale, scale, true);
+	});
+	return true;
 }
 
 /** \brief Cleanup function.
@@ -277,54 +359,251 @@ void quit(SDL_Window* window, SDL_Renderer* renderer) {
 	exit(0);
 }
 
+/** \brief Sends cells on a line between two cells to the simulation, e.g. cells the mouse moved over between two events.
+
+\param simulation - running simulation that applies the edits between generations
+\param fromX - column of the first cell
+\param fromY - row of the first cell
+\param toX - column of the last cell
+\param toY - row of the last cell
+\param isAlive - true to draw cells, false to erase them
+*/
+void paintCells(SimulationThread* simulation, int fromX, int fromY, int toX, int toY, bool isAlive) {
+	int dx = abs(toX - fromX), dy = -abs(toY - fromY);
+	int stepX = fromX < toX ? 1 : -1, stepY = fromY < toY ? 1 : -1;
+	int error = dx + dy;
+	while (true) {
+		simulation->editCell(fromX, fromY, isAlive);
+		if (fromX == toX && fromY == toY) break;
+		int doubled = error * 2;
+		if (doubled >= dy) {
+			error += dy;
+			fromX += stepX;
+		}
+		if (doubled <= dx) {
+			error += dx;
+			fromY += stepY;
+		}
+	}
+}
+
+/** \brief Doubles or halves the target rate of generations.
+
+Paced rates go from MIN_RATE to MAX_RATE generations per second, faster than MAX_RATE is as fast as possible. Slowing down from as fast as possible starts from the measured rate.
+\param targetRate - current target rate, 0 for as fast as possible
+\param rate - measured generations per second
+\param isFaster - true to double the rate, false to halve it
+\return new target rate, 0 for as fast as possible
+*/
+double changeSpeed(double targetRate, double rate, bool isFaster) {
+	if (isFaster) {
+		return targetRate <= 0 || targetRate * 2 > MAX_RATE ? 0 : targetRate * 2;
+	}
+	if (targetRate <= 0) {
+		targetRate = MAX_RATE;
+		while (targetRate > MIN_RATE && targetRate >= rate) targetRate /= 2;
+		return targetRate;
+	}
+	return max(MIN_RATE, targetRate / 2);
+}
+
 /** \brief Starts the game.
 
-The purpose of this function is to start the game, that means set Cell matrix, run loading screen function, run random generator and call in a loop functions like countAliveNeighbors and update the screen.
+The purpose of this function is to start the game, that means create the simulation engine, run loading screen function, run random generator, start the simulation thread and show the latest generation in a loop.
+Generations are computed by a SimulationThread, so the speed of the game doesn't depend on the frame rate. Delay sets the target number of generations per second, in turbo mode the game runs as fast as possible and shows every Nth generation. Key T turns turbo mode on and off.
+Board hash is kept up to date by the engine, when the board becomes dead, a still life or an oscillator the period and the first generation of the cycle are printed and shown in the window title.
+Board is saved to a checkpoint every minute and when the game ends, checkpoints are written on a background thread so the game doesn't wait for the disk.
+All waiting events are handled every frame and a frame that doesn't wait for vertical sync ends early when an event arrives, so input isn't delayed by the speed of the game. Space pauses and resumes the game, N pauses it and computes one generation, [ and ] halve and double the speed. The left mouse button draws cells starting on a dead cell and erases them starting on an alive one, edits are sent to the simulation thread through a lock-free queue and applied between generations, also while the game is paused.
+Mouse wheel zooms at the mouse pointer, + and - zoom at the center of the window, arrow keys and dragging with the right or middle button move the board and Home shows the whole board again. The whole board at the starting scale is drawn by FrameBuffer, any other view by Viewport, below 1 pixel per cell from the density of blocks of cells.
 \param SDL_Window - window object from SDL library
 \param SDL_Renderer - 2D rendering context for a window from SDL library
 \param windowWidth - window width based on current screen resolution
 \param windowHeight - window height based on current screen resolution
 \param scale - size of Cell side
+\param speed - 2000 minus delay between game states in miliseconds
+\param turbo - generations between shown boards in turbo mode, 1 starts the game in normal mode
 \param seed - seed variable determines how many alive Cells are going to be created
-\param variant - determines which game variant is set
+\param soupSeed - seed of the random soup, 0 for a new soup
+\param patternPath - pattern or checkpoint file used instead of random cells, empty for random cells
+\param rule - rule of the game, one of the variants or any B/S rule
+\param topology - what cells on the edge of the board see outside of it
 */
-void playGame(SDL_Window** window, SDL_Renderer** renderer, int windowWidth, int windowHeight, int scale, int speed, int seed, int variant) {
-	srand((unsigned int)time(NULL));
-	vector< vector<Cell> > cellMatrix = createCellMatrix(windowWidth, windowHeight, scale);
-	vector<Cell> aliveCellArray;
-	vector<Cell> aliveCellArrayBuffer;
+void playGame(SDL_Window** window, SDL_Renderer** renderer, int windowWidth, int windowHeight, int scale, int speed, int turbo, int seed, uint64_t soupSeed, const string& patternPath, const LifeRule& rule, Topology topology) {
+	DenseEngine engine(windowWidth / scale, windowHeight / scale, rule);
+	engine.setTopology(topology);
+	engine.setThreadCount(ThreadPool::defaultThreadCount());
 
-	createLoadingScreen(window, renderer, &cellMatrix, &aliveCellArray, windowWidth, windowHeight, scale);
+	createLoadingScreen(window, renderer, &engine, windowWidth, windowHeight, scale);
 
-	createRandomGenerator(window, renderer, &cellMatrix, &aliveCellArray, windowWidth, windowHeight, scale, seed);
+	bool isSeeded = false;
+	if (!patternPath.empty()) {
+		isSeeded = isCheckpoint(patternPath) ? createCheckpointSeed(window, renderer, &engine, patternPath, scale) : createPatternSeed(window, renderer, &engine, patternPath, scale);
+	}
+	if (!isSeeded) {
+		createRandomGenerator(window, renderer, &engine, scale, seed > 0 ? seed : 7, soupSeed != 0 ? soupSeed : newSoupSeed());
+	}
 	//Update screen
 	SDL_RenderPresent(*renderer);
 
+	//board may have another size than the window if it was loaded from a checkpoint
+	FrameBuffer frame(engine.getWidth(), engine.getHeight(), scale);
+	SDL_Texture* texture = SDL_CreateTexture(*renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, frame.getPixelWidth(), frame.getPixelHeight());
+	Viewport viewport(windowWidth, windowHeight, engine.getWidth(), engine.getHeight(), scale);
+	SDL_Texture* viewTexture = SDL_CreateTexture(*renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, windowWidth, windowHeight);
+	if (!texture || !viewTexture) {
+		cout << "Texture could not be created! SDL_Error: " << SDL_GetError() << endl;
+		return;
+	}
+
+	CheckpointWriter checkpoint(CHECKPOINT_PATH);
+	Uint32 lastCheckpoint = SDL_GetTicks();
+	CycleDetector cycles(CYCLE_MAX_PERIOD);
+	engine.setCycleDetector(&cycles);
+	cycles.observe(engine.getHash(), engine.getCheckHash(), engine.getGeneration());
+	atomic<long long> cyclePeriod(0);
+	atomic<long long> cycleStart(0);
+	StatsWriter stats;
+#ifdef CONWAY_STATS
+	if (stats.open(STATS_PATH)) engine.setStatsWriter(&stats);
+	else cout << "Statistics file " << STATS_PATH << " could not be created." << endl;
+#endif
+	//called on the simulation thread, the only thread that may read the engine while the game runs
+	SimulationThread simulation(&engine, [&](LifeEngine* steppedEngine) {
+		if (SDL_GetTicks() - lastCheckpoint >= CHECKPOINT_INTERVAL) {
+			checkpoint.request(steppedEngine);
+			lastCheckpoint = SDL_GetTicks();
+		}
+		//edits start the detector again
+		if (!cycles.hasCycle()) cyclePeriod = 0;
+		else if (cyclePeriod == 0) {
+			cycleStart = cycles.getCycleStart();
+			cyclePeriod = cycles.getPeriod();
+			if (cycles.isDead()) cout << "All cells are dead from generation " << cycleStart << "." << endl;
+			else if (cyclePeriod == 1) cout << "Board is a still life from generation " << cycleStart << "." << endl;
+			else cout << "Board repeats with period " << cyclePeriod << " from generation " << cycleStart << "." << endl;
+		}
+	});
+	int turboGenerations = turbo > 1 ? turbo : 100;
+	simulation.setTurbo(turbo > 1, turboGenerations);
+	simulation.setTargetRate(speed < 2000 ? 1000.0 / (2000 - speed) : 0);
+	simulation.start();
+	Uint32 lastTitle = 0;
+	cout << "Space pauses, N computes one generation, [ and ] change the speed, T turns turbo mode on and off, the left mouse button draws and erases cells, Escape ends the game." << endl;
+
+	bool isPainting = false;
+	bool isPaintingAlive = true;
+	int paintX = 0, paintY = 0;
 	//start game
 	while (true) {
-		//if Escape key pressed quit
-		if (GetAsyncKeyState(VK_ESCAPE)) break;
-
-		//if 'X' pressed quit
+		Uint32 frameStart = SDL_GetTicks();
 		SDL_Event event;
-		SDL_PollEvent(&event);
-		if (event.type == SDL_QUIT)	quit(*window, *renderer);
-
-		for (unsigned int i = 0; i < aliveCellArray.size(); i++) {
-			aliveCellArray[i].countAliveNeighbors(&cellMatrix, &aliveCellArray, &aliveCellArrayBuffer, scale, variant);
+		bool isQuitting = false;
+		bool isEscaping = false;
+		bool isViewChanged = false;
+		//all waiting events are handled every frame
+		while (SDL_PollEvent(&event)) {
+			switch (event.type) {
+			//if 'X' pressed save and quit
+			case SDL_QUIT:
+				isQuitting = true;
+				break;
+			//zoom and pan
+			case SDL_MOUSEWHEEL:
+				if (event.wheel.y != 0) {
+					int mouseX, mouseY;
+					SDL_GetMouseState(&mouseX, &mouseY);
+					viewport.zoomAt(mouseX, mouseY, event.wheel.y);
+					isViewChanged = true;
+				}
+				break;
+			//left button draws on a dead cell and erases from an alive cell until it is released
+			case SDL_MOUSEBUTTONDOWN:
+				if (event.button.button == SDL_BUTTON_LEFT && viewport.cellAt(event.button.x, event.button.y, &paintX, &paintY)) {
+					const BoardSnapshot& snapshot = simulation.getSnapshot();
+					bool isAlive = paintX < snapshot.width && paintY < snapshot.height && ((snapshot.words[(size_t)paintY * snapshot.wordsPerRow + paintX / 64] >> (paintX % 64)) & 1);
+					isPaintingAlive = !isAlive;
+					isPainting = true;
+					paintCells(&simulation, paintX, paintY, paintX, paintY, isPaintingAlive);
+				}
+				break;
+			case SDL_MOUSEBUTTONUP:
+				if (event.button.button == SDL_BUTTON_LEFT) isPainting = false;
+				break;
+			case SDL_MOUSEMOTION:
+				if (isPainting && (event.motion.state & SDL_BUTTON_LMASK)) {
+					int cellX, cellY;
+					if (viewport.cellAt(event.motion.x, event.motion.y, &cellX, &cellY)) {
+						paintCells(&simulation, paintX, paintY, cellX, cellY, isPaintingAlive);
+						paintX = cellX;
+						paintY = cellY;
+					}
+				}
+				if (event.motion.state & (SDL_BUTTON_RMASK | SDL_BUTTON_MMASK)) {
+					viewport.pan(event.motion.xrel, event.motion.yrel);
+					isViewChanged = true;
+				}
+				break;
+			case SDL_KEYDOWN:
+				switch (event.key.keysym.sym) {
+				case SDLK_ESCAPE: isEscaping = true; break;
+				//T turns turbo mode on and off
+				case SDLK_t: simulation.setTurbo(!simulation.getTurbo(), turboGenerations); break;
+				case SDLK_SPACE: simulation.setPaused(!simulation.getPaused()); break;
+				case SDLK_n: simulation.step(); break;
+				case SDLK_LEFTBRACKET: simulation.setTargetRate(changeSpeed(simulation.getTargetRate(), simulation.getRate(), false)); break;
+				case SDLK_RIGHTBRACKET: simulation.setTargetRate(changeSpeed(simulation.getTargetRate(), simulation.getRate(), true)); break;
+				case SDLK_PLUS: case SDLK_EQUALS: case SDLK_KP_PLUS: viewport.zoomAt(windowWidth / 2, windowHeight / 2, 1); isViewChanged = true; break;
+				case SDLK_MINUS: case SDLK_KP_MINUS: viewport.zoomAt(windowWidth / 2, windowHeight / 2, -1); isViewChanged = true; break;
+				case SDLK_LEFT: viewport.pan(windowWidth / 8, 0); isViewChanged = true; break;
+				case SDLK_RIGHT: viewport.pan(-windowWidth / 8, 0); isViewChanged = true; break;
+				case SDLK_UP: viewport.pan(0, windowHeight / 8); isViewChanged = true; break;
+				case SDLK_DOWN: viewport.pan(0, -windowHeight / 8); isViewChanged = true; break;
+				case SDLK_HOME: viewport.reset(); isViewChanged = true; break;
+				}
+				break;
+			}
+		}
+		if (isQuitting) {
+			//quit doesn't return, so the simulation is stopped and the checkpoint is written first
+			simulation.stop();
+			checkpoint.request(&engine);
+			checkpoint.flush();
+			stats.close();
+			SDL_DestroyTexture(texture);
+			SDL_DestroyTexture(viewTexture);
+			quit(*window, *renderer);
 		}
 
-		updateMainMatrix(&cellMatrix, &aliveCellArray, scale);
-		int size = aliveCellArrayBuffer.size();
-		for (int i = 0; i < size; i++) {
-			aliveCellArrayBuffer[i].addNeighborsToArray(&cellMatrix, &aliveCellArrayBuffer, scale);
+		//if Escape key pressed save and quit
+		if (isEscaping) {
+			simulation.stop();
+			checkpoint.request(&engine);
+			break;
 		}
 
-		updateScreen(window, renderer, &aliveCellArray, scale, speed);
-		vector<Cell>().swap(aliveCellArray);
-		aliveCellArray = move(aliveCellArrayBuffer);
-		vector<Cell>().swap(aliveCellArrayBuffer);
+		//show the latest generation or edit, generations computed since the last frame are skipped
+		if (simulation.update() || isViewChanged) {
+			STATS(chrono::steady_clock::time_point renderStart = chrono::steady_clock::now();)
+			if (viewport.isHome()) updateScreen(window, renderer, &texture, &simulation.getSnapshot(), &frame);
+			else updateViewport(window, renderer, &viewTexture, &simulation.getSnapshot(), &viewport);
+			STATS(stats.setRenderSeconds(chrono::duration<double>(chrono::steady_clock::now() - renderStart).count());)
+		}
+		if (frameStart - lastTitle >= 1000) {
+			string title = "Conway's Game of Life - generation " + to_string(simulation.getSnapshot().generation) + ", " + to_string((long long)simulation.getRate()) + " generations/s" + (simulation.getTurbo() ? ", turbo" : "") + (simulation.getPaused() ? ", paused" : "");
+			if (cyclePeriod > 0) title += ", period " + to_string(cyclePeriod) + " from generation " + to_string(cycleStart);
+			if (!viewport.isHome()) {
+				double pixelsPerCell = viewport.getPixelsPerCell();
+				title += ", zoom " + (pixelsPerCell >= 1 ? to_string((int)pixelsPerCell) : "1/" + to_string((long long)(1 / pixelsPerCell)));
+			}
+			SDL_SetWindowTitle(*window, title.c_str());
+			lastTitle = frameStart;
+		}
+		//frame pacing when presenting doesn't wait for vertical sync or nothing was presented, an event ends the wait at once
+		Uint32 frameTime = SDL_GetTicks() - frameStart;
+		if (frameTime < FRAME_INTERVAL) SDL_WaitEventTimeout(NULL, FRAME_INTERVAL - frameTime);
 	}
+	SDL_DestroyTexture(texture);
+	SDL_DestroyTexture(viewTexture);
 }
 
 /** \brief Sets program window.
@@ -332,10 +611,13 @@ void playGame(SDL_Window** window, SDL_Renderer** renderer, int windowWidth, int
 The purpose of this function is to create program window on which all graphics will be shown.
 \param scale - size of Cell side
 \param seed - seed variable determines how many alive Cells are going to be created
-\param seed - seed variable determines how many alive Cells are going to be created
-\param variant - determines which game variant is set
+\param soupSeed - seed of the random soup, 0 for a new soup
+\param turbo - generations between shown boards in turbo mode, 1 starts the game in normal mode
+\param patternPath - pattern or checkpoint file used instead of random cells, empty for random cells
+\param rule - rule of the game, one of the variants or any B/S rule
+\param topology - what cells on the edge of the board see outside of it
 */
-void setWindow(int scale, int speed, int seed, int variant) {
+void setWindow(int scale, int speed, int turbo, int seed, uint64_t soupSeed, const string& patternPath, const LifeRule& rule, Topology topology) {
 	SDL_Window* window = NULL;
 	SDL_Renderer* renderer = NULL;
 	int windowWidth = 0;
@@ -355,11 +637,11 @@ void setWindow(int scale, int speed, int seed, int variant) {
 	}
 	else {
 		//Create renderer
-		renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+		renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
 		//Fill the surface white
 		createGrid(&window, &renderer, windowWidth, windowHeight, scale);
 		//Start the game
-		playGame(&window, &renderer, windowWidth, windowHeight, scale, speed, seed, variant);
+		playGame(&window, &renderer, windowWidth, windowHeight, scale, speed, turbo, seed, soupSeed, patternPath, rule, topology);
 	}
 	quit(window, renderer);
 }
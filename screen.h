@@ -1,20 +1,31 @@
 #pragma once
 #include "Cell.h"
+#include "LifeEngine.h"
+#include "FrameBuffer.h"
+#include "Viewport.h"
+#include "SimulationThread.h"
+#include "LifeRule.h"
 #include <iostream>
+#include <string>
 #include <vector>
-#include <time.h> //for random seed
-#include <Windows.h> //GetAsyncKeyState
+#include <stdint.h>
+#include <SDL.h> //graphics library
 
 using namespace std;
 
 void printArray(vector<Cell> vector);
-void updateScreen(SDL_Window** window, SDL_Renderer** renderer, vector< vector<Cell> >* cellMatrixPointer, vector<Cell>* aliveCellArrayPointer, int scale, int speed);
-void updateMainMatrix(vector< vector<Cell> >* cellMatrixPointer, vector<Cell>* fromArray, int scale);
+void drawCell(SDL_Renderer** renderer, int posX, int posY, int scale, bool isAlive);
+void createAliveCell(SDL_Renderer** renderer, LifeEngine* engine, int x, int y, int scale);
+void updateScreen(SDL_Window** window, SDL_Renderer** renderer, SDL_Texture** texture, const BoardSnapshot* snapshot, FrameBuffer* frame);
+void updateViewport(SDL_Window** window, SDL_Renderer** renderer, SDL_Texture** texture, const BoardSnapshot* snapshot, Viewport* viewport);
 void createGrid(SDL_Window** window, SDL_Renderer** renderer, int windowWidth, int windowHeight, int scale);
 void getScreenResolution(int* windowWidth, int* windowHeight);
-void createLoadingScreen(SDL_Window** window, SDL_Renderer** renderer, vector< vector<Cell> >* cellMatrixPointer, vector<Cell>* aliveCellArrayPointer, int windowWidth, int windowHeight, int scale);
-void createRandomGenerator(SDL_Window** window, SDL_Renderer** renderer, vector< vector<Cell> >* cellMatrixPointer, vector<Cell>* aliveCellArrayPointer, int windowWidth, int windowHeight, int scale, int seed);
-vector< vector<Cell> > createCellMatrix(int windowWidth, int windowHeight, int scale);
+void createLoadingScreen(SDL_Window** window, SDL_Renderer** renderer, LifeEngine* engine, int windowWidth, int windowHeight, int scale);
+void createRandomGenerator(SDL_Window** window, SDL_Renderer** renderer, LifeEngine* engine, int scale, int seed, uint64_t soupSeed);
+bool createPatternSeed(SDL_Window** window, SDL_Renderer** renderer, LifeEngine* engine, const string& path, int scale);
+bool createCheckpointSeed(SDL_Window** window, SDL_Renderer** renderer, LifeEngine* engine, const string& path, int scale);
 void quit(SDL_Window* window, SDL_Renderer* renderer);
-void playGame(SDL_Window** window, SDL_Renderer** renderer, int windowWidth, int windowHeight, int scale, int speed, int seed, int variant);
-void setWindow(int scale, int speed, int seed, int variant);
\ No newline at end of file
+void paintCells(SimulationThread* simulation, int fromX, int fromY, int toX, int toY, bool isAlive);
+double changeSpeed(double targetRate, double rate, bool isFaster);
+void playGame(SDL_Window** window, SDL_Renderer** renderer, int windowWidth, int windowHeight, int scale, int speed, int turbo, int seed, uint64_t soupSeed, const string& patternPath, const LifeRule& rule, Topology topology);
+void setWindow(int scale, int speed, int turbo, int seed, uint64_t soupSeed, const string& patternPath, const LifeRule& rule, Topology topology);
\ No newline at end of file